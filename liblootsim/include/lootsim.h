@@ -0,0 +1,128 @@
+/*---------------------------------------------------------------
+ *
+ * lootsim.h
+ *
+ * C interface to the loot simulator core. Everything here is safe to call from any
+ * number of threads at once: models are immutable once loaded, and random streams
+ * belong to the caller. Nothing is ever printed.
+ */
+
+#ifndef LOOTSIM_H
+#define LOOTSIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Define LOOTSIM_STATIC when building or linking liblootsim as a static library. */
+#if defined(LOOTSIM_STATIC)
+#define LOOTSIM_API
+#elif defined(_WIN32)
+#ifdef LOOTSIM_BUILDING
+#define LOOTSIM_API __declspec(dllexport)
+#else
+#define LOOTSIM_API __declspec(dllimport)
+#endif
+#else
+#define LOOTSIM_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bumped whenever a function or struct below changes incompatibly. */
+#define LOOTSIM_ABI_VERSION 1
+
+/* Pass as a monster type to pick a random monster for every kill. */
+#define LOOTSIM_RANDOM_MONSTER (-1)
+
+typedef enum lootsim_status
+{
+	LOOTSIM_OK = 0,
+	LOOTSIM_ERROR_INVALID_ARGUMENT = 1,
+	LOOTSIM_ERROR_LOAD_FAILED = 2,
+	LOOTSIM_ERROR_UNKNOWN_MONSTER = 3,
+	LOOTSIM_ERROR_BUFFER_TOO_SMALL = 4,
+	LOOTSIM_ERROR_INTERNAL = 5
+} lootsim_status;
+
+typedef struct lootsim_model lootsim_model;
+
+/* xoshiro256** state. Plain data: copy it, save it, or give each thread its own. */
+typedef struct lootsim_rng
+{
+	uint64_t state[4];
+} lootsim_rng;
+
+LOOTSIM_API uint32_t lootsim_abi_version(void);
+
+/* Message for the last failed call on this thread. Empty if there wasn't one. */
+LOOTSIM_API const char* lootsim_last_error(void);
+
+/* The same seed always gives the same stream. */
+LOOTSIM_API void lootsim_rng_seed(lootsim_rng* rng, uint64_t seed);
+
+/* Jumping a seeded stream i times gives substream i, which never overlaps the others. */
+LOOTSIM_API void lootsim_rng_jump(lootsim_rng* rng);
+
+/*
+ * Loads resources/monsters.json under root_directory and every loot table it names.
+ * Random monsters spawn by the first zone in resources/encounters.json, or all equally
+ * often if there is no such file.
+ */
+LOOTSIM_API lootsim_status lootsim_model_load(const char* root_directory, lootsim_model** out_model);
+
+/* lootsim_model_load with random monsters spawning by the named zone's encounters. */
+LOOTSIM_API lootsim_status lootsim_model_load_zone(const char* root_directory, const char* zone,
+	lootsim_model** out_model);
+
+LOOTSIM_API void lootsim_model_free(lootsim_model* model);
+
+/* Sizes of the count arrays below. Types are indices in [0, count). */
+LOOTSIM_API size_t lootsim_monster_type_count(void);
+LOOTSIM_API size_t lootsim_treasure_type_count(void);
+
+/* Type for an id from the data, e.g. "dragon", or -1 if there is no such type. */
+LOOTSIM_API int32_t lootsim_monster_type_from_id(const char* id);
+
+/* Display names, or null for types the model doesn't have. */
+LOOTSIM_API const char* lootsim_monster_name(const lootsim_model* model, int32_t monster_type);
+LOOTSIM_API const char* lootsim_treasure_name(const lootsim_model* model, int32_t treasure_type);
+
+/* Most drops one kill can produce. A roll buffer this big is always enough. */
+LOOTSIM_API size_t lootsim_max_drops(const lootsim_model* model);
+
+/* Rolls one kill, writing each dropped treasure type to out_treasures. Allocates nothing. */
+LOOTSIM_API lootsim_status lootsim_roll(const lootsim_model* model, int32_t monster_type, lootsim_rng* rng,
+	int32_t* out_treasures, size_t capacity, size_t* out_count);
+
+/*
+ * Slays kill_count monsters and adds to the counts: out_monster_counts has
+ * lootsim_monster_type_count() entries, and out_loot_counts has that many rows of
+ * lootsim_treasure_type_count() entries, one row per monster type.
+ */
+LOOTSIM_API lootsim_status lootsim_simulate(const lootsim_model* model, int32_t monster_type,
+	int64_t kill_count, lootsim_rng* rng, int64_t* out_monster_counts, int64_t* out_loot_counts);
+
+/*
+ * lootsim_simulate for a player with magic find, as a fraction: 0.5 for +50%. Magic find
+ * evens out every table so rare treasures drop more often. It's rounded to steps of 5%,
+ * and each step's tables are compiled once and shared by every caller, so sweeping many
+ * players costs no more per kill than one. 0 matches lootsim_simulate exactly.
+ */
+LOOTSIM_API lootsim_status lootsim_simulate_magic_find(const lootsim_model* model, int32_t monster_type,
+	double magic_find, int64_t kill_count, lootsim_rng* rng, int64_t* out_monster_counts,
+	int64_t* out_loot_counts);
+
+/*
+ * Exact average number of each treasure one kill drops, worked out from the tables.
+ * out_expected has lootsim_treasure_type_count() entries.
+ */
+LOOTSIM_API lootsim_status lootsim_expected_drops(const lootsim_model* model, int32_t monster_type,
+	double* out_expected);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOOTSIM_H */
@@ -0,0 +1,323 @@
+//---------------------------------------------------------------
+//
+// lootsim.cpp
+//
+
+#include "include/lootsim.h"
+
+#include "loot-simulator/ContentLoader.h"
+#include "loot-simulator/LootModel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace LootSimulator;
+
+struct lootsim_model
+{
+	std::set<Monster> monsters;
+	LootModel lootModel;
+
+	// Names by type, pointing into strings. The pool null terminates them, so they can be
+	// handed out as C strings.
+	StringPool strings;
+	std::string_view monsterNames[s_numMonsterTypes];
+	std::string_view treasureNames[s_numTreasureTypes];
+};
+
+namespace {
+
+//===============================================================
+
+thread_local std::string s_lastError;
+
+static_assert(sizeof(lootsim_rng) == sizeof(RngState), "lootsim_rng must match RngState.");
+
+lootsim_status Fail(lootsim_status status, const std::string& message)
+{
+	s_lastError = message;
+	return status;
+}
+
+RngState& GetRngState(lootsim_rng* rng)
+{
+	return *reinterpret_cast<RngState*>(rng->state);
+}
+
+bool IsValidMonsterType(int32_t monsterType)
+{
+	return monsterType >= 0 && static_cast<size_t>(monsterType) < s_numMonsterTypes;
+}
+
+bool IsValidTreasureType(int32_t treasureType)
+{
+	return treasureType >= 0 && static_cast<size_t>(treasureType) < s_numTreasureTypes;
+}
+
+//===============================================================
+
+} // anonymous namespace
+
+uint32_t lootsim_abi_version(void)
+{
+	return LOOTSIM_ABI_VERSION;
+}
+
+const char* lootsim_last_error(void)
+{
+	return s_lastError.c_str();
+}
+
+void lootsim_rng_seed(lootsim_rng* rng, uint64_t seed)
+{
+	if (rng)
+	{
+		GetRngState(rng) = SeedRng(seed);
+	}
+}
+
+void lootsim_rng_jump(lootsim_rng* rng)
+{
+	if (rng)
+	{
+		JumpRng(GetRngState(rng));
+	}
+}
+
+lootsim_status lootsim_model_load(const char* root_directory, lootsim_model** out_model)
+{
+	return lootsim_model_load_zone(root_directory, "", out_model);
+}
+
+lootsim_status lootsim_model_load_zone(const char* root_directory, const char* zone, lootsim_model** out_model)
+{
+	if (!root_directory || !zone || !out_model)
+	{
+		return Fail(LOOTSIM_ERROR_INVALID_ARGUMENT, "root_directory, zone and out_model are required.");
+	}
+	*out_model = nullptr;
+
+	try
+	{
+		auto model = std::make_unique<lootsim_model>();
+		std::string error;
+		if (!LoadContent(root_directory, model->monsters, model->strings, error))
+		{
+			return Fail(LOOTSIM_ERROR_LOAD_FAILED, error);
+		}
+
+		std::vector<EncounterTable> encounterTables;
+		if (!LoadEncounterTables(root_directory, model->monsters, model->strings, encounterTables, error))
+		{
+			return Fail(LOOTSIM_ERROR_LOAD_FAILED, error);
+		}
+
+		// An empty zone means the first one, as it does for the simulator.
+		std::string_view zoneName = zone;
+		auto encounters = std::find_if(std::begin(encounterTables), std::end(encounterTables),
+			[&model, zoneName](const EncounterTable& table)
+		{
+			return zoneName.empty() || model->strings.Get(table.zoneId) == zoneName;
+		});
+		if (encounters == std::end(encounterTables) && !zoneName.empty())
+		{
+			return Fail(LOOTSIM_ERROR_LOAD_FAILED, "Unknown zone. zone=" + std::string(zoneName));
+		}
+
+		model->lootModel = LootModel(model->monsters,
+			encounters != std::end(encounterTables) ? &*encounters : nullptr);
+		if (model->lootModel.GetMaxDropCount() > s_maxDropsPerKill)
+		{
+			return Fail(LOOTSIM_ERROR_LOAD_FAILED, "A monster can drop more items at once than supported.");
+		}
+
+		for (const Monster& monster : model->monsters)
+		{
+			size_t monsterIndex = static_cast<size_t>(monster.type);
+			if (monsterIndex < s_numMonsterTypes)
+			{
+				model->monsterNames[monsterIndex] = model->strings.Get(monster.nameId);
+			}
+
+			for (const LootTable& table : monster.tables)
+			{
+				for (const Treasure& treasure : table.treasures)
+				{
+					size_t treasureIndex = static_cast<size_t>(treasure.type);
+					if (treasureIndex < s_numTreasureTypes && model->treasureNames[treasureIndex].empty())
+					{
+						model->treasureNames[treasureIndex] = model->strings.Get(treasure.nameId);
+					}
+				}
+			}
+		}
+
+		*out_model = model.release();
+	}
+	catch (const std::exception& e)
+	{
+		return Fail(LOOTSIM_ERROR_INTERNAL, e.what());
+	}
+
+	s_lastError.clear();
+	return LOOTSIM_OK;
+}
+
+void lootsim_model_free(lootsim_model* model)
+{
+	delete model;
+}
+
+size_t lootsim_monster_type_count(void)
+{
+	return s_numMonsterTypes;
+}
+
+size_t lootsim_treasure_type_count(void)
+{
+	return s_numTreasureTypes;
+}
+
+int32_t lootsim_monster_type_from_id(const char* id)
+{
+	if (!id)
+	{
+		return -1;
+	}
+
+	// Unknown ids come back as NONE.
+	MonsterType type = GetMonsterTypeFromId(id);
+	return type == MonsterType::NONE ? -1 : static_cast<int32_t>(type);
+}
+
+const char* lootsim_monster_name(const lootsim_model* model, int32_t monster_type)
+{
+	if (!model || !IsValidMonsterType(monster_type) || model->monsterNames[monster_type].empty())
+	{
+		return nullptr;
+	}
+	return model->monsterNames[monster_type].data();
+}
+
+const char* lootsim_treasure_name(const lootsim_model* model, int32_t treasure_type)
+{
+	if (!model || !IsValidTreasureType(treasure_type) || model->treasureNames[treasure_type].empty())
+	{
+		return nullptr;
+	}
+	return model->treasureNames[treasure_type].data();
+}
+
+size_t lootsim_max_drops(const lootsim_model* model)
+{
+	return model ? model->lootModel.GetMaxDropCount() : 0;
+}
+
+lootsim_status lootsim_roll(const lootsim_model* model, int32_t monster_type, lootsim_rng* rng,
+	int32_t* out_treasures, size_t capacity, size_t* out_count)
+{
+	if (!model || !rng || !out_count || (!out_treasures && capacity > 0))
+	{
+		return Fail(LOOTSIM_ERROR_INVALID_ARGUMENT, "model, rng and out_count are required.");
+	}
+
+	const LootModel& lootModel = model->lootModel;
+	MonsterType type = monster_type == LOOTSIM_RANDOM_MONSTER
+		? lootModel.RollMonsterType(GetRngState(rng))
+		: static_cast<MonsterType>(monster_type);
+	if (!lootModel.HasMonster(type))
+	{
+		return Fail(LOOTSIM_ERROR_UNKNOWN_MONSTER, "The model has no such monster type.");
+	}
+
+	TreasureType drops[s_maxDropsPerKill];
+	size_t dropCount = lootModel.RollLoot(type, GetRngState(rng), drops);
+
+	*out_count = dropCount;
+	for (size_t i = 0; i < dropCount && i < capacity; ++i)
+	{
+		out_treasures[i] = static_cast<int32_t>(drops[i]);
+	}
+
+	if (dropCount > capacity)
+	{
+		return Fail(LOOTSIM_ERROR_BUFFER_TOO_SMALL, "More items dropped than out_treasures can hold.");
+	}
+	return LOOTSIM_OK;
+}
+
+lootsim_status lootsim_simulate(const lootsim_model* model, int32_t monster_type,
+	int64_t kill_count, lootsim_rng* rng, int64_t* out_monster_counts, int64_t* out_loot_counts)
+{
+	return lootsim_simulate_magic_find(model, monster_type, 0.0, kill_count, rng, out_monster_counts,
+		out_loot_counts);
+}
+
+lootsim_status lootsim_simulate_magic_find(const lootsim_model* model, int32_t monster_type,
+	double magic_find, int64_t kill_count, lootsim_rng* rng, int64_t* out_monster_counts,
+	int64_t* out_loot_counts)
+{
+	if (!model || !rng || !out_monster_counts || !out_loot_counts || kill_count < 0)
+	{
+		return Fail(LOOTSIM_ERROR_INVALID_ARGUMENT, "model, rng and both count arrays are required.");
+	}
+
+	const LootModel& lootModel = model->lootModel;
+	bool isRandom = monster_type == LOOTSIM_RANDOM_MONSTER;
+	if (!isRandom && !lootModel.HasMonster(static_cast<MonsterType>(monster_type)))
+	{
+		return Fail(LOOTSIM_ERROR_UNKNOWN_MONSTER, "The model has no such monster type.");
+	}
+
+	uint32_t magicFindBucket = GetMagicFindBucket(static_cast<float>(magic_find));
+	RngState& rngState = GetRngState(rng);
+	TreasureType drops[s_maxDropsPerKill];
+	for (int64_t kill = 0; kill < kill_count; ++kill)
+	{
+		MonsterType type = isRandom ? lootModel.RollMonsterType(rngState) : static_cast<MonsterType>(monster_type);
+		size_t monsterIndex = static_cast<size_t>(type);
+		if (monsterIndex >= s_numMonsterTypes)
+		{
+			continue;
+		}
+
+		out_monster_counts[monsterIndex]++;
+		size_t dropCount = lootModel.RollLoot(type, magicFindBucket, rngState, drops);
+		for (size_t i = 0; i < dropCount; ++i)
+		{
+			size_t treasureIndex = static_cast<size_t>(drops[i]);
+			if (treasureIndex < s_numTreasureTypes)
+			{
+				out_loot_counts[monsterIndex * s_numTreasureTypes + treasureIndex]++;
+			}
+		}
+	}
+
+	return LOOTSIM_OK;
+}
+
+lootsim_status lootsim_expected_drops(const lootsim_model* model, int32_t monster_type,
+	double* out_expected)
+{
+	if (!model || !out_expected)
+	{
+		return Fail(LOOTSIM_ERROR_INVALID_ARGUMENT, "model and out_expected are required.");
+	}
+
+	MonsterType type = static_cast<MonsterType>(monster_type);
+	if (!IsValidMonsterType(monster_type) || !model->lootModel.HasMonster(type))
+	{
+		return Fail(LOOTSIM_ERROR_UNKNOWN_MONSTER, "The model has no such monster type.");
+	}
+
+	double expectedCounts[s_numTreasureTypes];
+	model->lootModel.GetExpectedDropCounts(type, expectedCounts);
+	std::memcpy(out_expected, expectedCounts, sizeof(expectedCounts));
+	return LOOTSIM_OK;
+}
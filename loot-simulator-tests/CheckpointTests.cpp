@@ -0,0 +1,140 @@
+//---------------------------------------------------------------
+//
+// CheckpointTests.cpp
+//
+
+#include "TestHarness.h"
+#include "TestUtilities.h"
+
+#include "Checkpoint.h"
+#include "Game.h"
+#include "GameEvents.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace LootSimulator {
+namespace Tests {
+
+//===============================================================
+
+static const uint64_t s_testSeed = 1;
+static const int64_t s_testKills = 100003;
+static const int64_t s_testInterval = 1009;
+
+// Kills already done when the batch was stopped. Not on a chunk boundary.
+static const int64_t s_stoppedAfterKills = 30011;
+
+static std::string GetTestCheckpointPath(const char* name)
+{
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static void CaptureLoot(Game& game, LootSession& lootSession)
+{
+	game.GetGameEvents().GetLootDroppedEvent().subscribe([&lootSession](const LootSession& droppedLoot)
+	{
+		lootSession = droppedLoot;
+	});
+}
+
+// The checkpoint a batch started by a game seeded with s_testSeed leaves once it has done
+// s_stoppedAfterKills kills. Random batches take their kills in type order.
+static BatchCheckpoint MakeStoppedCheckpoint(Game& game, std::optional<MonsterType> type)
+{
+	BatchCheckpoint checkpoint;
+	checkpoint.contentHash = game.GetContentHash();
+	checkpoint.type = type.value_or(MonsterType::NONE);
+	checkpoint.totalCount = s_testKills;
+	checkpoint.remainingCount = s_testKills - s_stoppedAfterKills;
+	checkpoint.rng = SeedRng(s_testSeed);
+	if (type.has_value())
+	{
+		game.SimulateBatch(s_stoppedAfterKills, type, checkpoint.rng, checkpoint.counters);
+		return checkpoint;
+	}
+
+	game.GetLootModel().RollMonsterCounts(s_testKills, checkpoint.rng, checkpoint.typeCounts);
+	int64_t killsLeft = s_stoppedAfterKills;
+	for (size_t i = 0; i < s_numMonsterTypes; ++i)
+	{
+		int64_t kills = std::min(checkpoint.typeCounts[i], killsLeft);
+		game.SimulateBatch(kills, static_cast<MonsterType>(i), checkpoint.rng, checkpoint.counters);
+		killsLeft -= kills;
+	}
+	return checkpoint;
+}
+
+// A batch resumed from a checkpoint, saving more as it goes, has to end up with the same
+// loot and the same final checkpoint as the batch run straight through.
+static void CheckResumeMatchesUninterrupted(std::optional<MonsterType> type)
+{
+	std::string uninterruptedPath = GetTestCheckpointPath("lootsim-test-uninterrupted.checkpoint");
+	std::string resumedPath = GetTestCheckpointPath("lootsim-test-resumed.checkpoint");
+
+	LootSession uninterrupted;
+	{
+		Game game;
+		game.SetSeed(s_testSeed);
+		game.SetCheckpointing(uninterruptedPath, s_testInterval);
+		CHECK(game.LoadData());
+		CaptureLoot(game, uninterrupted);
+		game.SlayBatchOfMonsters(s_testKills, type);
+	}
+
+	LootSession resumed;
+	{
+		Game game;
+		game.SetCheckpointing(resumedPath, s_testInterval);
+		CHECK(game.LoadData());
+		CHECK(SaveCheckpoint(resumedPath, MakeStoppedCheckpoint(game, type)));
+		CaptureLoot(game, resumed);
+		CHECK(game.ResumeBatchOfMonsters(resumedPath));
+	}
+
+	CHECK(!uninterrupted.monsters.empty());
+	CHECK(IsSameLootSession(uninterrupted, resumed));
+
+	BatchCheckpoint uninterruptedEnd;
+	BatchCheckpoint resumedEnd;
+	CHECK(LoadCheckpoint(uninterruptedPath, uninterruptedEnd));
+	CHECK(LoadCheckpoint(resumedPath, resumedEnd));
+	CHECK(uninterruptedEnd.remainingCount == 0 && resumedEnd.remainingCount == 0);
+	CHECK(std::memcmp(&uninterruptedEnd.counters, &resumedEnd.counters, sizeof(LootCounters)) == 0);
+	CHECK(std::memcmp(&uninterruptedEnd.rng, &resumedEnd.rng, sizeof(RngState)) == 0);
+
+	std::filesystem::remove(uninterruptedPath);
+	std::filesystem::remove(resumedPath);
+}
+
+TEST_CASE(ResumedFixedTypeBatchMatchesUninterrupted)
+{
+	CheckResumeMatchesUninterrupted(MonsterType::DRAGON);
+}
+
+TEST_CASE(ResumedRandomBatchMatchesUninterrupted)
+{
+	CheckResumeMatchesUninterrupted(std::nullopt);
+}
+
+TEST_CASE(CheckpointForOtherContentIsRefused)
+{
+	std::string path = GetTestCheckpointPath("lootsim-test-other-content.checkpoint");
+
+	Game game;
+	CHECK(game.LoadData());
+	BatchCheckpoint checkpoint = MakeStoppedCheckpoint(game, MonsterType::DRAGON);
+	checkpoint.contentHash = game.GetContentHash() + 1;
+	CHECK(SaveCheckpoint(path, checkpoint));
+	CHECK(!game.ResumeBatchOfMonsters(path));
+
+	std::filesystem::remove(path);
+}
+
+//===============================================================
+
+} // namespace Tests
+} // namespace LootSimulator
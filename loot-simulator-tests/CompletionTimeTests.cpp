@@ -0,0 +1,130 @@
+//---------------------------------------------------------------
+//
+// CompletionTimeTests.cpp
+//
+
+#include "TestHarness.h"
+
+#include "CompletionTime.h"
+#include "LootModel.h"
+
+#include <cmath>
+#include <set>
+#include <vector>
+
+namespace LootSimulator {
+namespace Tests {
+
+//===============================================================
+
+static const uint64_t s_testSeed = 1;
+
+static Treasure MakeTreasure(TreasureType type, float dropRate)
+{
+	Treasure treasure;
+	treasure.type = type;
+	treasure.dropRate = dropRate;
+	return treasure;
+}
+
+// Goblins with one guaranteed table per entry of tables. Weights are powers of 2, so the
+// float totals are exact.
+static LootModel MakeGoblinModel(const std::vector<std::vector<Treasure>>& tables)
+{
+	Monster goblin;
+	goblin.type = MonsterType::GOBLIN;
+	for (const std::vector<Treasure>& treasures : tables)
+	{
+		LootTable& table = goblin.tables.emplace_back();
+		table.treasures = treasures;
+	}
+	return LootModel(std::set<Monster>{ goblin });
+}
+
+// Smallest kills with at least fraction chance of being done, for a chance done within kills.
+template <typename Function>
+static int64_t GetPercentileKills(double fraction, Function getCompleteChance)
+{
+	int64_t kills = 1;
+	while (getCompleteChance(kills) < fraction)
+	{
+		++kills;
+	}
+	return kills;
+}
+
+// One kill drops one of 4 treasures, each with chance 1/8: the coupon collector, needing
+// 8 * (1 + 1/2 + 1/3 + 1/4) kills on average.
+TEST_CASE(EqualChancesMatchCouponCollector)
+{
+	const double chance = 0.125;
+	LootModel lootModel = MakeGoblinModel({ {
+		MakeTreasure(TreasureType::REGENERATION_RING, 0.125f),
+		MakeTreasure(TreasureType::CURSED_RING, 0.125f),
+		MakeTreasure(TreasureType::HEATER_SHIELD, 0.125f),
+		MakeTreasure(TreasureType::KITE_SHIELD, 0.125f),
+		MakeTreasure(TreasureType::NOTHING, 0.5f) } });
+	std::vector<TreasureType> treasures = { TreasureType::REGENERATION_RING, TreasureType::CURSED_RING,
+		TreasureType::HEATER_SHIELD, TreasureType::KITE_SHIELD };
+
+	CompletionReport report = GetCompletionTime(lootModel, MonsterType::GOBLIN, treasures,
+		GetMagicFindBucket(0.0f), 1, 1, s_testSeed);
+	CHECK(report.canComplete);
+	CHECK(report.isExact);
+	CHECK_NEAR(report.expectedKills, (1.0 + 1.0 / 2.0 + 1.0 / 3.0 + 1.0 / 4.0) / chance, 1e-9);
+
+	// Done within kills unless some j of the 4 never dropped.
+	auto getCompleteChance = [chance](int64_t kills)
+	{
+		double k = static_cast<double>(kills);
+		return 1.0 - 4.0 * std::pow(1.0 - chance, k) + 6.0 * std::pow(1.0 - 2.0 * chance, k)
+			- 4.0 * std::pow(1.0 - 3.0 * chance, k) + std::pow(1.0 - 4.0 * chance, k);
+	};
+	for (size_t i = 0; i < std::size(s_completionPercentiles); ++i)
+	{
+		CHECK(report.percentileKills[i] == GetPercentileKills(s_completionPercentiles[i] / 100.0, getCompleteChance));
+	}
+}
+
+// Two guaranteed tables drop one treasure each, so a kill can drop both. Done at the
+// larger of two geometric waits: 1/a + 1/b - 1/(1 - (1 - a)(1 - b)) kills on average.
+TEST_CASE(IndependentTablesMatchGeometricMaximum)
+{
+	const double ringChance = 0.25;
+	const double shieldChance = 0.5;
+	LootModel lootModel = MakeGoblinModel({
+		{ MakeTreasure(TreasureType::REGENERATION_RING, 0.25f), MakeTreasure(TreasureType::NOTHING, 0.75f) },
+		{ MakeTreasure(TreasureType::HEATER_SHIELD, 0.5f), MakeTreasure(TreasureType::NOTHING, 0.5f) } });
+	std::vector<TreasureType> treasures = { TreasureType::REGENERATION_RING, TreasureType::HEATER_SHIELD };
+
+	CompletionReport report = GetCompletionTime(lootModel, MonsterType::GOBLIN, treasures,
+		GetMagicFindBucket(0.0f), 1, 1, s_testSeed);
+	CHECK(report.canComplete);
+	CHECK(report.isExact);
+
+	double eitherChance = 1.0 - (1.0 - ringChance) * (1.0 - shieldChance);
+	CHECK_NEAR(report.expectedKills, 1.0 / ringChance + 1.0 / shieldChance - 1.0 / eitherChance, 1e-9);
+
+	auto getCompleteChance = [=](int64_t kills)
+	{
+		double k = static_cast<double>(kills);
+		return (1.0 - std::pow(1.0 - ringChance, k)) * (1.0 - std::pow(1.0 - shieldChance, k));
+	};
+	for (size_t i = 0; i < std::size(s_completionPercentiles); ++i)
+	{
+		CHECK(report.percentileKills[i] == GetPercentileKills(s_completionPercentiles[i] / 100.0, getCompleteChance));
+	}
+}
+
+TEST_CASE(MissingTreasureCantComplete)
+{
+	LootModel lootModel = MakeGoblinModel({ { MakeTreasure(TreasureType::REGENERATION_RING, 1.0f) } });
+	CompletionReport report = GetCompletionTime(lootModel, MonsterType::GOBLIN,
+		{ TreasureType::REGENERATION_RING, TreasureType::APPLE }, GetMagicFindBucket(0.0f), 1, 1, s_testSeed);
+	CHECK(!report.canComplete);
+}
+
+//===============================================================
+
+} // namespace Tests
+} // namespace LootSimulator
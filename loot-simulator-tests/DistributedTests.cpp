@@ -0,0 +1,120 @@
+//---------------------------------------------------------------
+//
+// DistributedTests.cpp
+//
+
+#include "TestHarness.h"
+#include "TestUtilities.h"
+
+#include "DistributedSimulation.h"
+#include "Game.h"
+#include "ShardedSimulation.h"
+#include "Socket.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace LootSimulator {
+namespace Tests {
+
+//===============================================================
+
+static const uint64_t s_testSeed = 1;
+static const int64_t s_testKills = 1000003;
+static const int32_t s_testShardCount = 4;
+static const int32_t s_testWorkerCount = 2;
+
+static SimulationJob MakeJob(const Game& game)
+{
+	SimulationJob job;
+	job.count = s_testKills;
+	job.seed = s_testSeed;
+	job.contentHash = game.GetContentHash();
+	job.shardCount = s_testShardCount;
+	return job;
+}
+
+// Live workers on free localhost ports, with their addresses added to addresses.
+static std::vector<std::unique_ptr<SimulationWorker>> StartWorkers(Game& game, std::vector<WorkerAddress>& addresses)
+{
+	std::vector<std::unique_ptr<SimulationWorker>> workers;
+	for (int32_t i = 0; i < s_testWorkerCount; ++i)
+	{
+		auto worker = std::make_unique<SimulationWorker>(game);
+		CHECK(worker->Start("127.0.0.1", 0));
+		CHECK(worker->GetPort() != 0);
+		worker->RunInBackground();
+		addresses.push_back({ "127.0.0.1", worker->GetPort() });
+		workers.push_back(std::move(worker));
+	}
+	return workers;
+}
+
+TEST_CASE(DistributedMatchesSharded)
+{
+	Game game;
+	CHECK(game.LoadData());
+
+	std::vector<WorkerAddress> addresses;
+	std::vector<std::unique_ptr<SimulationWorker>> workers = StartWorkers(game, addresses);
+
+	LootSession distributed;
+	LootSession sharded;
+	CHECK(SimulateDistributed(MakeJob(game), addresses, distributed));
+	CHECK(SimulateSharded(game, s_testKills, std::nullopt, s_testSeed, s_testShardCount, sharded));
+	CHECK(IsSameLootSession(distributed, sharded));
+}
+
+// The first worker takes a shard and hangs up without answering, as if it died mid-shard.
+// The shard has to be retried on a live worker and the result can't change.
+TEST_CASE(DistributedSurvivesLostWorker)
+{
+	Game game;
+	CHECK(game.LoadData());
+
+	Socket listener;
+	CHECK(listener.Listen("127.0.0.1", 0));
+	std::atomic<bool> hasTakenShard = false;
+	std::thread dyingWorker([&listener, &hasTakenShard]()
+	{
+		Socket connection = listener.Accept();
+		hasTakenShard = connection.IsValid();
+		connection.Close();
+	});
+
+	std::vector<WorkerAddress> addresses = { { "127.0.0.1", listener.GetLocalPort() } };
+	std::vector<std::unique_ptr<SimulationWorker>> workers = StartWorkers(game, addresses);
+
+	LootSession distributed;
+	LootSession sharded;
+	CHECK(SimulateDistributed(MakeJob(game), addresses, distributed));
+	CHECK(SimulateSharded(game, s_testKills, std::nullopt, s_testSeed, s_testShardCount, sharded));
+	CHECK(IsSameLootSession(distributed, sharded));
+
+	listener.Shutdown();
+	dyingWorker.join();
+	listener.Close();
+	CHECK(hasTakenShard);
+}
+
+TEST_CASE(DistributedRejectsOtherContent)
+{
+	Game game;
+	CHECK(game.LoadData());
+
+	std::vector<WorkerAddress> addresses;
+	std::vector<std::unique_ptr<SimulationWorker>> workers = StartWorkers(game, addresses);
+
+	SimulationJob job = MakeJob(game);
+	job.contentHash = game.GetContentHash() + 1;
+	LootSession lootSession;
+	CHECK(!SimulateDistributed(job, addresses, lootSession));
+	CHECK(lootSession.monsters.empty());
+}
+
+//===============================================================
+
+} // namespace Tests
+} // namespace LootSimulator
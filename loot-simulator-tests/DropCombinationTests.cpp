@@ -0,0 +1,116 @@
+//---------------------------------------------------------------
+//
+// DropCombinationTests.cpp
+//
+
+#include "TestHarness.h"
+#include "TestUtilities.h"
+
+#include "DropCombinations.h"
+#include "Game.h"
+#include "LootModel.h"
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace LootSimulator {
+namespace Tests {
+
+//===============================================================
+
+static const uint64_t s_testSeed = 1;
+
+// Enough masks to grow the table several times, with counts that differ per mask.
+TEST_CASE(CombinationMapMatchesOrderedMap)
+{
+	DropCombinationMap combinations;
+	DropCombinationMap otherCombinations;
+	std::map<uint64_t, int64_t> expected;
+	for (uint64_t i = 0; i < 5000; ++i)
+	{
+		uint64_t mask = (i * 0x2545f4914f6cdd1dull) >> (i % 7);
+		int64_t count = static_cast<int64_t>(i % 13) + 1;
+		(i % 3 == 0 ? otherCombinations : combinations).Add(mask, count);
+		expected[mask] += count;
+	}
+	combinations.Add(0, 2);
+	expected[0] += 2;
+	combinations.Merge(otherCombinations);
+
+	std::vector<std::pair<uint64_t, int64_t>> actual = combinations.GetCombinations();
+	CHECK(combinations.GetSize() == expected.size());
+	CHECK(actual.size() == expected.size());
+	for (size_t i = 0; i < actual.size(); ++i)
+	{
+		CHECK(expected.count(actual[i].first) == 1 && expected.at(actual[i].first) == actual[i].second);
+		CHECK(i == 0 || actual[i - 1].second >= actual[i].second);
+	}
+}
+
+// Each combination's share of a million Dragon kills against the model's chance of it,
+// to 5 standard errors, with the matrix consistent with the combinations.
+TEST_CASE(CombinationsMatchModelChances)
+{
+	Game game;
+	CHECK(game.LoadData());
+
+	const int64_t killCount = 1000000;
+	DropCombinationReport report;
+	RunDropCombinations(game, MonsterType::DRAGON, killCount, 4, s_testSeed, report);
+	CHECK(report.killCount == killCount);
+
+	std::vector<TreasureType> treasures;
+	for (size_t t = 0; t < s_numTreasureTypes; ++t)
+	{
+		treasures.push_back(static_cast<TreasureType>(t));
+	}
+	std::vector<std::pair<uint64_t, double>> maskChances;
+	game.GetLootModel().GetDropMaskChances(MonsterType::DRAGON, treasures, GetMagicFindBucket(0.0f), maskChances);
+
+	std::map<uint64_t, int64_t> counts;
+	for (const std::pair<uint64_t, int64_t>& combination : report.combinations.GetCombinations())
+	{
+		counts[combination.first] = combination.second;
+	}
+
+	int64_t countedKills = 0;
+	for (const std::pair<uint64_t, double>& mask : maskChances)
+	{
+		double expected = mask.second * static_cast<double>(killCount);
+		double actual = counts.count(mask.first) ? static_cast<double>(counts.at(mask.first)) : 0.0;
+		CHECK_NEAR(actual, expected, 5.0 * std::sqrt(expected * (1.0 - mask.second)) + 1.0);
+		countedKills += static_cast<int64_t>(actual);
+	}
+	CHECK(countedKills == killCount);
+
+	for (size_t i = 0; i < s_numTreasureTypes; ++i)
+	{
+		for (size_t j = 0; j < s_numTreasureTypes; ++j)
+		{
+			uint64_t pair = (uint64_t(1) << i) | (uint64_t(1) << j);
+			int64_t expected = 0;
+			for (const std::pair<const uint64_t, int64_t>& count : counts)
+			{
+				expected += (count.first & pair) == pair ? count.second : 0;
+			}
+			CHECK(report.coOccurrences[i][j] == expected);
+		}
+	}
+}
+
+TEST_CASE(CombinationsDontDependOnThreadCount)
+{
+	DropCombinationReport oneThread;
+	DropCombinationReport fourThreads;
+	RunOnOneAndFourThreads([](Game& game, int32_t threadCount, DropCombinationReport& report)
+	{
+		RunDropCombinations(game, std::nullopt, 300000, threadCount, s_testSeed, report);
+	}, oneThread, fourThreads);
+	CHECK(oneThread.combinations.GetCombinations() == fourThreads.combinations.GetCombinations());
+}
+
+//===============================================================
+
+} // namespace Tests
+} // namespace LootSimulator
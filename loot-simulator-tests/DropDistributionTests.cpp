@@ -0,0 +1,110 @@
+//---------------------------------------------------------------
+//
+// DropDistributionTests.cpp
+//
+
+#include "TestHarness.h"
+#include "TestUtilities.h"
+
+#include "DropDistribution.h"
+#include "Game.h"
+#include "LootModel.h"
+
+#include <vector>
+
+namespace LootSimulator {
+namespace Tests {
+
+//===============================================================
+
+static double GetVariance(const DropDistribution& distribution)
+{
+	double mean = distribution.GetMean();
+	double variance = 0.0;
+	for (int64_t count = distribution.GetFirstCount(); count <= distribution.GetLastCount(); ++count)
+	{
+		double offset = static_cast<double>(count) - mean;
+		variance += offset * offset * distribution.GetProbability(count);
+	}
+	return variance;
+}
+
+TEST_CASE(SmallPowerIsBinomial)
+{
+	const int64_t trials = 20;
+	const double probability = 0.3;
+	DropDistribution distribution = GetConvolutionPower({ 1.0 - probability, probability }, trials);
+
+	for (int64_t count = 0; count <= trials; ++count)
+	{
+		CHECK_NEAR(distribution.GetProbability(count), GetBinomialProbability(trials, probability, count), 1e-12);
+	}
+	CHECK_NEAR(distribution.GetCumulativeProbability(trials), 1.0, 1e-12);
+}
+
+// Long enough that the powers go through FFTs and have their tails trimmed.
+TEST_CASE(LargePowerMatchesBinomialMoments)
+{
+	const int64_t trials = 1000000;
+	const double probability = 0.1;
+	DropDistribution distribution = GetConvolutionPower({ 1.0 - probability, probability }, trials);
+
+	double mean = static_cast<double>(trials) * probability;
+	double variance = mean * (1.0 - probability);
+	CHECK_NEAR(distribution.GetMean(), mean, 1e-6);
+	CHECK_NEAR(GetVariance(distribution), variance, 1e-4);
+	CHECK_NEAR(distribution.GetCumulativeProbability(distribution.GetLastCount()), 1.0, 1e-12);
+
+	// lgamma of a million is only good to about 1e-9 of the chance, so that's as close as
+	// the reference gets.
+	for (int64_t count : { 99000, 99700, 100000, 100300, 101000 })
+	{
+		double expected = GetBinomialProbability(trials, probability, count);
+		CHECK_NEAR(distribution.GetProbability(count) / expected, 1.0, 1e-7);
+	}
+	CHECK(distribution.GetMostLikelyCount() == 100000);
+	CHECK(distribution.GetCountAtPercentile(50.0) == 100000);
+}
+
+// More than one of a treasure per draw, so the counts aren't binomial.
+TEST_CASE(PowerMatchesMomentsOfEachDraw)
+{
+	const std::vector<double> chances = { 0.5, 0.3, 0.15, 0.05 };
+	const int64_t count = 123457;
+	DropDistribution distribution = GetConvolutionPower(chances, count);
+
+	double drawMean = 0.0;
+	double drawSquares = 0.0;
+	for (size_t k = 0; k < chances.size(); ++k)
+	{
+		drawMean += static_cast<double>(k) * chances[k];
+		drawSquares += static_cast<double>(k * k) * chances[k];
+	}
+	double drawVariance = drawSquares - drawMean * drawMean;
+
+	CHECK_NEAR(distribution.GetMean(), static_cast<double>(count) * drawMean, 1e-6);
+	CHECK_NEAR(GetVariance(distribution), static_cast<double>(count) * drawVariance, 1e-4);
+}
+
+TEST_CASE(DropDistributionMatchesModelMean)
+{
+	Game game;
+	CHECK(game.LoadData());
+
+	const int64_t killCount = 1000000;
+	uint32_t magicFindBucket = GetMagicFindBucket(0.0f);
+	double expectedCounts[s_numTreasureTypes] = {};
+	game.GetLootModel().GetExpectedDropCounts(MonsterType::DRAGON, expectedCounts);
+	for (size_t t = 0; t < s_numTreasureTypes; ++t)
+	{
+		TreasureType treasure = static_cast<TreasureType>(t);
+		DropDistribution distribution = GetDropDistribution(game.GetLootModel(), MonsterType::DRAGON,
+			treasure, magicFindBucket, killCount);
+		CHECK_NEAR(distribution.GetMean(), static_cast<double>(killCount) * expectedCounts[t], 1e-6);
+	}
+}
+
+//===============================================================
+
+} // namespace Tests
+} // namespace LootSimulator
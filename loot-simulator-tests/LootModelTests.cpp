@@ -0,0 +1,57 @@
+//---------------------------------------------------------------
+//
+// LootModelTests.cpp
+//
+
+#include "TestHarness.h"
+
+#include "Game.h"
+#include "LootModel.h"
+
+#include <cstring>
+
+namespace LootSimulator {
+namespace Tests {
+
+//===============================================================
+
+static const uint64_t s_testSeed = 1;
+static const int32_t s_killsPerMonster = 100000;
+
+// Monster::RerollLoot is the straightforward reading of the content rules and is kept only
+// as the oracle for LootModel. From the same stream both must drop the same treasures, in
+// the same order, and leave the stream in the same place.
+TEST_CASE(RollLootMatchesRerollLoot)
+{
+	Game game;
+	CHECK(game.LoadData());
+
+	const LootModel& lootModel = game.GetLootModel();
+	for (Monster monster : game.GetMonsters())
+	{
+		RngState oracleRng = SeedRng(s_testSeed);
+		RngState modelRng = SeedRng(s_testSeed);
+		int32_t mismatchCount = 0;
+		for (int32_t i = 0; i < s_killsPerMonster; ++i)
+		{
+			monster.RerollLoot(oracleRng);
+
+			TreasureType drops[s_maxDropsPerKill];
+			size_t dropCount = lootModel.RollLoot(monster.type, modelRng, drops);
+			bool isSame = dropCount == monster.lootDrops.size();
+			for (size_t d = 0; isSame && d < dropCount; ++d)
+			{
+				isSame = drops[d] == monster.lootDrops[d].type;
+			}
+			mismatchCount += isSame ? 0 : 1;
+		}
+
+		CHECK(mismatchCount == 0);
+		CHECK(std::memcmp(&oracleRng, &modelRng, sizeof(RngState)) == 0);
+	}
+}
+
+//===============================================================
+
+} // namespace Tests
+} // namespace LootSimulator
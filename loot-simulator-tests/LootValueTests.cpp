@@ -0,0 +1,150 @@
+//---------------------------------------------------------------
+//
+// LootValueTests.cpp
+//
+
+#include "TestHarness.h"
+#include "TestUtilities.h"
+
+#include "Game.h"
+#include "LootValue.h"
+#include "Random.h"
+#include "ValueMoments.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace LootSimulator {
+namespace Tests {
+
+//===============================================================
+
+static const uint64_t s_testSeed = 1;
+
+static bool IsNear(double actual, double expected, double relativeTolerance)
+{
+	return std::abs(actual - expected) <= relativeTolerance * std::max(std::abs(expected), 1.0);
+}
+
+// 1 to n, shifted far from 0 so a naive sum of squares would cancel away every digit.
+TEST_CASE(MomentsOfShiftedUniform)
+{
+	const int32_t n = 1001;
+	const double offset = 1e9;
+	ValueMoments moments;
+	for (int32_t i = 1; i <= n; ++i)
+	{
+		moments.Record(offset + i);
+	}
+
+	double count = static_cast<double>(n);
+	CHECK(moments.GetCount() == static_cast<uint64_t>(n));
+	CHECK(IsNear(moments.GetMean(), offset + (count + 1.0) / 2.0, 1e-15));
+	CHECK(IsNear(moments.GetVariance(), count * (count + 1.0) / 12.0, 1e-9));
+	CHECK_NEAR(moments.GetSkewness(), 0.0, 1e-9);
+	CHECK(IsNear(moments.GetExcessKurtosis(), -6.0 * (count * count + 1.0) / (5.0 * (count * count - 1.0)), 1e-9));
+	CHECK(moments.GetMin() == offset + 1.0);
+	CHECK(moments.GetMax() == offset + count);
+}
+
+// 0 or 1 with chance p of 1: skewness (1 - 2p) / sqrt(p q) and excess kurtosis
+// (1 - 6 p q) / (p q), with q = 1 - p.
+TEST_CASE(MomentsOfTwoPoints)
+{
+	ValueMoments moments;
+	for (int32_t i = 0; i < 1000; ++i)
+	{
+		moments.Record(i % 10 == 0 ? 1.0 : 0.0);
+	}
+
+	double p = 0.1;
+	double pq = p * (1.0 - p);
+	CHECK(IsNear(moments.GetMean(), p, 1e-12));
+	CHECK(IsNear(moments.GetVariance(), pq * 1000.0 / 999.0, 1e-12));
+	CHECK(IsNear(moments.GetSkewness(), (1.0 - 2.0 * p) / std::sqrt(pq), 1e-12));
+	CHECK(IsNear(moments.GetExcessKurtosis(), (1.0 - 6.0 * pq) / pq, 1e-12));
+}
+
+TEST_CASE(MergedMomentsMatchOneRecording)
+{
+	ValueMoments all;
+	ValueMoments parts[3];
+	RngState rng = SeedRng(s_testSeed);
+	for (int32_t i = 0; i < 10000; ++i)
+	{
+		// Skewed, and uneven parts with different means.
+		double value = -std::log1p(-NextRandomDouble(rng)) * (1.0 + i % 3);
+		all.Record(value);
+		parts[i < 100 ? 0 : (i < 7000 ? 1 : 2)].Record(value);
+	}
+
+	ValueMoments merged;
+	for (const ValueMoments& part : parts)
+	{
+		merged.Merge(part);
+	}
+	CHECK(merged.GetCount() == all.GetCount());
+	CHECK(IsNear(merged.GetMean(), all.GetMean(), 1e-12));
+	CHECK(IsNear(merged.GetVariance(), all.GetVariance(), 1e-12));
+	CHECK(IsNear(merged.GetSkewness(), all.GetSkewness(), 1e-10));
+	CHECK(IsNear(merged.GetExcessKurtosis(), all.GetExcessKurtosis(), 1e-10));
+	CHECK(merged.GetMin() == all.GetMin());
+	CHECK(merged.GetMax() == all.GetMax());
+}
+
+// A million Dragon kills against GetExpectedLootValue, to 5 standard errors. The variance's
+// standard error comes from the sample's own kurtosis.
+TEST_CASE(LootValueMatchesModel)
+{
+	Game game;
+	CHECK(game.LoadData());
+
+	const int64_t killCount = 1000000;
+	const int64_t sessionKills = 10;
+	LootValueReport report;
+	RunLootValueSimulation(game, MonsterType::DRAGON, killCount, sessionKills, 4, s_testSeed, report);
+
+	double values[s_numTreasureTypes];
+	GetTreasureValueTable(game.GetTreasureValues(), values);
+	double mean = 0.0;
+	double variance = 0.0;
+	GetExpectedLootValue(game.GetLootModel(), MonsterType::DRAGON, values, GetMagicFindBucket(0.0f), mean, variance);
+	CHECK(mean > 0.0 && variance > 0.0);
+
+	auto checkMoments = [](const ValueMoments& moments, double expectedMean, double expectedVariance)
+	{
+		double count = static_cast<double>(moments.GetCount());
+		double kurtosis = moments.GetExcessKurtosis();
+		CHECK_NEAR(moments.GetMean(), expectedMean, 5.0 * std::sqrt(expectedVariance / count));
+		CHECK_NEAR(moments.GetVariance(), expectedVariance, 5.0 * expectedVariance * std::sqrt((kurtosis + 2.0) / count));
+	};
+
+	CHECK(report.killValues.GetCount() == static_cast<uint64_t>(killCount));
+	CHECK(report.sessionValues.GetCount() == static_cast<uint64_t>(killCount / sessionKills));
+	checkMoments(report.killValues, mean, variance);
+	checkMoments(report.sessionValues, mean * sessionKills, variance * sessionKills);
+
+	// The histogram saw every kill, rounded to whole gold.
+	CHECK(report.killHistogram.GetCount() == report.killValues.GetCount());
+	CHECK(report.killHistogram.GetMax() == static_cast<uint64_t>(std::llround(report.killValues.GetMax())));
+}
+
+TEST_CASE(LootValueDoesntDependOnThreadCount)
+{
+	LootValueReport oneThread;
+	LootValueReport fourThreads;
+	RunOnOneAndFourThreads([](Game& game, int32_t threadCount, LootValueReport& report)
+	{
+		RunLootValueSimulation(game, std::nullopt, 300000, 7, threadCount, s_testSeed, report);
+	}, oneThread, fourThreads);
+	CHECK(oneThread.killValues.GetMean() == fourThreads.killValues.GetMean());
+	CHECK(oneThread.killValues.GetVariance() == fourThreads.killValues.GetVariance());
+	CHECK(oneThread.sessionValues.GetMean() == fourThreads.sessionValues.GetMean());
+	CHECK(oneThread.sessionValues.GetExcessKurtosis() == fourThreads.sessionValues.GetExcessKurtosis());
+	CHECK(oneThread.killHistogram.GetValueAtPercentile(99.0) == fourThreads.killHistogram.GetValueAtPercentile(99.0));
+}
+
+//===============================================================
+
+} // namespace Tests
+} // namespace LootSimulator
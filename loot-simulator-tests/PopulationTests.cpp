@@ -0,0 +1,105 @@
+//---------------------------------------------------------------
+//
+// PopulationTests.cpp
+//
+
+#include "TestHarness.h"
+#include "TestUtilities.h"
+
+#include "CountHistogram.h"
+#include "DropDistribution.h"
+#include "Game.h"
+#include "LootModel.h"
+#include "PopulationSimulation.h"
+
+#include <algorithm>
+
+namespace LootSimulator {
+namespace Tests {
+
+//===============================================================
+
+static const uint64_t s_testSeed = 1;
+
+TEST_CASE(CountHistogramPercentilesAreExact)
+{
+	CountHistogram low;
+	CountHistogram high;
+	for (uint64_t value = 1; value <= 100; ++value)
+	{
+		(value <= 30 ? low : high).Record(value);
+	}
+	low.Merge(high);
+
+	CHECK(low.GetCount() == 100);
+	CHECK(low.GetMax() == 100);
+	CHECK_NEAR(low.GetMean(), 50.5, 1e-12);
+	CHECK(low.GetValueAtPercentile(1.0) == 1);
+	CHECK(low.GetValueAtPercentile(10.0) == 10);
+	CHECK(low.GetValueAtPercentile(50.0) == 50);
+	CHECK(low.GetValueAtPercentile(99.0) == 99);
+	CHECK(low.GetValueAtPercentile(100.0) == 100);
+	CHECK(low.GetCountAtValue(0) == 0 && low.GetCountAtValue(37) == 1 && low.GetCountAtValue(101) == 0);
+}
+
+// Each player's count of a treasure is the sum of their kills' counts, so it follows the
+// exact drop distribution.
+TEST_CASE(PlayerCountsMatchDropDistribution)
+{
+	Game game;
+	CHECK(game.LoadData());
+
+	const int64_t playerCount = 20000;
+	const int64_t killsPerPlayer = 200;
+	PopulationReport report;
+	RunPopulationSimulation(game, MonsterType::DRAGON, playerCount, killsPerPlayer, 4, s_testSeed, report);
+	CHECK(report.playerCount == playerCount);
+
+	int32_t checkedTreasures = 0;
+	for (size_t t = 0; t < s_numTreasureTypes; ++t)
+	{
+		const CountHistogram& counts = report.treasureCounts[t];
+		CHECK(counts.GetCount() == static_cast<uint64_t>(playerCount));
+
+		DropDistribution distribution = GetDropDistribution(game.GetLootModel(), MonsterType::DRAGON,
+			static_cast<TreasureType>(t), GetMagicFindBucket(0.0f), killsPerPlayer);
+		if (distribution.GetLastCount() == 0)
+		{
+			CHECK(counts.GetMax() == 0);
+			continue;
+		}
+
+		ChiSquaredTest test;
+		int64_t lastCount = std::max(distribution.GetLastCount(), static_cast<int64_t>(counts.GetMax()));
+		for (int64_t count = 0; count <= lastCount; ++count)
+		{
+			test.AddBin(distribution.GetProbability(count) * playerCount,
+				static_cast<double>(counts.GetCountAtValue(static_cast<uint64_t>(count))));
+		}
+		CHECK(test.IsFit());
+		++checkedTreasures;
+	}
+	CHECK(checkedTreasures > 0);
+}
+
+TEST_CASE(PopulationDoesntDependOnThreadCount)
+{
+	PopulationReport oneThread;
+	PopulationReport fourThreads;
+	RunOnOneAndFourThreads([](Game& game, int32_t threadCount, PopulationReport& report)
+	{
+		RunPopulationSimulation(game, std::nullopt, 5000, 50, threadCount, s_testSeed, report);
+	}, oneThread, fourThreads);
+	for (size_t t = 0; t < s_numTreasureTypes; ++t)
+	{
+		for (uint64_t value = 0; value <= oneThread.treasureCounts[t].GetMax(); ++value)
+		{
+			CHECK(oneThread.treasureCounts[t].GetCountAtValue(value) == fourThreads.treasureCounts[t].GetCountAtValue(value));
+		}
+	}
+}
+
+//===============================================================
+
+} // namespace Tests
+} // namespace LootSimulator
@@ -0,0 +1,105 @@
+//---------------------------------------------------------------
+//
+// RandomTests.cpp
+//
+
+#include "TestHarness.h"
+#include "TestUtilities.h"
+
+#include "Random.h"
+
+#include <cmath>
+#include <vector>
+
+namespace LootSimulator {
+namespace Tests {
+
+//===============================================================
+
+static const uint64_t s_testSeed = 1;
+static const int32_t s_sampleCount = 200000;
+
+// s_sampleCount draws against the binomial pmf.
+static bool IsBinomialFit(int64_t trials, double probability)
+{
+	RngState rng = SeedRng(s_testSeed);
+	std::vector<int32_t> observed(static_cast<size_t>(trials) + 1, 0);
+	for (int32_t i = 0; i < s_sampleCount; ++i)
+	{
+		int64_t successes = NextRandomBinomial(rng, trials, probability);
+		if (successes < 0 || successes > trials)
+		{
+			return false;
+		}
+		++observed[static_cast<size_t>(successes)];
+	}
+
+	ChiSquaredTest test;
+	for (int64_t count = 0; count <= trials; ++count)
+	{
+		test.AddBin(GetBinomialProbability(trials, probability, count) * s_sampleCount,
+			static_cast<double>(observed[static_cast<size_t>(count)]));
+	}
+	return test.IsFit();
+}
+
+TEST_CASE(BinomialEdgeCases)
+{
+	RngState rng = SeedRng(s_testSeed);
+	CHECK(NextRandomBinomial(rng, 0, 0.5) == 0);
+	CHECK(NextRandomBinomial(rng, -5, 0.5) == 0);
+	CHECK(NextRandomBinomial(rng, 100, 0.0) == 0);
+	CHECK(NextRandomBinomial(rng, 100, NAN) == 0);
+	CHECK(NextRandomBinomial(rng, 100, 1.0) == 100);
+}
+
+// Few successes expected, so these walk up from zero.
+TEST_CASE(BinomialInversionFits)
+{
+	CHECK(IsBinomialFit(50, 0.1));
+	CHECK(IsBinomialFit(1000, 0.002));
+}
+
+// At least 10 successes expected, so these go through BTRS rejection.
+TEST_CASE(BinomialRejectionFits)
+{
+	CHECK(IsBinomialFit(40, 0.25));
+	CHECK(IsBinomialFit(1000, 0.3));
+	CHECK(IsBinomialFit(100000, 0.01));
+}
+
+TEST_CASE(BinomialAboveHalfFits)
+{
+	CHECK(IsBinomialFit(30, 0.9));
+	CHECK(IsBinomialFit(1000, 0.7));
+}
+
+// Too many trials to check against the pmf, so the sample moments are checked against
+// n * p and n * p * (1 - p), to 5 of their standard errors.
+TEST_CASE(BinomialHugeTrialMoments)
+{
+	const int64_t trials = 1000000000000;
+	const double probability = 0.001;
+	RngState rng = SeedRng(s_testSeed);
+
+	double sum = 0.0;
+	double sumSquares = 0.0;
+	for (int32_t i = 0; i < s_sampleCount; ++i)
+	{
+		double successes = static_cast<double>(NextRandomBinomial(rng, trials, probability));
+		sum += successes;
+		sumSquares += successes * successes;
+	}
+
+	double mean = static_cast<double>(trials) * probability;
+	double variance = mean * (1.0 - probability);
+	double sampleMean = sum / s_sampleCount;
+	double sampleVariance = (sumSquares - sum * sampleMean) / (s_sampleCount - 1);
+	CHECK_NEAR(sampleMean, mean, 5.0 * std::sqrt(variance / s_sampleCount));
+	CHECK_NEAR(sampleVariance, variance, 5.0 * variance * std::sqrt(2.0 / s_sampleCount));
+}
+
+//===============================================================
+
+} // namespace Tests
+} // namespace LootSimulator
@@ -0,0 +1,98 @@
+//---------------------------------------------------------------
+//
+// ShardedTests.cpp
+//
+
+#include "TestHarness.h"
+#include "TestUtilities.h"
+
+#include "Game.h"
+#include "GameEvents.h"
+#include "LootCounters.h"
+#include "ShardedSimulation.h"
+
+#include <optional>
+
+namespace LootSimulator {
+namespace Tests {
+
+//===============================================================
+
+static const uint64_t s_testSeed = 1;
+static const int64_t s_testKills = 100003;
+static const int32_t s_testShardCount = 4;
+
+// The forked shards have to add up to the same counters as running each shard here.
+static void CheckShardsAddUp(Game& game, std::optional<MonsterType> type)
+{
+	LootSession sharded;
+	CHECK(SimulateSharded(game, s_testKills, type, s_testSeed, s_testShardCount, sharded));
+
+	LootCounters merged;
+	for (int32_t i = 0; i < s_testShardCount; ++i)
+	{
+		LootCounters counters;
+		SimulateShard(game, s_testKills, type, s_testSeed, s_testShardCount, i, counters);
+		MergeLootCounters(merged, counters);
+	}
+	LootSession expected;
+	AppendToLootSession(merged, expected);
+	CHECK(IsSameLootSession(sharded, expected));
+
+	int64_t kills = 0;
+	for (const auto& monsterCount : sharded.monsterCounts)
+	{
+		kills += monsterCount.second;
+	}
+	CHECK(kills == s_testKills);
+}
+
+TEST_CASE(ShardedCountersAreSumOfShards)
+{
+	Game game;
+	CHECK(game.LoadData());
+
+	CheckShardsAddUp(game, MonsterType::DRAGON);
+	CheckShardsAddUp(game, std::nullopt);
+}
+
+TEST_CASE(ShardedRunsAreRepeatable)
+{
+	Game game;
+	CHECK(game.LoadData());
+
+	LootSession first;
+	LootSession second;
+	LootSession otherSeed;
+	CHECK(SimulateSharded(game, s_testKills, std::nullopt, s_testSeed, s_testShardCount, first));
+	CHECK(SimulateSharded(game, s_testKills, std::nullopt, s_testSeed, s_testShardCount, second));
+	CHECK(SimulateSharded(game, s_testKills, std::nullopt, s_testSeed + 1, s_testShardCount, otherSeed));
+	CHECK(IsSameLootSession(first, second));
+	CHECK(!IsSameLootSession(first, otherSeed));
+}
+
+// What --shards runs: two games with the same seed report the same loot.
+TEST_CASE(ShardedGameBatchesAreRepeatable)
+{
+	LootSession sessions[2];
+	for (LootSession& session : sessions)
+	{
+		Game game;
+		game.SetSeed(s_testSeed);
+		game.SetShardCount(s_testShardCount);
+		CHECK(game.LoadData());
+		game.GetGameEvents().GetLootDroppedEvent().subscribe([&session](const LootSession& lootSession)
+		{
+			session = lootSession;
+		});
+		game.SlayBatchOfMonsters(s_testKills, std::nullopt);
+	}
+
+	CHECK(!sessions[0].monsters.empty());
+	CHECK(IsSameLootSession(sessions[0], sessions[1]));
+}
+
+//===============================================================
+
+} // namespace Tests
+} // namespace LootSimulator
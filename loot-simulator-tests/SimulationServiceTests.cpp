@@ -0,0 +1,183 @@
+//---------------------------------------------------------------
+//
+// SimulationServiceTests.cpp
+//
+
+#include "TestHarness.h"
+
+#include "Game.h"
+#include "SimulationService.h"
+
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace LootSimulator {
+namespace Tests {
+
+//===============================================================
+
+// Long enough that every client below submits inside one window.
+static const std::chrono::microseconds s_testCoalesceWindow = std::chrono::milliseconds(500);
+
+static const int32_t s_clientCount = 8;
+static const int32_t s_killsPerClient = 1000;
+
+// Submits the same request from s_clientCount threads at once.
+static std::vector<SimulationResult> SubmitFromClients(SimulationService& service, const SimulationRequest& request)
+{
+	std::vector<std::future<SimulationResult>> futures(s_clientCount);
+	std::vector<std::thread> clients;
+	for (size_t i = 0; i < futures.size(); ++i)
+	{
+		clients.emplace_back([&service, &request, &futures, i]()
+		{
+			futures[i] = service.Submit(request);
+		});
+	}
+	for (std::thread& client : clients)
+	{
+		client.join();
+	}
+
+	std::vector<SimulationResult> results;
+	for (std::future<SimulationResult>& future : futures)
+	{
+		results.push_back(future.get());
+	}
+	return results;
+}
+
+TEST_CASE(ConcurrentIdenticalRequestsShareOneRun)
+{
+	Game game;
+	game.SetSeed(1);
+	CHECK(game.LoadData());
+
+	SimulationService service(game, s_testCoalesceWindow);
+	service.Start();
+
+	SimulationRequest request;
+	request.type = MonsterType::DRAGON;
+	request.count = s_killsPerClient;
+	request.contentVersion = game.GetContentHash();
+	std::vector<SimulationResult> results = SubmitFromClients(service, request);
+	service.Stop();
+
+	CHECK(service.GetRunCount() == 1);
+	for (const SimulationResult& result : results)
+	{
+		CHECK(result.success);
+		CHECK(result.lootSession.monsters.size() == 1);
+		CHECK(result.lootSession.monsterCounts.count(MonsterType::DRAGON) == 1
+			&& result.lootSession.monsterCounts.at(MonsterType::DRAGON) == s_killsPerClient);
+	}
+}
+
+// Random mode settles each requester's monsters on its own, so every session has to add up
+// to exactly the kills it asked for.
+TEST_CASE(CoalescedRandomRequestsKeepTheirKillCounts)
+{
+	Game game;
+	game.SetSeed(1);
+	CHECK(game.LoadData());
+
+	SimulationService service(game, s_testCoalesceWindow);
+	service.Start();
+
+	SimulationRequest request;
+	request.count = s_killsPerClient;
+	request.contentVersion = game.GetContentHash();
+	std::vector<SimulationResult> results = SubmitFromClients(service, request);
+	service.Stop();
+
+	CHECK(service.GetRunCount() == 1);
+	for (const SimulationResult& result : results)
+	{
+		CHECK(result.success);
+		int64_t kills = 0;
+		for (const auto& monsterCount : result.lootSession.monsterCounts)
+		{
+			kills += monsterCount.second;
+		}
+		CHECK(kills == s_killsPerClient);
+	}
+}
+
+TEST_CASE(RequestsFailWhenNotRunning)
+{
+	Game game;
+	CHECK(game.LoadData());
+
+	SimulationService service(game, s_testCoalesceWindow);
+	SimulationRequest request;
+	request.type = MonsterType::DRAGON;
+	request.count = s_killsPerClient;
+	request.contentVersion = game.GetContentHash();
+	CHECK(!service.Submit(request).get().success);
+
+	service.Start();
+	service.Stop();
+	CHECK(!service.Submit(request).get().success);
+	CHECK(service.GetRunCount() == 0);
+}
+
+TEST_CASE(NegativeCountsFail)
+{
+	Game game;
+	CHECK(game.LoadData());
+
+	SimulationService service(game, s_testCoalesceWindow);
+	service.Start();
+
+	SimulationRequest request;
+	request.type = MonsterType::DRAGON;
+	request.count = -1;
+	request.contentVersion = game.GetContentHash();
+	SimulationResult result = service.Submit(request).get();
+	service.Stop();
+
+	CHECK(!result.success);
+	CHECK(service.GetRunCount() == 0);
+}
+
+TEST_CASE(RequestsFailWithoutContent)
+{
+	Game game;
+	SimulationService service(game, s_testCoalesceWindow);
+	service.Start();
+
+	SimulationRequest request;
+	request.type = MonsterType::DRAGON;
+	request.count = s_killsPerClient;
+	request.contentVersion = game.GetContentHash();
+	SimulationResult result = service.Submit(request).get();
+	service.Stop();
+
+	CHECK(!result.success);
+	CHECK(service.GetRunCount() == 0);
+}
+
+TEST_CASE(RequestsForStaleContentFail)
+{
+	Game game;
+	CHECK(game.LoadData());
+
+	SimulationService service(game, s_testCoalesceWindow);
+	service.Start();
+
+	SimulationRequest request;
+	request.count = s_killsPerClient;
+	request.contentVersion = game.GetContentHash() + 1;
+	SimulationResult result = service.Submit(request).get();
+	service.Stop();
+
+	CHECK(!result.success);
+	CHECK(service.GetRunCount() == 0);
+}
+
+//===============================================================
+
+} // namespace Tests
+} // namespace LootSimulator
@@ -0,0 +1,61 @@
+//---------------------------------------------------------------
+//
+// TestHarness.h
+//
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace LootSimulator {
+namespace Tests {
+
+//===============================================================
+
+using TestFunction = void (*)();
+
+struct TestCase
+{
+	const char* name = nullptr;
+	TestFunction function = nullptr;
+};
+
+// Every TEST_CASE in the program, in the order they were registered.
+std::vector<TestCase>& GetTestCases();
+
+// Marks the running test as failed and prints where.
+void ReportFailure(const char* fileName, int32_t lineNumber, const char* expression);
+
+struct TestRegistration
+{
+	TestRegistration(const char* name, TestFunction function)
+	{
+		GetTestCases().push_back({ name, function });
+	}
+};
+
+//===============================================================
+
+} // namespace Tests
+} // namespace LootSimulator
+
+// Defines a test that main runs. Names must be unique within a file.
+#define TEST_CASE(name)                                                                           \
+	static void name();                                                                           \
+	static LootSimulator::Tests::TestRegistration s_##name##Registration(#name, name);          \
+	static void name()
+
+// Failed checks are reported, and the test carries on.
+#define CHECK(expression)                                                                         \
+	do                                                                                            \
+	{                                                                                             \
+		if (!(expression))                                                                        \
+		{                                                                                         \
+			LootSimulator::Tests::ReportFailure(__FILE__, __LINE__, #expression);                 \
+		}                                                                                         \
+	} while (false)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+	CHECK(std::abs(static_cast<double>(actual) - static_cast<double>(expected)) <= (tolerance))
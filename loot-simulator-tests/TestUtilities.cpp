@@ -0,0 +1,64 @@
+//---------------------------------------------------------------
+//
+// TestUtilities.cpp
+//
+
+#include "TestUtilities.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace LootSimulator {
+namespace Tests {
+
+//===============================================================
+
+bool IsSameLootSession(const LootSession& left, const LootSession& right)
+{
+	return left.monsters == right.monsters
+		&& left.monsterCounts == right.monsterCounts
+		&& left.lootMap == right.lootMap
+		&& left.quantityTotals == right.quantityTotals;
+}
+
+double GetBinomialProbability(int64_t trials, double probability, int64_t count)
+{
+	double n = static_cast<double>(trials);
+	double k = static_cast<double>(count);
+	return std::exp(std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0)
+		+ k * std::log(probability) + (n - k) * std::log1p(-probability));
+}
+
+//---------------------------------------------------------------
+
+void ChiSquaredTest::AddBin(double expected, double observed)
+{
+	if (expected < 5.0)
+	{
+		m_pooledExpected += expected;
+		m_pooledObserved += observed;
+		return;
+	}
+
+	m_chiSquared += (observed - expected) * (observed - expected) / expected;
+	++m_binCount;
+}
+
+bool ChiSquaredTest::IsFit() const
+{
+	double chiSquared = m_chiSquared;
+	int32_t binCount = m_binCount;
+	if (m_pooledExpected > 0.0)
+	{
+		chiSquared += (m_pooledObserved - m_pooledExpected) * (m_pooledObserved - m_pooledExpected) / m_pooledExpected;
+		++binCount;
+	}
+
+	double degreesOfFreedom = std::max(binCount - 1, 1);
+	return chiSquared <= degreesOfFreedom + 5.0 * std::sqrt(2.0 * degreesOfFreedom);
+}
+
+//===============================================================
+
+} // namespace Tests
+} // namespace LootSimulator
@@ -0,0 +1,60 @@
+//---------------------------------------------------------------
+//
+// TestUtilities.h
+//
+
+#pragma once
+
+#include "TestHarness.h"
+
+#include "Game.h"
+#include "GameTypes.h"
+
+#include <cstdint>
+
+namespace LootSimulator {
+namespace Tests {
+
+//===============================================================
+
+// True if both sessions slew the same monsters and got exactly the same loot.
+bool IsSameLootSession(const LootSession& left, const LootSession& right);
+
+// Chance of exactly count successes in trials, each with chance probability. Worked out
+// through lgamma, so only good to about 1e-9 once trials are in the millions.
+double GetBinomialProbability(int64_t trials, double probability, int64_t count);
+
+// Pearson's chi-squared of observed counts against expected ones, with bins expected fewer
+// than 5 times pooled into one.
+class ChiSquaredTest
+{
+public:
+	void AddBin(double expected, double observed);
+
+	// Within 5 standard deviations of the degrees of freedom. Samples from the wrong
+	// distribution miss by orders of magnitude.
+	bool IsFit() const;
+
+private:
+	double m_chiSquared = 0.0;
+	double m_pooledExpected = 0.0;
+	double m_pooledObserved = 0.0;
+	int32_t m_binCount = 0;
+};
+
+// Loads the content and calls run(game, threadCount, report) on 1 and then 4 threads, for
+// checking that a simulation doesn't depend on how many threads it runs on.
+template <typename Report, typename Run>
+void RunOnOneAndFourThreads(Run run, Report& oneThread, Report& fourThreads)
+{
+	Game game;
+	CHECK(game.LoadData());
+
+	run(game, 1, oneThread);
+	run(game, 4, fourThreads);
+}
+
+//===============================================================
+
+} // namespace Tests
+} // namespace LootSimulator
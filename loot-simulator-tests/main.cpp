@@ -0,0 +1,57 @@
+//---------------------------------------------------------------
+//
+// main.cpp
+//
+
+#include "TestHarness.h"
+
+#include "Log.h"
+
+#include <iostream>
+
+namespace LootSimulator {
+namespace Tests {
+
+//===============================================================
+
+static int32_t s_failureCount = 0;
+
+std::vector<TestCase>& GetTestCases()
+{
+	static std::vector<TestCase> s_testCases;
+	return s_testCases;
+}
+
+void ReportFailure(const char* fileName, int32_t lineNumber, const char* expression)
+{
+	std::cout << "\t" << fileName << "(" << lineNumber << "): CHECK(" << expression << ") failed\n";
+	++s_failureCount;
+}
+
+//===============================================================
+
+} // namespace Tests
+} // namespace LootSimulator
+
+// Runs every test. Content is loaded from "..", so run it from loot-simulator-tests.
+int main()
+{
+	using namespace LootSimulator::Tests;
+
+	int32_t failedTestCount = 0;
+	for (const TestCase& testCase : GetTestCases())
+	{
+		int32_t previousFailureCount = s_failureCount;
+		testCase.function();
+
+		bool isPassed = s_failureCount == previousFailureCount;
+		failedTestCount += isPassed ? 0 : 1;
+		std::cout << (isPassed ? "PASS " : "FAIL ") << testCase.name << "\n";
+	}
+
+	std::cout << GetTestCases().size() - failedTestCount << " of " << GetTestCases().size()
+		<< " tests passed\n";
+	Logger::Shutdown();
+
+	return failedTestCount == 0 ? 0 : 1;
+}
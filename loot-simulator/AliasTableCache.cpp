@@ -0,0 +1,116 @@
+//---------------------------------------------------------------
+//
+// AliasTableCache.cpp
+//
+
+#include "AliasTableCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+
+namespace LootSimulator {
+
+//===============================================================
+
+AliasTable BuildAliasTable(const std::vector<double>& weights)
+{
+	size_t count = weights.size();
+	double weightTotal = std::accumulate(std::begin(weights), std::end(weights), 0.0);
+
+	AliasTable table;
+	table.probabilities.assign(count, 1.0f);
+	table.aliases.resize(count);
+	std::iota(std::begin(table.aliases), std::end(table.aliases), 0u);
+	if (weightTotal <= 0.0)
+	{
+		return table;
+	}
+
+	// Vose's method. Columns start at their weight scaled so the average is one; each
+	// short column is topped up by a tall one, which then becomes short itself if it drops
+	// below one.
+	std::vector<double> scaled(count);
+	std::vector<uint32_t> small;
+	std::vector<uint32_t> large;
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		scaled[i] = weights[i] * static_cast<double>(count) / weightTotal;
+		(scaled[i] < 1.0 ? small : large).push_back(i);
+	}
+
+	while (!small.empty() && !large.empty())
+	{
+		uint32_t less = small.back();
+		small.pop_back();
+		uint32_t more = large.back();
+		large.pop_back();
+
+		table.probabilities[less] = static_cast<float>(scaled[less]);
+		table.aliases[less] = more;
+		scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+		(scaled[more] < 1.0 ? small : large).push_back(more);
+	}
+	return table;
+}
+
+//---------------------------------------------------------------
+
+AliasTableCache::AliasTableCache(size_t capacity)
+	: m_shardCapacity(std::max<size_t>((capacity + s_shardCount - 1) / s_shardCount, 1))
+{
+	static std::atomic<uint64_t> s_nextId = 1;
+	m_id = s_nextId.fetch_add(1);
+}
+
+std::shared_ptr<const AliasTable> AliasTableCache::GetOrBuild(uint64_t key, const Builder& build)
+{
+	// Keys tend to be dense, so mix them before picking a shard.
+	uint64_t hash = key * 0x9e3779b97f4a7c15ull;
+	Shard& shard = m_shards[hash >> 60];
+
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	auto it = shard.index.find(key);
+	if (it != shard.index.end())
+	{
+		shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+		return it->second->second;
+	}
+
+	if (shard.entries.size() >= m_shardCapacity)
+	{
+		shard.index.erase(shard.entries.back().first);
+		shard.entries.pop_back();
+	}
+
+	shard.entries.emplace_front(key, std::make_shared<const AliasTable>(build()));
+	shard.index[key] = shard.entries.begin();
+	++shard.buildCount;
+	return shard.entries.front().second;
+}
+
+size_t AliasTableCache::GetSize() const
+{
+	size_t size = 0;
+	for (const Shard& shard : m_shards)
+	{
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		size += shard.entries.size();
+	}
+	return size;
+}
+
+uint64_t AliasTableCache::GetBuildCount() const
+{
+	uint64_t buildCount = 0;
+	for (const Shard& shard : m_shards)
+	{
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		buildCount += shard.buildCount;
+	}
+	return buildCount;
+}
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,89 @@
+//---------------------------------------------------------------
+//
+// AliasTableCache.h
+//
+
+#pragma once
+
+#include "Random.h"
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Walker/Vose alias table: column i keeps entry i with probabilities[i] and otherwise gives
+// entry aliases[i]. Picking is one draw whatever the size.
+struct AliasTable
+{
+	std::vector<float> probabilities;
+	std::vector<uint32_t> aliases;
+};
+
+// Builds the alias table for weights. All zero weights pick uniformly.
+AliasTable BuildAliasTable(const std::vector<double>& weights);
+
+// Index of one pick from table. Column from the high bits, the column's coin from the
+// low 24, so the column is what NextRandomInt would give.
+inline uint32_t PickAlias(const AliasTable& table, RngState& rng)
+{
+	uint64_t bits = NextRandom(rng);
+	size_t column = static_cast<size_t>(((bits >> 32) * table.probabilities.size()) >> 32);
+	float coin = static_cast<float>(bits & 0xffffff) * (1.0f / 16777216.0f);
+	return coin < table.probabilities[column] ? static_cast<uint32_t>(column) : table.aliases[column];
+}
+
+// Bounded map from a key to an alias table, built on first use. Safe to use from any
+// number of threads at once. Keys are spread over shards, each with its own lock and
+// least recently used order, so threads only contend when they want the same shard.
+// Tables are handed out shared, so one evicted while in use stays valid for its holder.
+class AliasTableCache
+{
+public:
+	using Builder = std::function<AliasTable()>;
+
+	explicit AliasTableCache(size_t capacity);
+
+	// The table for key, calling build to make it if it isn't cached. Building happens
+	// under the shard's lock, so each key is only built once while it stays cached.
+	std::shared_ptr<const AliasTable> GetOrBuild(uint64_t key, const Builder& build);
+
+	// Tables cached right now, and how many were built over the cache's life.
+	size_t GetSize() const;
+	uint64_t GetBuildCount() const;
+
+	// Different for every cache the program makes, and never 0, so tables looked up here
+	// can be remembered against it without a freed cache's address being mistaken for it.
+	uint64_t GetId() const { return m_id; }
+
+private:
+	static const size_t s_shardCount = 16;
+
+	using Entry = std::pair<uint64_t, std::shared_ptr<const AliasTable>>;
+
+	struct Shard
+	{
+		mutable std::mutex mutex;
+
+		// Most recently used first.
+		std::list<Entry> entries;
+		std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+		uint64_t buildCount = 0;
+	};
+
+	uint64_t m_id = 0;
+	size_t m_shardCapacity = 1;
+	Shard m_shards[s_shardCount];
+};
+
+//===============================================================
+
+} // namespace LootSimulator
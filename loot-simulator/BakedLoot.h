@@ -0,0 +1,251 @@
+//---------------------------------------------------------------
+//
+// BakedLoot.h
+//
+
+#pragma once
+
+#include "GameTypes.h"
+#include "LootModel.h"
+#include "Random.h"
+#include "StringPool.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Content compiled into the binary by generate_enum_bindings.py --baked. Every table and
+// monster is its own type, sized at compile time, so rolling one unrolls and inlines
+// into straight line code with no data loading at all.
+
+// How baked tables pick a treasure. ROULETTE makes exactly the draws LootModel does, so
+// results match a build that loads JSON. ALIAS is constant time per roll but draws
+// differently.
+enum class BakedSampler
+{
+	ROULETTE,
+	ALIAS
+};
+
+template <size_t N>
+struct BakedTable
+{
+	const char* path;
+
+	// Chance of being the one table that drops, for exclusive tables.
+	float dropRate;
+
+	// Weights summed in data order as floats, the way LootModel sums them.
+	float weightTotal;
+
+	std::array<TreasureType, N> types;
+	std::array<float, N> weights;
+	std::array<float, N> cumulativeWeights;
+
+	// Walker/Vose alias table: column i keeps types[i] with aliasProbabilities[i] and
+	// otherwise gives types[aliases[i]].
+	std::array<float, N> aliasProbabilities;
+	std::array<uint32_t, N> aliases;
+
+	// Quantity range of each treasure. Rolled by LootModel, not here.
+	std::array<int32_t, N> minQuantities;
+	std::array<int32_t, N> maxQuantities;
+};
+
+// Tables are ordered exclusive first, then guaranteed, as LootModel orders them.
+template <size_t ExclusiveCount, typename... Tables>
+struct BakedMonster
+{
+	MonsterType type;
+	const char* name;
+	std::tuple<Tables...> tables;
+};
+
+template <size_t ExclusiveCount, typename... Tables>
+constexpr BakedMonster<ExclusiveCount, Tables...> MakeBakedMonster(MonsterType type, const char* name,
+	const Tables&... tables)
+{
+	return { type, name, std::tuple<Tables...>(tables...) };
+}
+
+// One monster's spawn weight in one zone. Zones are listed in data order, each zone's
+// monsters together.
+struct BakedEncounter
+{
+	const char* zone;
+	MonsterType type;
+	float weight;
+};
+
+//---------------------------------------------------------------
+// Implementation details for RollBakedLoot.
+
+namespace Detail {
+
+template <BakedSampler Sampler, size_t N>
+inline TreasureType RollBakedTable(const BakedTable<N>& table, RngState& rng)
+{
+	if constexpr (Sampler == BakedSampler::ALIAS)
+	{
+		// High bits pick the column, the low 24 flip the column's coin.
+		uint64_t bits = NextRandom(rng);
+		size_t column = static_cast<size_t>(((bits >> 32) * N) >> 32);
+		float coin = static_cast<float>(bits & 0xffffff) * (1.0f / 16777216.0f);
+		return coin < table.aliasProbabilities[column]
+			? table.types[column]
+			: table.types[table.aliases[column]];
+	}
+	else
+	{
+		float randomNumber = NextRandomFloat(rng, 0.0f, table.weightTotal);
+		for (size_t i = 0; i < N; ++i)
+		{
+			if (randomNumber < table.weights[i])
+			{
+				return table.types[i];
+			}
+			randomNumber -= table.weights[i];
+		}
+
+		// Rounding can carry the roll past the end, onto the last entry that can drop.
+		for (size_t i = N; i-- > 0;)
+		{
+			if (table.weights[i] > 0.0f)
+			{
+				return table.types[i];
+			}
+		}
+		return TreasureType::NONE;
+	}
+}
+
+template <BakedSampler Sampler, size_t Index, size_t ExclusiveCount, typename... Tables>
+inline bool RollExclusiveTable(const BakedMonster<ExclusiveCount, Tables...>& monster, float randomNumber,
+	RngState& rng, TreasureType* out)
+{
+	if constexpr (Index == ExclusiveCount)
+	{
+		return false;
+	}
+	else
+	{
+		const auto& table = std::get<Index>(monster.tables);
+		if (randomNumber < table.dropRate)
+		{
+			out[0] = RollBakedTable<Sampler>(table, rng);
+			return true;
+		}
+		return RollExclusiveTable<Sampler, Index + 1>(monster, randomNumber - table.dropRate, rng, out);
+	}
+}
+
+template <BakedSampler Sampler, size_t ExclusiveCount, typename... Tables, size_t... Indices>
+inline size_t RollGuaranteedTables(const BakedMonster<ExclusiveCount, Tables...>& monster, RngState& rng,
+	TreasureType* out, std::index_sequence<Indices...>)
+{
+	size_t dropCount = 0;
+	((out[dropCount++] = RollBakedTable<Sampler>(std::get<ExclusiveCount + Indices>(monster.tables), rng)), ...);
+	return dropCount;
+}
+
+} // namespace Detail
+
+//---------------------------------------------------------------
+
+// Rolls one kill of the given baked monster into out, which must hold s_maxDropsPerKill.
+template <BakedSampler Sampler = BakedSampler::ROULETTE, size_t ExclusiveCount, typename... Tables>
+inline size_t RollBakedMonster(const BakedMonster<ExclusiveCount, Tables...>& monster, RngState& rng,
+	TreasureType* out)
+{
+	static_assert(sizeof...(Tables) - ExclusiveCount <= s_maxDropsPerKill, "Too many guaranteed tables.");
+
+	// Either one exclusive table drops, or every guaranteed one does.
+	float randomNumber = NextRandomFloat(rng, 0.0f, 1.0f);
+	if (Detail::RollExclusiveTable<Sampler, 0>(monster, randomNumber, rng, out))
+	{
+		return 1;
+	}
+	return Detail::RollGuaranteedTables<Sampler>(monster, rng, out,
+		std::make_index_sequence<sizeof...(Tables) - ExclusiveCount>());
+}
+
+// Rolls one kill of type out of a tuple of baked monsters. Unknown types drop nothing.
+template <BakedSampler Sampler = BakedSampler::ROULETTE, typename... Monsters>
+inline size_t RollBakedLoot(const std::tuple<Monsters...>& monsters, MonsterType type, RngState& rng,
+	TreasureType (&out)[s_maxDropsPerKill])
+{
+	size_t dropCount = 0;
+	std::apply([&](const auto&... monster)
+	{
+		((monster.type == type && (dropCount = RollBakedMonster<Sampler>(monster, rng, out), true)) || ...);
+	}, monsters);
+	return dropCount;
+}
+
+// Expands baked monsters back into the regular data model, as if loaded from JSON.
+template <typename... Monsters>
+inline void CreateBakedMonsters(const std::tuple<Monsters...>& monsters, const char* const* treasureNames,
+	StringPool& strings, std::set<Monster>& out)
+{
+	std::apply([&](const auto&... monster)
+	{
+		auto addMonster = [&](const auto& bakedMonster)
+		{
+			Monster m;
+			m.type = bakedMonster.type;
+			m.nameId = strings.Intern(bakedMonster.name);
+			std::apply([&](const auto&... bakedTable)
+			{
+				auto addTable = [&](const auto& table)
+				{
+					LootTable lootTable;
+					lootTable.path = table.path;
+					lootTable.dropRate = table.dropRate;
+					for (size_t i = 0; i < table.types.size(); ++i)
+					{
+						Treasure treasure;
+						treasure.type = table.types[i];
+						treasure.nameId = strings.Intern(treasureNames[static_cast<size_t>(table.types[i])]);
+						treasure.dropRate = table.weights[i];
+						treasure.minQuantity = table.minQuantities[i];
+						treasure.maxQuantity = table.maxQuantities[i];
+						lootTable.treasures.push_back(treasure);
+					}
+					m.tables.push_back(lootTable);
+				};
+				(addTable(bakedTable), ...);
+			}, bakedMonster.tables);
+			out.insert(m);
+		};
+		(addMonster(monster), ...);
+	}, monsters);
+}
+
+// Expands baked encounters back into one table per zone, as if loaded from JSON.
+template <size_t N>
+inline void CreateBakedEncounterTables(const std::array<BakedEncounter, N>& encounters, StringPool& strings,
+	std::vector<EncounterTable>& out)
+{
+	for (const BakedEncounter& encounter : encounters)
+	{
+		StringId zoneId = strings.Intern(encounter.zone);
+		if (out.empty() || out.back().zoneId != zoneId)
+		{
+			out.emplace_back();
+			out.back().zoneId = zoneId;
+		}
+		out.back().encounters.push_back({ encounter.type, encounter.weight });
+	}
+}
+
+//===============================================================
+
+} // namespace LootSimulator
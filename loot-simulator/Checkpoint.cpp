@@ -0,0 +1,126 @@
+//---------------------------------------------------------------
+//
+// Checkpoint.cpp
+//
+
+#include "Checkpoint.h"
+
+#include "Log.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace LootSimulator {
+
+//===============================================================
+
+static const uint32_t s_checkpointMagic = 0x4c534350; // "LSCP"
+static const uint32_t s_checkpointVersion = 2;
+
+// Written before the checkpoint itself so files from other builds are rejected.
+struct CheckpointHeader
+{
+	uint32_t magic = s_checkpointMagic;
+	uint32_t version = s_checkpointVersion;
+	uint32_t numMonsterTypes = static_cast<uint32_t>(s_numMonsterTypes);
+	uint32_t numTreasureTypes = static_cast<uint32_t>(s_numTreasureTypes);
+	uint64_t checkpointSize = sizeof(BatchCheckpoint);
+};
+
+static_assert(std::is_trivially_copyable<BatchCheckpoint>::value,
+	"Checkpoints are written out as raw bytes.");
+
+// Asks the OS to put the file's data on disk.
+static bool SyncFile(std::FILE* file)
+{
+#ifdef _WIN32
+	return _commit(_fileno(file)) == 0;
+#else
+	return fsync(fileno(file)) == 0;
+#endif
+}
+
+//---------------------------------------------------------------
+
+bool SaveCheckpoint(const std::string& path, const BatchCheckpoint& checkpoint)
+{
+	std::string tempPath = path + ".tmp";
+	{
+		std::FILE* file = std::fopen(tempPath.c_str(), "wb");
+		if (!file)
+		{
+			LOG_ERROR("Could not open checkpoint file. file={}", tempPath);
+			return false;
+		}
+
+		// Flushed to disk before the rename, so a crash can't leave a renamed but empty file.
+		CheckpointHeader header;
+		bool isWritten = std::fwrite(&header, sizeof(header), 1, file) == 1
+			&& std::fwrite(&checkpoint, sizeof(checkpoint), 1, file) == 1
+			&& std::fflush(file) == 0
+			&& SyncFile(file);
+		bool isClosed = std::fclose(file) == 0;
+		if (!isWritten || !isClosed)
+		{
+			LOG_ERROR("Could not write checkpoint file. file={}", tempPath);
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(tempPath, path, error);
+	if (error)
+	{
+		LOG_ERROR("Could not replace checkpoint file. file={} error={}", path, error.message());
+		return false;
+	}
+	return true;
+}
+
+bool LoadCheckpoint(const std::string& path, BatchCheckpoint& checkpoint)
+{
+	std::ifstream fileStream(path, std::ios::binary);
+	if (!fileStream.is_open())
+	{
+		LOG_ERROR("Could not open checkpoint file. file={}", path);
+		return false;
+	}
+
+	CheckpointHeader expected;
+	CheckpointHeader header;
+	fileStream.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!fileStream || header.magic != expected.magic || header.version != expected.version
+		|| header.numMonsterTypes != expected.numMonsterTypes
+		|| header.numTreasureTypes != expected.numTreasureTypes
+		|| header.checkpointSize != expected.checkpointSize)
+	{
+		LOG_ERROR("Checkpoint file is from a different build. file={}", path);
+		return false;
+	}
+
+	fileStream.read(reinterpret_cast<char*>(&checkpoint), sizeof(checkpoint));
+	bool isRandom = checkpoint.type == MonsterType::NONE;
+	bool isKnownType = isRandom || static_cast<size_t>(checkpoint.type) < s_numMonsterTypes;
+	int64_t typeTotal = std::accumulate(std::begin(checkpoint.typeCounts), std::end(checkpoint.typeCounts), int64_t(0));
+	if (!fileStream || !isKnownType || checkpoint.remainingCount < 0 || checkpoint.remainingCount > checkpoint.totalCount
+		|| (isRandom && typeTotal != checkpoint.totalCount))
+	{
+		LOG_ERROR("Checkpoint file is truncated or corrupt. file={}", path);
+		return false;
+	}
+	return true;
+}
+
+//===============================================================
+
+} // namespace LootSimulator
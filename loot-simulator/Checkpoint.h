@@ -0,0 +1,50 @@
+//---------------------------------------------------------------
+//
+// Checkpoint.h
+//
+
+#pragma once
+
+#include "LootCounters.h"
+#include "Random.h"
+
+#include <string>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Everything needed to pick a batch back up exactly where it stopped.
+struct BatchCheckpoint
+{
+	// Content the batch was running against. See Game::GetContentHash.
+	uint64_t contentHash = 0;
+
+	// Monster being slain, NONE for random mode.
+	MonsterType type = MonsterType::NONE;
+
+	int64_t totalCount = 0;
+	int64_t remainingCount = 0;
+
+	// Random mode only: how many of each monster type the whole batch spawns, drawn once
+	// when it starts. Chunks take them in type order, so where the batch is cut doesn't
+	// change what it draws.
+	int64_t typeCounts[s_numMonsterTypes] = {};
+
+	// Stream position after the last completed kill.
+	RngState rng;
+
+	// Everything that dropped so far.
+	LootCounters counters;
+};
+
+// Writes next to path first and then swaps the file in, so a crash mid save leaves the
+// previous checkpoint intact.
+bool SaveCheckpoint(const std::string& path, const BatchCheckpoint& checkpoint);
+
+// Fails on anything that isn't a checkpoint written by this build.
+bool LoadCheckpoint(const std::string& path, BatchCheckpoint& checkpoint);
+
+//===============================================================
+
+} // namespace LootSimulator
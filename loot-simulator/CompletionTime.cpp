@@ -0,0 +1,295 @@
+//---------------------------------------------------------------
+//
+// CompletionTime.cpp
+//
+
+#include "CompletionTime.h"
+
+#include "AliasTableCache.h"
+#include "LootModel.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Simulated players per block.
+static const int64_t s_completionBlockSize = 1024;
+
+using MaskChances = std::vector<std::pair<uint64_t, double>>;
+
+static bool HasOddBitCount(uint64_t mask)
+{
+	bool isOdd = false;
+	for (; mask != 0; mask &= mask - 1)
+	{
+		isOdd = !isOdd;
+	}
+	return isOdd;
+}
+
+// Masks one kill drops, mixing every type by encounter chance for random kills.
+static MaskChances GetKillMaskChances(const LootModel& lootModel, std::optional<MonsterType> type,
+	const std::vector<TreasureType>& treasures, uint32_t magicFindBucket)
+{
+	MaskChances maskChances;
+	if (type.has_value())
+	{
+		lootModel.GetDropMaskChances(type.value(), treasures, magicFindBucket, maskChances);
+		return maskChances;
+	}
+
+	std::map<uint64_t, double> killMasks;
+	MaskChances typeMasks;
+	for (size_t m = 0; m < s_numMonsterTypes; ++m)
+	{
+		MonsterType monsterType = static_cast<MonsterType>(m);
+		double encounterChance = lootModel.GetEncounterChance(monsterType);
+		if (encounterChance <= 0.0)
+		{
+			continue;
+		}
+
+		lootModel.GetDropMaskChances(monsterType, treasures, magicFindBucket, typeMasks);
+		for (const std::pair<uint64_t, double>& mask : typeMasks)
+		{
+			killMasks[mask.first] += encounterChance * mask.second;
+		}
+	}
+	maskChances.assign(killMasks.begin(), killMasks.end());
+	return maskChances;
+}
+
+static void GetExactCompletionTime(const MaskChances& maskChances, size_t setSize, CompletionReport& report)
+{
+	TRACE_SCOPE("GetExactCompletionTime");
+
+	size_t stateCount = size_t(1) << setSize;
+	uint64_t fullMask = stateCount - 1;
+
+	// Chance a kill drops nothing outside each subset: the chance of every mask summed over
+	// the subsets of each subset, one bit at a time.
+	std::vector<double> insideChances(stateCount, 0.0);
+	for (const std::pair<uint64_t, double>& mask : maskChances)
+	{
+		insideChances[mask.first] += mask.second;
+	}
+	for (size_t bit = 0; bit < setSize; ++bit)
+	{
+		for (uint64_t state = 0; state < stateCount; ++state)
+		{
+			if (state & (uint64_t(1) << bit))
+			{
+				insideChances[state] += insideChances[state ^ (uint64_t(1) << bit)];
+			}
+		}
+	}
+
+	// Expected kills left from every owned subset. Kills only add to what is owned, so
+	// working down from the full set has every later state done already.
+	std::vector<double> expectedKills(stateCount, 0.0);
+	for (uint64_t state = fullMask; state-- > 0;)
+	{
+		// Summing the chance of progress directly keeps it precise when it is tiny.
+		double kills = 1.0;
+		double progressChance = 0.0;
+		for (const std::pair<uint64_t, double>& mask : maskChances)
+		{
+			if (mask.first & ~state)
+			{
+				kills += mask.second * expectedKills[state | mask.first];
+				progressChance += mask.second;
+			}
+		}
+		expectedKills[state] = kills / progressChance;
+	}
+	report.expectedKills = expectedKills[0];
+
+	// Chance the set is done within kills: every missed subset's chance of nothing from it
+	// over that many kills, added and taken away by inclusion-exclusion.
+	auto getCompleteChance = [&](int64_t kills)
+	{
+		double chance = 0.0;
+		for (uint64_t missed = 0; missed < stateCount; ++missed)
+		{
+			double term = std::pow(insideChances[fullMask ^ missed], static_cast<double>(kills));
+			chance += HasOddBitCount(missed) ? -term : term;
+		}
+		return chance;
+	};
+
+	for (size_t i = 0; i < std::size(s_completionPercentiles); ++i)
+	{
+		double fraction = s_completionPercentiles[i] / 100.0;
+
+		int64_t high = 1;
+		while (getCompleteChance(high) < fraction)
+		{
+			high *= 2;
+		}
+
+		int64_t low = high / 2;
+		while (high - low > 1)
+		{
+			int64_t middle = low + (high - low) / 2;
+			(getCompleteChance(middle) < fraction ? low : high) = middle;
+		}
+		report.percentileKills[i] = high;
+	}
+}
+
+static void SimulateCompletionTime(const MaskChances& maskChances, uint64_t fullMask, int64_t playerCount,
+	int32_t threadCount, uint64_t seed, CompletionReport& report)
+{
+	TRACE_SCOPE("SimulateCompletionTime");
+
+	std::vector<double> weights;
+	std::vector<uint64_t> masks;
+	for (const std::pair<uint64_t, double>& mask : maskChances)
+	{
+		masks.push_back(mask.first);
+		weights.push_back(mask.second);
+	}
+	AliasTable killMasks = BuildAliasTable(weights);
+
+	int64_t blockCount = (playerCount + s_completionBlockSize - 1) / s_completionBlockSize;
+	std::atomic<int64_t> nextBlock = 0;
+	std::mutex mergeMutex;
+	std::vector<int64_t> completionKills;
+	completionKills.reserve(static_cast<size_t>(playerCount));
+
+	auto runThread = [&]()
+	{
+		std::vector<int64_t> threadKills;
+		std::vector<uint64_t> owned;
+		RngState blockRng = SeedRng(seed);
+		int64_t blockRngIndex = 0;
+
+		for (int64_t block = nextBlock.fetch_add(1); block < blockCount; block = nextBlock.fetch_add(1))
+		{
+			for (; blockRngIndex < block; ++blockRngIndex)
+			{
+				JumpRng(blockRng);
+			}
+			RngState rng = blockRng;
+
+			size_t blockPlayers = static_cast<size_t>(std::min(s_completionBlockSize,
+				playerCount - block * s_completionBlockSize));
+			owned.assign(blockPlayers, 0);
+
+			// Every unfinished player of the block takes one kill per pass. Finished ones are
+			// swapped to the end, so passes only touch players still collecting.
+			size_t activeCount = blockPlayers;
+			int64_t pass = 0;
+			while (activeCount > 0)
+			{
+				++pass;
+				for (size_t i = 0; i < activeCount; ++i)
+				{
+					owned[i] |= masks[PickAlias(killMasks, rng)];
+				}
+
+				for (size_t i = 0; i < activeCount;)
+				{
+					if (owned[i] == fullMask)
+					{
+						threadKills.push_back(pass);
+						--activeCount;
+						std::swap(owned[i], owned[activeCount]);
+					}
+					else
+					{
+						++i;
+					}
+				}
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(mergeMutex);
+		completionKills.insert(completionKills.end(), threadKills.begin(), threadKills.end());
+	};
+
+	std::vector<std::thread> threads;
+	for (int32_t i = 1; i < threadCount; ++i)
+	{
+		threads.emplace_back(runThread);
+	}
+	runThread();
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	// Sorted, so threads finishing in any order give the same report.
+	std::sort(completionKills.begin(), completionKills.end());
+
+	double totalKills = 0.0;
+	for (int64_t kill : completionKills)
+	{
+		totalKills += static_cast<double>(kill);
+	}
+	report.expectedKills = totalKills / static_cast<double>(completionKills.size());
+
+	for (size_t i = 0; i < std::size(s_completionPercentiles); ++i)
+	{
+		double fraction = s_completionPercentiles[i] / 100.0;
+		size_t rank = std::max<size_t>(
+			static_cast<size_t>(std::ceil(fraction * static_cast<double>(completionKills.size()))), 1);
+		report.percentileKills[i] = completionKills[rank - 1];
+	}
+}
+
+//---------------------------------------------------------------
+
+CompletionReport GetCompletionTime(const LootModel& lootModel, std::optional<MonsterType> type,
+	const std::vector<TreasureType>& treasures, uint32_t magicFindBucket, int64_t playerCount,
+	int32_t threadCount, uint64_t seed)
+{
+	TRACE_SCOPE("GetCompletionTime");
+
+	CompletionReport report;
+	if (treasures.empty() || treasures.size() > s_maxCompletionSetSize || playerCount <= 0)
+	{
+		return report;
+	}
+
+	MaskChances maskChances = GetKillMaskChances(lootModel, type, treasures, magicFindBucket);
+
+	uint64_t fullMask = treasures.size() == 64 ? ~uint64_t(0) : (uint64_t(1) << treasures.size()) - 1;
+	uint64_t droppable = 0;
+	for (const std::pair<uint64_t, double>& mask : maskChances)
+	{
+		droppable |= mask.first;
+	}
+
+	report.canComplete = droppable == fullMask;
+	if (!report.canComplete)
+	{
+		return report;
+	}
+
+	if (treasures.size() <= s_maxExactSetSize)
+	{
+		report.isExact = true;
+		GetExactCompletionTime(maskChances, treasures.size(), report);
+	}
+	else
+	{
+		report.playerCount = playerCount;
+		SimulateCompletionTime(maskChances, fullMask, playerCount, threadCount, seed, report);
+	}
+	return report;
+}
+
+//===============================================================
+
+} // namespace LootSimulator
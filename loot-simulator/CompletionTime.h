@@ -0,0 +1,61 @@
+//---------------------------------------------------------------
+//
+// CompletionTime.h
+//
+
+#pragma once
+
+#include "GameTypes.h"
+
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+class LootModel;
+
+// Sets up to this size are worked out exactly. Larger ones are simulated.
+static const size_t s_maxExactSetSize = 16;
+
+// Sets can't be larger than this.
+static const size_t s_maxCompletionSetSize = 64;
+
+// Percentiles every completion report has kills for.
+static const double s_completionPercentiles[] = { 10.0, 50.0, 90.0, 99.0 };
+
+// How many kills it takes to own every treasure of a set.
+struct CompletionReport
+{
+	// Whether every treasure of the set can drop at all. Nothing else is filled in if not.
+	bool canComplete = false;
+
+	// Worked out exactly rather than estimated from simulated players.
+	bool isExact = false;
+
+	// Players simulated. 0 when exact.
+	int64_t playerCount = 0;
+
+	double expectedKills = 0.0;
+
+	// Kills by which each of s_completionPercentiles of players own the whole set.
+	int64_t percentileKills[std::size(s_completionPercentiles)] = {};
+};
+
+// Kills of type, or random kills if it isn't set, until one player owns every treasure in
+// treasures, in the given magic find bucket. Each kill's chances come from the compiled
+// tables, including kills that drop several of the set at once.
+// Small sets are exact: the expected kills come from dynamic programming over which
+// subset is owned, and percentiles from inclusion-exclusion over the subsets missed.
+// Larger sets simulate playerCount players on threadCount threads, each advancing a block
+// of owned masks a kill at a time. Block i always draws from substream i of seed.
+CompletionReport GetCompletionTime(const LootModel& lootModel, std::optional<MonsterType> type,
+	const std::vector<TreasureType>& treasures, uint32_t magicFindBucket, int64_t playerCount,
+	int32_t threadCount, uint64_t seed);
+
+//===============================================================
+
+} // namespace LootSimulator
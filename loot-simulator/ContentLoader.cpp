@@ -0,0 +1,1229 @@
+//---------------------------------------------------------------
+//
+// ContentLoader.cpp
+//
+
+#include "ContentLoader.h"
+
+#include "MappedFile.h"
+#include "Trace.h"
+#include "nlohmann/json/json.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <unordered_map>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+using nlohmann::json;
+
+static const char* s_monsterDataPath = "resources/monsters.json";
+static const char* s_encounterDataPath = "resources/encounters.json";
+static const char* s_pityDataPath = "resources/pity-rules.json";
+static const char* s_valueDataPath = "resources/treasure-values.json";
+
+// The shortest item a loot table can hold, {"type":"","name":"","dropRate":0}. Bounds how
+// much numItems may reserve up front.
+static const size_t s_minItemBytes = 34;
+
+static std::string GetContentPath(const std::string& rootDirectory, const std::string& path)
+{
+	if (rootDirectory.empty())
+	{
+		return path;
+	}
+
+	std::string contentPath = rootDirectory;
+	if (contentPath.back() != '/' && contentPath.back() != '\\')
+	{
+		contentPath += '/';
+	}
+	contentPath.append(path);
+	return contentPath;
+}
+
+//---------------------------------------------------------------
+// SAX handlers. Monster data and loot tables are read straight into Monster, LootTable
+// and Treasure as the parser walks the file, so no DOM is built; the only allocations are the vectors the
+// content keeps and the first copy of each name in the string pool. Each handler is a
+// small state machine over its file's schema and fails on anything the schema doesn't
+// allow.
+
+// Events every schema treats the same. Handler supplies the rest, plus OnNumber.
+template <typename Handler>
+class ContentHandler
+{
+public:
+	bool null()
+	{
+		return Fail("Unexpected null.");
+	}
+
+	bool boolean(bool)
+	{
+		return Fail("Unexpected boolean.");
+	}
+
+	bool number_integer(json::number_integer_t value)
+	{
+		return static_cast<Handler*>(this)->OnNumber(static_cast<double>(value));
+	}
+
+	bool number_unsigned(json::number_unsigned_t value)
+	{
+		return static_cast<Handler*>(this)->OnNumber(static_cast<double>(value));
+	}
+
+	bool number_float(json::number_float_t value, const json::string_t&)
+	{
+		return static_cast<Handler*>(this)->OnNumber(value);
+	}
+
+	bool parse_error(size_t, const std::string&, const json::exception& e)
+	{
+		return Fail(e.what());
+	}
+
+	const std::string& GetError() const { return m_error; }
+
+protected:
+	bool Fail(const std::string& error)
+	{
+		m_error = error;
+		return false;
+	}
+
+	// Marks field as read, failing the second time so duplicate keys can't override.
+	bool ReadField(uint32_t& fields, uint32_t field, const std::string& key)
+	{
+		if ((fields & field) != 0)
+		{
+			return Fail("Duplicate key. key=" + key);
+		}
+		fields |= field;
+		return true;
+	}
+
+	bool HasFields(uint32_t fields, uint32_t required, const char* objectName)
+	{
+		return (fields & required) == required
+			|| Fail(std::string("Missing required key in ") + objectName + ".");
+	}
+
+private:
+	std::string m_error;
+};
+
+// monsters.json: { "numMonsterTypes", "monsters": [{ "name", "type", "tables": [{ "path", "dropRate"? }] }] }
+class MonsterDataHandler : public ContentHandler<MonsterDataHandler>
+{
+public:
+	MonsterDataHandler(std::vector<Monster>& monsters, StringPool& strings)
+		: m_monsters(monsters)
+		, m_strings(strings)
+	{
+	}
+
+	bool IsDone() const { return m_state == State::DONE; }
+
+	bool start_object(size_t)
+	{
+		switch (m_state)
+		{
+		case State::START:
+			m_state = State::ROOT;
+			return true;
+		case State::MONSTERS:
+			m_monsters.emplace_back();
+			m_monsterFields = 0;
+			m_state = State::MONSTER;
+			return true;
+		case State::TABLES:
+			m_monsters.back().tables.emplace_back();
+			m_tableFields = 0;
+			m_state = State::TABLE;
+			return true;
+		default:
+			return Fail("Unexpected object.");
+		}
+	}
+
+	bool end_object()
+	{
+		switch (m_state)
+		{
+		case State::ROOT:
+			m_state = State::DONE;
+			return HasFields(m_rootFields, MONSTERS_FIELD, "monster data");
+		case State::MONSTER:
+			m_state = State::MONSTERS;
+			return HasFields(m_monsterFields, NAME_FIELD | TYPE_FIELD | TABLES_FIELD, "monster");
+		case State::TABLE:
+			m_state = State::TABLES;
+			return HasFields(m_tableFields, PATH_FIELD, "loot table");
+		default:
+			return Fail("Unexpected end of object.");
+		}
+	}
+
+	bool start_array(size_t)
+	{
+		switch (m_state)
+		{
+		case State::MONSTERS_VALUE:
+			m_state = State::MONSTERS;
+			return true;
+		case State::TABLES_VALUE:
+			m_state = State::TABLES;
+			return true;
+		default:
+			return Fail("Unexpected array.");
+		}
+	}
+
+	bool end_array()
+	{
+		switch (m_state)
+		{
+		case State::MONSTERS:
+			m_state = State::ROOT;
+			return true;
+		case State::TABLES:
+			m_state = State::MONSTER;
+			return true;
+		default:
+			return Fail("Unexpected end of array.");
+		}
+	}
+
+	bool key(json::string_t& key)
+	{
+		switch (m_state)
+		{
+		case State::ROOT:
+			if (key == "numMonsterTypes")
+			{
+				m_state = State::NUM_MONSTER_TYPES;
+				return ReadField(m_rootFields, NUM_MONSTER_TYPES_FIELD, key);
+			}
+			if (key == "monsters")
+			{
+				m_state = State::MONSTERS_VALUE;
+				return ReadField(m_rootFields, MONSTERS_FIELD, key);
+			}
+			return Fail("Unknown key in monster data. key=" + key);
+		case State::MONSTER:
+			if (key == "name")
+			{
+				m_state = State::MONSTER_NAME;
+				return ReadField(m_monsterFields, NAME_FIELD, key);
+			}
+			if (key == "type")
+			{
+				m_state = State::MONSTER_TYPE;
+				return ReadField(m_monsterFields, TYPE_FIELD, key);
+			}
+			if (key == "tables")
+			{
+				m_state = State::TABLES_VALUE;
+				return ReadField(m_monsterFields, TABLES_FIELD, key);
+			}
+			return Fail("Unknown key in monster. key=" + key);
+		case State::TABLE:
+			if (key == "path")
+			{
+				m_state = State::TABLE_PATH;
+				return ReadField(m_tableFields, PATH_FIELD, key);
+			}
+			if (key == "dropRate")
+			{
+				m_state = State::TABLE_DROP_RATE;
+				return ReadField(m_tableFields, DROP_RATE_FIELD, key);
+			}
+			return Fail("Unknown key in loot table. key=" + key);
+		default:
+			return Fail("Unexpected key. key=" + key);
+		}
+	}
+
+	bool string(json::string_t& value)
+	{
+		switch (m_state)
+		{
+		case State::MONSTER_NAME:
+			m_monsters.back().nameId = m_strings.Intern(value);
+			m_state = State::MONSTER;
+			return true;
+		case State::MONSTER_TYPE:
+			m_monsters.back().type = GetMonsterTypeFromId(value);
+			m_state = State::MONSTER;
+			return m_monsters.back().type != MonsterType::NONE
+				|| Fail("Unknown monster type. type=" + value);
+		case State::TABLE_PATH:
+			m_monsters.back().tables.back().path = std::move(value);
+			m_state = State::TABLE;
+			return true;
+		default:
+			return Fail("Unexpected string. value=" + value);
+		}
+	}
+
+	bool OnNumber(double value)
+	{
+		switch (m_state)
+		{
+		case State::NUM_MONSTER_TYPES:
+			// Older content still has this. The monster list is what counts.
+			m_state = State::ROOT;
+			return true;
+		case State::TABLE_DROP_RATE:
+			m_monsters.back().tables.back().dropRate = static_cast<float>(value);
+			m_state = State::TABLE;
+			return (value >= 0.0 && value <= 1.0)
+				|| Fail("Loot table drop rate must be between 0 and 1.");
+		default:
+			return Fail("Unexpected number.");
+		}
+	}
+
+private:
+	enum struct State
+	{
+		START,
+		ROOT,
+		NUM_MONSTER_TYPES,
+		MONSTERS_VALUE,
+		MONSTERS,
+		MONSTER,
+		MONSTER_NAME,
+		MONSTER_TYPE,
+		TABLES_VALUE,
+		TABLES,
+		TABLE,
+		TABLE_PATH,
+		TABLE_DROP_RATE,
+		DONE
+	};
+
+	// Bits of m_rootFields, m_monsterFields and m_tableFields.
+	enum : uint32_t
+	{
+		NUM_MONSTER_TYPES_FIELD = 1 << 0,
+		MONSTERS_FIELD = 1 << 1,
+		NAME_FIELD = 1 << 0,
+		TYPE_FIELD = 1 << 1,
+		TABLES_FIELD = 1 << 2,
+		PATH_FIELD = 1 << 0,
+		DROP_RATE_FIELD = 1 << 1
+	};
+
+	std::vector<Monster>& m_monsters;
+	StringPool& m_strings;
+	State m_state = State::START;
+	uint32_t m_rootFields = 0;
+	uint32_t m_monsterFields = 0;
+	uint32_t m_tableFields = 0;
+};
+
+// An item that refers to another loot table rather than a treasure. The treasure at index
+// holds its weight until the table is expanded.
+struct NestedTableItem
+{
+	size_t index = 0;
+	std::string path;
+};
+
+// Loot tables: { "numItems", "items": [{ "type", "name", "dropRate", "quantity"? } or { "table", "dropRate" }] }
+// where quantity is either a number or { "min", "max" }.
+class LootTableHandler : public ContentHandler<LootTableHandler>
+{
+public:
+	LootTableHandler(std::vector<Treasure>& treasures, std::vector<NestedTableItem>& nestedTables,
+		StringPool& strings, size_t fileSize)
+		: m_treasures(treasures)
+		, m_nestedTables(nestedTables)
+		, m_strings(strings)
+		, m_maxItemCount(fileSize / s_minItemBytes)
+	{
+	}
+
+	bool IsDone() const { return m_state == State::DONE; }
+
+	bool start_object(size_t)
+	{
+		switch (m_state)
+		{
+		case State::START:
+			m_state = State::ROOT;
+			return true;
+		case State::ITEMS:
+			m_treasures.emplace_back();
+			m_itemFields = 0;
+			m_state = State::ITEM;
+			return true;
+		case State::ITEM_QUANTITY:
+			m_quantityFields = 0;
+			m_state = State::QUANTITY;
+			return true;
+		default:
+			return Fail("Unexpected object.");
+		}
+	}
+
+	bool end_object()
+	{
+		switch (m_state)
+		{
+		case State::ROOT:
+			m_state = State::DONE;
+			if (!HasFields(m_rootFields, ITEMS_FIELD, "treasure data"))
+			{
+				return false;
+			}
+			return (m_rootFields & NUM_ITEMS_FIELD) == 0 || m_numItems == m_treasures.size()
+				|| Fail("numItems doesn't match the number of items.");
+		case State::ITEM:
+			m_state = State::ITEMS;
+			if ((m_itemFields & TABLE_FIELD) != 0)
+			{
+				return ((m_itemFields & (TYPE_FIELD | NAME_FIELD | QUANTITY_FIELD)) == 0
+					|| Fail("A nested table can't also be a treasure."))
+					&& HasFields(m_itemFields, DROP_RATE_FIELD, "nested table");
+			}
+			return HasFields(m_itemFields, TYPE_FIELD | NAME_FIELD | DROP_RATE_FIELD, "treasure");
+		case State::QUANTITY:
+			m_state = State::ITEM;
+			return HasFields(m_quantityFields, MIN_FIELD | MAX_FIELD, "quantity")
+				&& (m_treasures.back().minQuantity <= m_treasures.back().maxQuantity
+					|| Fail("Quantity min can't be above max."));
+		default:
+			return Fail("Unexpected end of object.");
+		}
+	}
+
+	bool start_array(size_t)
+	{
+		if (m_state != State::ITEMS_VALUE)
+		{
+			return Fail("Unexpected array.");
+		}
+
+		if ((m_rootFields & NUM_ITEMS_FIELD) != 0)
+		{
+			m_treasures.reserve(std::min(m_numItems, m_maxItemCount));
+		}
+		m_state = State::ITEMS;
+		return true;
+	}
+
+	bool end_array()
+	{
+		if (m_state != State::ITEMS)
+		{
+			return Fail("Unexpected end of array.");
+		}
+
+		m_state = State::ROOT;
+		return true;
+	}
+
+	bool key(json::string_t& key)
+	{
+		switch (m_state)
+		{
+		case State::ROOT:
+			if (key == "numItems")
+			{
+				m_state = State::NUM_ITEMS;
+				return ReadField(m_rootFields, NUM_ITEMS_FIELD, key);
+			}
+			if (key == "items")
+			{
+				m_state = State::ITEMS_VALUE;
+				return ReadField(m_rootFields, ITEMS_FIELD, key);
+			}
+			return Fail("Unknown key in treasure data. key=" + key);
+		case State::ITEM:
+			if (key == "type")
+			{
+				m_state = State::ITEM_TYPE;
+				return ReadField(m_itemFields, TYPE_FIELD, key);
+			}
+			if (key == "name")
+			{
+				m_state = State::ITEM_NAME;
+				return ReadField(m_itemFields, NAME_FIELD, key);
+			}
+			if (key == "dropRate")
+			{
+				m_state = State::ITEM_DROP_RATE;
+				return ReadField(m_itemFields, DROP_RATE_FIELD, key);
+			}
+			if (key == "table")
+			{
+				m_state = State::ITEM_TABLE;
+				return ReadField(m_itemFields, TABLE_FIELD, key);
+			}
+			if (key == "quantity")
+			{
+				m_state = State::ITEM_QUANTITY;
+				return ReadField(m_itemFields, QUANTITY_FIELD, key);
+			}
+			return Fail("Unknown key in treasure. key=" + key);
+		case State::QUANTITY:
+			if (key == "min")
+			{
+				m_state = State::QUANTITY_MIN;
+				return ReadField(m_quantityFields, MIN_FIELD, key);
+			}
+			if (key == "max")
+			{
+				m_state = State::QUANTITY_MAX;
+				return ReadField(m_quantityFields, MAX_FIELD, key);
+			}
+			return Fail("Unknown key in quantity. key=" + key);
+		default:
+			return Fail("Unexpected key. key=" + key);
+		}
+	}
+
+	bool string(json::string_t& value)
+	{
+		switch (m_state)
+		{
+		case State::ITEM_TYPE:
+			m_treasures.back().type = GetTreasureTypeFromId(value);
+			m_state = State::ITEM;
+			return m_treasures.back().type != TreasureType::NONE
+				|| Fail("Unknown treasure type. type=" + value);
+		case State::ITEM_NAME:
+			m_treasures.back().nameId = m_strings.Intern(value);
+			m_state = State::ITEM;
+			return true;
+		case State::ITEM_TABLE:
+			m_nestedTables.push_back({ m_treasures.size() - 1, std::move(value) });
+			m_state = State::ITEM;
+			return true;
+		default:
+			return Fail("Unexpected string. value=" + value);
+		}
+	}
+
+	bool OnNumber(double value)
+	{
+		switch (m_state)
+		{
+		case State::NUM_ITEMS:
+			m_numItems = static_cast<size_t>(value);
+			m_state = State::ROOT;
+			return (value >= 0.0 && value == static_cast<double>(m_numItems))
+				|| Fail("numItems must be a whole number.");
+		case State::ITEM_DROP_RATE:
+			m_treasures.back().dropRate = static_cast<float>(value);
+			m_state = State::ITEM;
+			return (value >= 0.0 && std::isfinite(static_cast<float>(value)))
+				|| Fail("Treasure drop rate must be a finite number of at least 0.");
+		case State::ITEM_QUANTITY:
+			m_state = State::ITEM;
+			return ReadQuantity(value, m_treasures.back().minQuantity)
+				&& ReadQuantity(value, m_treasures.back().maxQuantity);
+		case State::QUANTITY_MIN:
+			m_state = State::QUANTITY;
+			return ReadQuantity(value, m_treasures.back().minQuantity);
+		case State::QUANTITY_MAX:
+			m_state = State::QUANTITY;
+			return ReadQuantity(value, m_treasures.back().maxQuantity);
+		default:
+			return Fail("Unexpected number.");
+		}
+	}
+
+private:
+	enum struct State
+	{
+		START,
+		ROOT,
+		NUM_ITEMS,
+		ITEMS_VALUE,
+		ITEMS,
+		ITEM,
+		ITEM_TYPE,
+		ITEM_NAME,
+		ITEM_DROP_RATE,
+		ITEM_TABLE,
+		ITEM_QUANTITY,
+		QUANTITY,
+		QUANTITY_MIN,
+		QUANTITY_MAX,
+		DONE
+	};
+
+	bool ReadQuantity(double value, int32_t& quantity)
+	{
+		quantity = static_cast<int32_t>(std::clamp(value, 0.0, static_cast<double>(INT32_MAX)));
+		return value == static_cast<double>(quantity)
+			|| Fail("Quantity must be a whole number from 0 to 2^31 - 1.");
+	}
+
+	// Bits of m_rootFields, m_itemFields and m_quantityFields.
+	enum : uint32_t
+	{
+		NUM_ITEMS_FIELD = 1 << 0,
+		ITEMS_FIELD = 1 << 1,
+		TYPE_FIELD = 1 << 0,
+		NAME_FIELD = 1 << 1,
+		DROP_RATE_FIELD = 1 << 2,
+		TABLE_FIELD = 1 << 3,
+		QUANTITY_FIELD = 1 << 4,
+		MIN_FIELD = 1 << 0,
+		MAX_FIELD = 1 << 1
+	};
+
+	std::vector<Treasure>& m_treasures;
+	std::vector<NestedTableItem>& m_nestedTables;
+	StringPool& m_strings;
+	size_t m_maxItemCount;
+	size_t m_numItems = 0;
+	State m_state = State::START;
+	uint32_t m_rootFields = 0;
+	uint32_t m_itemFields = 0;
+	uint32_t m_quantityFields = 0;
+};
+
+// Maps the file and runs handler over it. On failure error names the file.
+template <typename Handler>
+static bool ParseContentFile(const MappedFile& file, const std::string& path, Handler& handler, std::string& error)
+{
+	// An empty file has no data; give the parser a valid empty range instead.
+	const char* data = file.GetData() ? file.GetData() : "";
+	if (!json::sax_parse(data, data + file.GetSize(), &handler) || !handler.IsDone())
+	{
+		error = "Invalid content data. file=" + path + " error=" + handler.GetError();
+		return false;
+	}
+	return true;
+}
+
+//---------------------------------------------------------------
+
+// Loads loot tables with every nested table expanded, so each one comes out as a single flat
+// list of treasures and rolling a table is one pick however deep the content goes. Each file
+// is only read once per load, however many tables include it.
+class LootTableCompiler
+{
+public:
+	LootTableCompiler(const std::string& rootDirectory, StringPool& strings)
+		: m_rootDirectory(rootDirectory)
+		, m_strings(strings)
+	{
+	}
+
+	bool Load(LootTable& table, std::string& error)
+	{
+		const std::vector<Treasure>* treasures = Compile(table.path, error);
+		if (!treasures)
+		{
+			return false;
+		}
+
+		table.treasures = *treasures;
+		return true;
+	}
+
+private:
+	// Null on failure. Points into m_compiledTables, whose nodes never move.
+	const std::vector<Treasure>* Compile(const std::string& path, std::string& error)
+	{
+		auto compiled = m_compiledTables.find(path);
+		if (compiled != m_compiledTables.end())
+		{
+			return &compiled->second;
+		}
+
+		if (std::find(m_openPaths.begin(), m_openPaths.end(), path) != m_openPaths.end())
+		{
+			error = "Loot table includes itself. file=" + path;
+			return nullptr;
+		}
+
+		std::vector<Treasure> treasures;
+		std::vector<NestedTableItem> nestedTables;
+		{
+			TRACE_SCOPE("LoadLootTable");
+
+			MappedFile file;
+			if (!file.Open(GetContentPath(m_rootDirectory, path)))
+			{
+				error = "Could not open treasure data file. file=" + path;
+				return nullptr;
+			}
+
+			LootTableHandler handler(treasures, nestedTables, m_strings, file.GetSize());
+			if (!ParseContentFile(file, path, handler, error))
+			{
+				return nullptr;
+			}
+		}
+
+		// Summed in data order, the way rolling sums them. A table that can't drop anything
+		// would roll NONE.
+		float weightTotal = 0.0f;
+		for (const Treasure& treasure : treasures)
+		{
+			weightTotal += treasure.dropRate;
+		}
+		if (!(weightTotal > 0.0f && std::isfinite(weightTotal)))
+		{
+			error = "Loot table drop rates must add up to a finite number above 0. file=" + path;
+			return nullptr;
+		}
+
+		if (!nestedTables.empty())
+		{
+			m_openPaths.push_back(path);
+			bool isExpanded = Expand(nestedTables, treasures, error);
+			m_openPaths.pop_back();
+			if (!isExpanded)
+			{
+				return nullptr;
+			}
+		}
+
+		return &m_compiledTables.emplace(path, std::move(treasures)).first->second;
+	}
+
+	// Replaces each nested table's placeholder with the table's treasures, each weighted by
+	// its share of the nested table's total. Expanded treasures fold into an earlier entry
+	// of the same type, name and quantity, so shared items don't pile up. Tables without
+	// nested ones are left exactly as written.
+	bool Expand(const std::vector<NestedTableItem>& nestedTables,
+		std::vector<Treasure>& treasures, std::string& error)
+	{
+		std::vector<Treasure> expanded;
+		expanded.reserve(treasures.size());
+
+		auto nested = nestedTables.begin();
+		for (size_t i = 0; i < treasures.size(); ++i)
+		{
+			if (nested == nestedTables.end() || nested->index != i)
+			{
+				expanded.push_back(treasures[i]);
+				continue;
+			}
+
+			const std::vector<Treasure>* nestedTreasures = Compile(nested->path, error);
+			if (!nestedTreasures)
+			{
+				return false;
+			}
+
+			// Summed in data order, the way rolling sums them. Compile has already checked it's
+			// above 0.
+			float nestedWeightTotal = 0.0f;
+			for (const Treasure& treasure : *nestedTreasures)
+			{
+				nestedWeightTotal += treasure.dropRate;
+			}
+
+			double weight = static_cast<double>(treasures[i].dropRate);
+			for (Treasure treasure : *nestedTreasures)
+			{
+				treasure.dropRate = static_cast<float>(weight
+					* static_cast<double>(treasure.dropRate) / static_cast<double>(nestedWeightTotal));
+
+				auto existing = std::find_if(expanded.begin(), expanded.end(),
+					[&treasure](const Treasure& t)
+				{
+					return t.type == treasure.type && t.nameId == treasure.nameId
+						&& t.minQuantity == treasure.minQuantity && t.maxQuantity == treasure.maxQuantity;
+				});
+
+				if (existing != expanded.end())
+				{
+					existing->dropRate += treasure.dropRate;
+				}
+				else
+				{
+					expanded.push_back(treasure);
+				}
+			}
+			++nested;
+		}
+
+		treasures = std::move(expanded);
+		return true;
+	}
+
+private:
+	const std::string& m_rootDirectory;
+	StringPool& m_strings;
+
+	// Fully expanded tables by path.
+	std::unordered_map<std::string, std::vector<Treasure>> m_compiledTables;
+
+	// Tables being expanded right now, outermost first, to catch cycles.
+	std::vector<std::string> m_openPaths;
+};
+
+//---------------------------------------------------------------
+// Small files. These hold a handful of entries, so they're parsed whole into a DOM and
+// checked against their schema afterwards. As with the handlers, unknown keys and ids,
+// duplicate keys and missing fields fail.
+
+static bool Fail(std::string& error, const std::string& message)
+{
+	error = message;
+	return false;
+}
+
+// Fails unless value is an object holding exactly keys.
+static bool CheckObject(const json& value, std::initializer_list<const char*> keys, const char* objectName,
+	std::string& error)
+{
+	if (!value.is_object())
+	{
+		return Fail(error, std::string("Expected an object for ") + objectName + ".");
+	}
+
+	for (const auto& field : value.items())
+	{
+		if (std::none_of(keys.begin(), keys.end(), [&field](const char* key) { return field.key() == key; }))
+		{
+			return Fail(error, std::string("Unknown key in ") + objectName + ". key=" + field.key());
+		}
+	}
+
+	return value.size() == keys.size()
+		|| Fail(error, std::string("Missing required key in ") + objectName + ".");
+}
+
+static bool CheckArray(const json& value, const char* key, std::string& error)
+{
+	return value.is_array() || Fail(error, std::string("Expected an array for ") + key + ".");
+}
+
+static bool ReadNumber(const json& value, const char* key, double& number, std::string& error)
+{
+	if (!value.is_number())
+	{
+		return Fail(error, std::string("Expected a number for ") + key + ".");
+	}
+	number = value.get<double>();
+	return true;
+}
+
+static bool ReadString(const json& value, const char* key, std::string_view& text, std::string& error)
+{
+	if (!value.is_string())
+	{
+		return Fail(error, std::string("Expected a string for ") + key + ".");
+	}
+	text = value.get_ref<const std::string&>();
+	return true;
+}
+
+static bool ReadMonsterType(const json& value, const char* key, MonsterType& type, std::string& error)
+{
+	std::string_view id;
+	if (!ReadString(value, key, id, error))
+	{
+		return false;
+	}
+	type = GetMonsterTypeFromId(id);
+	return type != MonsterType::NONE || Fail(error, "Unknown monster type. type=" + std::string(id));
+}
+
+static bool ReadTreasureType(const json& value, const char* key, TreasureType& type, std::string& error)
+{
+	std::string_view id;
+	if (!ReadString(value, key, id, error))
+	{
+		return false;
+	}
+	type = GetTreasureTypeFromId(id);
+	return type != TreasureType::NONE || Fail(error, "Unknown treasure type. type=" + std::string(id));
+}
+
+// Parses the file into a document and hands it to read, which checks it against the file's
+// schema. On failure error names the file.
+template <typename Reader>
+static bool ReadContentDocument(const MappedFile& file, const std::string& path, Reader read, std::string& error)
+{
+	// The DOM keeps the last of duplicate keys, so they're caught as the parser goes.
+	std::vector<std::vector<std::string>> objectKeys;
+	std::string duplicateKey;
+	auto checkKeys = [&objectKeys, &duplicateKey](int, json::parse_event_t event, json& parsed)
+	{
+		if (event == json::parse_event_t::object_start)
+		{
+			objectKeys.emplace_back();
+		}
+		else if (event == json::parse_event_t::object_end)
+		{
+			objectKeys.pop_back();
+		}
+		else if (event == json::parse_event_t::key)
+		{
+			std::vector<std::string>& keys = objectKeys.back();
+			const std::string& key = parsed.get_ref<const std::string&>();
+			if (std::find(keys.begin(), keys.end(), key) != keys.end() && duplicateKey.empty())
+			{
+				duplicateKey = key;
+			}
+			keys.push_back(key);
+		}
+		return true;
+	};
+
+	// An empty file has no data; give the parser a valid empty range instead.
+	const char* data = file.GetData() ? file.GetData() : "";
+	std::string documentError;
+	try
+	{
+		json document = json::parse(data, data + file.GetSize(), checkKeys);
+		if (!duplicateKey.empty())
+		{
+			documentError = "Duplicate key. key=" + duplicateKey;
+		}
+		else
+		{
+			read(document, documentError);
+		}
+	}
+	catch (const json::exception& e)
+	{
+		documentError = e.what();
+	}
+
+	if (documentError.empty())
+	{
+		return true;
+	}
+
+	error = "Invalid content data. file=" + path + " error=" + documentError;
+	return false;
+}
+
+// encounters.json: { "zones": [{ "name", "monsters": [{ "type", "weight" }] }] }
+static bool ReadEncounterData(const json& document, StringPool& strings, std::vector<EncounterTable>& tables,
+	std::string& error)
+{
+	if (!CheckObject(document, { "zones" }, "encounter data", error)
+		|| !CheckArray(document["zones"], "zones", error))
+	{
+		return false;
+	}
+
+	for (const json& zone : document["zones"])
+	{
+		if (!CheckObject(zone, { "name", "monsters" }, "zone", error)
+			|| !CheckArray(zone["monsters"], "monsters", error))
+		{
+			return false;
+		}
+
+		std::string_view name;
+		if (!ReadString(zone["name"], "name", name, error))
+		{
+			return false;
+		}
+
+		EncounterTable& table = tables.emplace_back();
+		table.zoneId = strings.Intern(name);
+		for (const json& monster : zone["monsters"])
+		{
+			Encounter& encounter = table.encounters.emplace_back();
+			double weight = 0.0;
+			if (!CheckObject(monster, { "type", "weight" }, "encounter", error)
+				|| !ReadMonsterType(monster["type"], "type", encounter.type, error)
+				|| !ReadNumber(monster["weight"], "weight", weight, error))
+			{
+				return false;
+			}
+
+			encounter.weight = static_cast<float>(weight);
+			if (!(weight >= 0.0 && std::isfinite(encounter.weight)))
+			{
+				return Fail(error, "Encounter weight must be a finite number of at least 0.");
+			}
+		}
+	}
+	return true;
+}
+
+// pity-rules.json: { "rules": [{ "monster", "treasure", "afterKills" }] }
+static bool ReadPityData(const json& document, std::vector<PityRule>& rules, std::string& error)
+{
+	if (!CheckObject(document, { "rules" }, "pity data", error)
+		|| !CheckArray(document["rules"], "rules", error))
+	{
+		return false;
+	}
+
+	for (const json& ruleData : document["rules"])
+	{
+		PityRule& rule = rules.emplace_back();
+		double afterKills = 0.0;
+		if (!CheckObject(ruleData, { "monster", "treasure", "afterKills" }, "pity rule", error)
+			|| !ReadMonsterType(ruleData["monster"], "monster", rule.monster, error)
+			|| !ReadTreasureType(ruleData["treasure"], "treasure", rule.treasure, error)
+			|| !ReadNumber(ruleData["afterKills"], "afterKills", afterKills, error))
+		{
+			return false;
+		}
+
+		rule.afterKills = static_cast<int32_t>(std::clamp(afterKills, 0.0, static_cast<double>(INT32_MAX)));
+		if (rule.afterKills < 1 || afterKills != static_cast<double>(rule.afterKills))
+		{
+			return Fail(error, "afterKills must be a whole number from 1 to 2^31 - 1.");
+		}
+	}
+	return true;
+}
+
+// treasure-values.json: { "values": [{ "treasure", "value" }] }
+static bool ReadValueData(const json& document, std::vector<TreasureValue>& values, std::string& error)
+{
+	if (!CheckObject(document, { "values" }, "value data", error)
+		|| !CheckArray(document["values"], "values", error))
+	{
+		return false;
+	}
+
+	for (const json& valueData : document["values"])
+	{
+		TreasureValue& value = values.emplace_back();
+		if (!CheckObject(valueData, { "treasure", "value" }, "treasure value", error)
+			|| !ReadTreasureType(valueData["treasure"], "treasure", value.treasure, error)
+			|| !ReadNumber(valueData["value"], "value", value.value, error))
+		{
+			return false;
+		}
+
+		if (!(std::isfinite(value.value) && value.value >= 0.0))
+		{
+			return Fail(error, "value must be a finite number of at least 0.");
+		}
+	}
+	return true;
+}
+
+bool LoadContent(const std::string& rootDirectory, std::set<Monster>& monsters, StringPool& strings,
+	std::string& error)
+{
+	std::string monsterDataPath = GetContentPath(rootDirectory, s_monsterDataPath);
+	MappedFile file;
+	if (!file.Open(monsterDataPath))
+	{
+		error = "Could not open file. file=" + monsterDataPath;
+		return false;
+	}
+
+	std::vector<Monster> parsedMonsters;
+	{
+		TRACE_SCOPE("ParseMonsterData");
+		MonsterDataHandler handler(parsedMonsters, strings);
+		if (!ParseContentFile(file, monsterDataPath, handler, error))
+		{
+			return false;
+		}
+	}
+	file.Close();
+
+	LootTableCompiler tableCompiler(rootDirectory, strings);
+	for (Monster& monster : parsedMonsters)
+	{
+		for (LootTable& table : monster.tables)
+		{
+			if (!tableCompiler.Load(table, error))
+			{
+				return false;
+			}
+		}
+
+		MonsterType type = monster.type;
+		if (!monsters.insert(std::move(monster)).second)
+		{
+			error = "Duplicate monster type. type=" + std::string(GetMonsterTypeId(type));
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool LoadEncounterTables(const std::string& rootDirectory, const std::set<Monster>& monsters,
+	StringPool& strings, std::vector<EncounterTable>& tables, std::string& error)
+{
+	std::string encounterDataPath = GetContentPath(rootDirectory, s_encounterDataPath);
+	MappedFile file;
+	if (!file.Open(encounterDataPath))
+	{
+		// Content from before zones existed has no encounters; every monster is as likely.
+		if (file.IsMissing())
+		{
+			return true;
+		}
+
+		error = "Could not open file. file=" + encounterDataPath;
+		return false;
+	}
+
+	{
+		TRACE_SCOPE("ParseEncounterData");
+		auto read = [&strings, &tables](const json& document, std::string& documentError)
+		{
+			return ReadEncounterData(document, strings, tables, documentError);
+		};
+		if (!ReadContentDocument(file, encounterDataPath, read, error))
+		{
+			return false;
+		}
+	}
+
+	for (size_t i = 0; i < tables.size(); ++i)
+	{
+		const EncounterTable& table = tables[i];
+		std::string zone(strings.Get(table.zoneId));
+		for (size_t j = 0; j < i; ++j)
+		{
+			if (tables[j].zoneId == table.zoneId)
+			{
+				error = "Duplicate zone. zone=" + zone;
+				return false;
+			}
+		}
+
+		double weightTotal = 0.0;
+		for (auto it = std::begin(table.encounters); it != std::end(table.encounters); ++it)
+		{
+			std::string type(GetMonsterTypeId(it->type));
+			if (std::any_of(std::begin(table.encounters), it, [&](const Encounter& e) { return e.type == it->type; }))
+			{
+				error = "Duplicate monster in zone. zone=" + zone + " type=" + type;
+				return false;
+			}
+
+			Monster monster;
+			monster.type = it->type;
+			if (monsters.count(monster) == 0)
+			{
+				error = "Zone spawns a monster with no data. zone=" + zone + " type=" + type;
+				return false;
+			}
+			weightTotal += it->weight;
+		}
+
+		if (weightTotal <= 0.0)
+		{
+			error = "Zone spawns nothing. zone=" + zone;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool LoadPityRules(const std::string& rootDirectory, const std::set<Monster>& monsters,
+	std::vector<PityRule>& rules, std::string& error)
+{
+	std::string pityDataPath = GetContentPath(rootDirectory, s_pityDataPath);
+	MappedFile file;
+	if (!file.Open(pityDataPath))
+	{
+		if (file.IsMissing())
+		{
+			return true;
+		}
+
+		error = "Could not open file. file=" + pityDataPath;
+		return false;
+	}
+
+	{
+		TRACE_SCOPE("ParsePityData");
+		auto read = [&rules](const json& document, std::string& documentError)
+		{
+			return ReadPityData(document, rules, documentError);
+		};
+		if (!ReadContentDocument(file, pityDataPath, read, error))
+		{
+			return false;
+		}
+	}
+
+	for (auto it = std::begin(rules); it != std::end(rules); ++it)
+	{
+		std::string monster(GetMonsterTypeId(it->monster));
+		std::string treasure(GetTreasureTypeId(it->treasure));
+		if (std::any_of(std::begin(rules), it, [&](const PityRule& rule)
+		{
+			return rule.monster == it->monster && rule.treasure == it->treasure;
+		}))
+		{
+			error = "Duplicate pity rule. monster=" + monster + " treasure=" + treasure;
+			return false;
+		}
+
+		Monster monsterData;
+		monsterData.type = it->monster;
+		if (monsters.count(monsterData) == 0)
+		{
+			error = "Pity rule for a monster with no data. monster=" + monster;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool LoadTreasureValues(const std::string& rootDirectory, std::vector<TreasureValue>& values,
+	std::string& error)
+{
+	std::string valueDataPath = GetContentPath(rootDirectory, s_valueDataPath);
+	MappedFile file;
+	if (!file.Open(valueDataPath))
+	{
+		if (file.IsMissing())
+		{
+			return true;
+		}
+
+		error = "Could not open file. file=" + valueDataPath;
+		return false;
+	}
+
+	{
+		TRACE_SCOPE("ParseValueData");
+		auto read = [&values](const json& document, std::string& documentError)
+		{
+			return ReadValueData(document, values, documentError);
+		};
+		if (!ReadContentDocument(file, valueDataPath, read, error))
+		{
+			return false;
+		}
+	}
+
+	for (auto it = std::begin(values); it != std::end(values); ++it)
+	{
+		if (std::any_of(std::begin(values), it, [&](const TreasureValue& value)
+		{
+			return value.treasure == it->treasure;
+		}))
+		{
+			error = "Duplicate treasure value. treasure=" + std::string(GetTreasureTypeId(it->treasure));
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//===============================================================
+
+} // namespace LootSimulator
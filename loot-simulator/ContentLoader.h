@@ -0,0 +1,46 @@
+//---------------------------------------------------------------
+//
+// ContentLoader.h
+//
+
+#pragma once
+
+#include "GameTypes.h"
+#include "StringPool.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Reads monsters.json under rootDirectory and every loot table it names, whose paths are
+// relative to rootDirectory as well. Files are memory mapped and streamed straight into the
+// content, checking the schema as they go, so unknown keys or ids and missing fields fail.
+// Items in a loot table may name another table instead of a treasure; those are expanded
+// here, so every LootTable comes out as a flat list of treasures. Names are interned into
+// strings. Doesn't log or print; on failure error says why.
+bool LoadContent(const std::string& rootDirectory, std::set<Monster>& monsters, StringPool& strings,
+	std::string& error);
+
+// Reads encounters.json under rootDirectory into one table per zone, in data order. Every
+// monster a zone spawns must be in monsters. Content without the file has no zones, which
+// isn't an error; tables is left empty. On failure error says why.
+bool LoadEncounterTables(const std::string& rootDirectory, const std::set<Monster>& monsters,
+	StringPool& strings, std::vector<EncounterTable>& tables, std::string& error);
+
+// Reads pity-rules.json under rootDirectory, in data order. Every rule's monster must be in
+// monsters. Content without the file has no rules, which isn't an error.
+bool LoadPityRules(const std::string& rootDirectory, const std::set<Monster>& monsters,
+	std::vector<PityRule>& rules, std::string& error);
+
+// Reads treasure-values.json under rootDirectory, in data order. Content without the file
+// values nothing, which isn't an error.
+bool LoadTreasureValues(const std::string& rootDirectory, std::vector<TreasureValue>& values,
+	std::string& error);
+
+//===============================================================
+
+} // namespace LootSimulator
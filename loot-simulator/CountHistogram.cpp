@@ -0,0 +1,72 @@
+//---------------------------------------------------------------
+//
+// CountHistogram.cpp
+//
+
+#include "CountHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace LootSimulator {
+
+//===============================================================
+
+void CountHistogram::Merge(const CountHistogram& other)
+{
+	if (other.m_counts.size() > m_counts.size())
+	{
+		m_counts.resize(other.m_counts.size(), 0);
+	}
+
+	for (size_t i = 0; i < other.m_counts.size(); ++i)
+	{
+		m_counts[i] += other.m_counts[i];
+	}
+	m_totalCount += other.m_totalCount;
+	m_sum += other.m_sum;
+}
+
+uint64_t CountHistogram::GetValueAtPercentile(double percentile) const
+{
+	if (m_totalCount == 0)
+	{
+		return 0;
+	}
+
+	double fraction = std::min(std::max(percentile, 0.0), 100.0) / 100.0;
+	uint64_t target = std::max<uint64_t>(
+		static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(m_totalCount))), 1);
+
+	uint64_t seen = 0;
+	for (size_t i = 0; i < m_counts.size(); ++i)
+	{
+		seen += m_counts[i];
+		if (seen >= target)
+		{
+			return i;
+		}
+	}
+	return GetMax();
+}
+
+uint64_t CountHistogram::GetMax() const
+{
+	for (size_t i = m_counts.size(); i-- > 0;)
+	{
+		if (m_counts[i] != 0)
+		{
+			return i;
+		}
+	}
+	return 0;
+}
+
+double CountHistogram::GetMean() const
+{
+	return m_totalCount > 0 ? m_sum / static_cast<double>(m_totalCount) : 0.0;
+}
+
+//===============================================================
+
+} // namespace LootSimulator
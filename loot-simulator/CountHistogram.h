@@ -0,0 +1,58 @@
+//---------------------------------------------------------------
+//
+// CountHistogram.h
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Exact histogram of whole number counts, like how many of a treasure one player ended up
+// with. Every value gets its own slot, grown as needed, so memory follows the largest value
+// rather than how many were recorded, percentiles are exact, and merging is adding slots.
+// Not thread safe; give each thread its own and merge them.
+class CountHistogram
+{
+public:
+	void Record(uint64_t value)
+	{
+		if (value >= m_counts.size())
+		{
+			m_counts.resize(value + 1, 0);
+		}
+		++m_counts[value];
+		++m_totalCount;
+		m_sum += static_cast<double>(value);
+	}
+
+	void Merge(const CountHistogram& other);
+
+	// Smallest recorded value that percentile of all values are at or below, e.g. 10.0.
+	uint64_t GetValueAtPercentile(double percentile) const;
+
+	// How many times value was recorded.
+	uint64_t GetCountAtValue(uint64_t value) const
+	{
+		return value < m_counts.size() ? m_counts[value] : 0;
+	}
+
+	uint64_t GetCount() const { return m_totalCount; }
+	uint64_t GetMax() const;
+	double GetMean() const;
+
+private:
+	std::vector<uint64_t> m_counts;
+	uint64_t m_totalCount = 0;
+
+	// Doubles so a long run of large values can't overflow.
+	double m_sum = 0.0;
+};
+
+//===============================================================
+
+} // namespace LootSimulator
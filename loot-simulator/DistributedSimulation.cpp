@@ -0,0 +1,392 @@
+//---------------------------------------------------------------
+//
+// DistributedSimulation.cpp
+//
+
+#include "DistributedSimulation.h"
+
+#include "Game.h"
+#include "Log.h"
+#include "LootCounters.h"
+#include "ShardedSimulation.h"
+#include "Trace.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Messages go over the wire as is, so both ends must share endianness and these layouts.
+static const uint32_t s_messageMagic = 0x4c534d31; // "LSM1"
+
+// How many times a shard may be handed out before we give up on the whole job.
+static const int32_t s_maxShardAttempts = 3;
+
+// A worker that takes longer than this to answer is treated as lost. Shards get the
+// minimum plus a generous allowance per kill, since the answer only comes once the
+// whole shard has been simulated.
+static const std::chrono::milliseconds s_minShardTimeout = std::chrono::seconds(30);
+static const int64_t s_shardTimeoutKillsPerMillisecond = 1000;
+
+// Coordinators must send their request within this long of connecting.
+static const std::chrono::milliseconds s_requestTimeout = std::chrono::seconds(30);
+
+// Pause before the last worker standing retries a shard that failed on it.
+static const std::chrono::milliseconds s_shardRetryDelay = std::chrono::milliseconds(100);
+
+enum class ShardStatus : int32_t
+{
+	OK = 0,
+	CONTENT_MISMATCH,
+	INVALID_REQUEST,
+	WORKER_LOST
+};
+
+struct ShardRequestMessage
+{
+	uint32_t magic = s_messageMagic;
+	int32_t type = static_cast<int32_t>(MonsterType::NONE);
+	uint64_t contentHash = 0;
+	uint64_t seed = 0;
+	int64_t count = 0;
+	int32_t shardCount = 0;
+	int32_t shardIndex = 0;
+};
+
+struct ShardResponseMessage
+{
+	uint32_t magic = s_messageMagic;
+	ShardStatus status = ShardStatus::OK;
+	uint64_t contentHash = 0;
+	uint32_t numMonsterTypes = static_cast<uint32_t>(s_numMonsterTypes);
+	uint32_t numTreasureTypes = static_cast<uint32_t>(s_numTreasureTypes);
+
+	// Followed by LootCounters when status is OK.
+};
+
+static_assert(sizeof(ShardRequestMessage) == 40, "Shard request layout changed.");
+static_assert(sizeof(ShardResponseMessage) == 24, "Shard response layout changed.");
+
+//---------------------------------------------------------------
+
+bool ParseWorkerAddresses(const std::string& addressList, std::vector<WorkerAddress>& addresses)
+{
+	size_t start = 0;
+	while (start <= addressList.size())
+	{
+		size_t end = addressList.find(',', start);
+		if (end == std::string::npos)
+		{
+			end = addressList.size();
+		}
+
+		std::string entry = addressList.substr(start, end - start);
+		size_t colon = entry.rfind(':');
+		if (colon == std::string::npos || colon == 0 || colon + 1 == entry.size()
+			|| entry.find_first_not_of("0123456789", colon + 1) != std::string::npos
+			|| entry.size() - colon - 1 > 5)
+		{
+			LOG_ERROR("Invalid worker address. address={}", entry);
+			return false;
+		}
+
+		int32_t port = std::stoi(entry.substr(colon + 1));
+		if (port <= 0 || port > 65535)
+		{
+			LOG_ERROR("Invalid worker port. address={}", entry);
+			return false;
+		}
+
+		addresses.push_back({ entry.substr(0, colon), static_cast<uint16_t>(port) });
+		start = end + 1;
+	}
+
+	return !addresses.empty();
+}
+
+static ShardStatus RunRemoteShard(const WorkerAddress& worker, const SimulationJob& job,
+	int32_t shardIndex, LootCounters& counters)
+{
+	TRACE_SCOPE("RunRemoteShard");
+
+	int64_t shardKills = job.count / job.shardCount + 1;
+	Socket socket;
+	socket.SetTimeout(s_minShardTimeout + std::chrono::milliseconds(shardKills / s_shardTimeoutKillsPerMillisecond));
+	if (!socket.Connect(worker.host, worker.port))
+	{
+		return ShardStatus::WORKER_LOST;
+	}
+
+	ShardRequestMessage request;
+	request.type = static_cast<int32_t>(job.type.value_or(MonsterType::NONE));
+	request.contentHash = job.contentHash;
+	request.seed = job.seed;
+	request.count = job.count;
+	request.shardCount = job.shardCount;
+	request.shardIndex = shardIndex;
+
+	ShardResponseMessage response;
+	if (!socket.SendAll(&request, sizeof(request)) || !socket.ReceiveAll(&response, sizeof(response))
+		|| response.magic != s_messageMagic)
+	{
+		return ShardStatus::WORKER_LOST;
+	}
+
+	// Double check on our side too; the counters are only meaningful for the same content.
+	if (response.status == ShardStatus::OK
+		&& (response.contentHash != job.contentHash
+			|| response.numMonsterTypes != s_numMonsterTypes
+			|| response.numTreasureTypes != s_numTreasureTypes))
+	{
+		return ShardStatus::CONTENT_MISMATCH;
+	}
+
+	if (response.status != ShardStatus::OK)
+	{
+		return response.status;
+	}
+
+	return socket.ReceiveAll(&counters, sizeof(counters)) ? ShardStatus::OK : ShardStatus::WORKER_LOST;
+}
+
+bool SimulateDistributed(const SimulationJob& job, const std::vector<WorkerAddress>& workers,
+	LootSession& lootSession)
+{
+	if (workers.empty() || job.shardCount < 1)
+	{
+		return false;
+	}
+
+	std::vector<LootCounters> shardCounters(job.shardCount);
+	std::vector<int32_t> shardAttempts(job.shardCount, 0);
+	std::deque<int32_t> remainingShards;
+	for (int32_t i = 0; i < job.shardCount; ++i)
+	{
+		remainingShards.push_back(i);
+	}
+
+	std::mutex mutex;
+	std::condition_variable shardReturned;
+	int32_t shardsInFlight = 0;
+	int32_t shardsCompleted = 0;
+	size_t workersLeft = workers.size();
+	bool hasFailed = false;
+
+	// One thread per worker pulls shards until there are none left. A failed shard goes
+	// back on the queue. The worker it failed on is dropped, unless it's the last one
+	// left, which keeps retrying until the shard runs out of attempts.
+	auto runWorker = [&](const WorkerAddress& worker)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true)
+		{
+			// Shards in flight elsewhere may still come back, so wait for them before leaving.
+			shardReturned.wait(lock, [&]()
+			{
+				return hasFailed || !remainingShards.empty() || shardsInFlight == 0;
+			});
+
+			if (hasFailed || remainingShards.empty())
+			{
+				return;
+			}
+
+			int32_t shardIndex = remainingShards.front();
+			remainingShards.pop_front();
+			++shardsInFlight;
+
+			lock.unlock();
+			LootCounters counters;
+			ShardStatus status = RunRemoteShard(worker, job, shardIndex, counters);
+			lock.lock();
+
+			--shardsInFlight;
+			if (status == ShardStatus::OK)
+			{
+				shardCounters[shardIndex] = counters;
+				++shardsCompleted;
+				shardReturned.notify_all();
+				continue;
+			}
+
+			LOG_WARNING("Shard failed on worker. host={} port={} status={}", worker.host, worker.port,
+				status);
+
+			if (++shardAttempts[shardIndex] >= s_maxShardAttempts)
+			{
+				hasFailed = true;
+			}
+			else
+			{
+				remainingShards.push_back(shardIndex);
+			}
+
+			shardReturned.notify_all();
+			if (workersLeft > 1)
+			{
+				--workersLeft;
+				return;
+			}
+
+			lock.unlock();
+			std::this_thread::sleep_for(s_shardRetryDelay);
+			lock.lock();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(workers.size());
+	for (const WorkerAddress& worker : workers)
+	{
+		threads.emplace_back(runWorker, std::cref(worker));
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	if (hasFailed || shardsCompleted != job.shardCount)
+	{
+		LOG_ERROR("Distributed simulation failed. completedShards={}", shardsCompleted);
+		return false;
+	}
+
+	// Merge in shard order so the result never depends on which worker ran what.
+	TRACE_SCOPE("MergeShards");
+	LootCounters merged;
+	for (const LootCounters& counters : shardCounters)
+	{
+		MergeLootCounters(merged, counters);
+	}
+	AppendToLootSession(merged, lootSession);
+	return true;
+}
+
+//---------------------------------------------------------------
+
+SimulationWorker::SimulationWorker(Game& game)
+	: m_game(game)
+{
+}
+
+SimulationWorker::~SimulationWorker()
+{
+	Stop();
+}
+
+bool SimulationWorker::Start(const std::string& host, uint16_t port)
+{
+	if (!m_listener.Listen(host, port))
+	{
+		LOG_ERROR("Could not listen for coordinators. port={}", port);
+		return false;
+	}
+
+	m_port = m_listener.GetLocalPort();
+	m_isRunning = true;
+	return true;
+}
+
+void SimulationWorker::Stop()
+{
+	m_isRunning = false;
+	m_listener.Shutdown();
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+	m_listener.Close();
+}
+
+void SimulationWorker::Run()
+{
+	while (m_isRunning)
+	{
+		Socket connection = m_listener.Accept();
+		if (!connection.IsValid())
+		{
+			continue;
+		}
+
+		ServeConnection(connection);
+	}
+}
+
+void SimulationWorker::RunInBackground()
+{
+	m_thread = std::thread(&SimulationWorker::Run, this);
+}
+
+void SimulationWorker::ServeConnection(Socket& connection)
+{
+	connection.SetTimeout(s_requestTimeout);
+
+	ShardRequestMessage request;
+	if (!connection.ReceiveAll(&request, sizeof(request)))
+	{
+		return;
+	}
+
+	ShardResponseMessage response;
+	response.contentHash = m_game.GetContentHash();
+
+	bool isValidType = request.type >= static_cast<int32_t>(MonsterType::NONE)
+		&& request.type < static_cast<int32_t>(MonsterType::NUM_TYPES);
+	if (request.magic != s_messageMagic || !isValidType || request.count < 0
+		|| request.shardCount < 1 || request.shardIndex < 0 || request.shardIndex >= request.shardCount)
+	{
+		response.status = ShardStatus::INVALID_REQUEST;
+		connection.SendAll(&response, sizeof(response));
+		return;
+	}
+
+	if (request.contentHash != response.contentHash)
+	{
+		response.status = ShardStatus::CONTENT_MISMATCH;
+		connection.SendAll(&response, sizeof(response));
+		return;
+	}
+
+	std::optional<MonsterType> type;
+	if (request.type != static_cast<int32_t>(MonsterType::NONE))
+	{
+		type = static_cast<MonsterType>(request.type);
+	}
+
+	LootCounters counters;
+	SimulateShard(m_game, request.count, type, request.seed, request.shardCount,
+		request.shardIndex, counters);
+
+	if (connection.SendAll(&response, sizeof(response)))
+	{
+		connection.SendAll(&counters, sizeof(counters));
+	}
+}
+
+std::vector<std::unique_ptr<SimulationWorker>> StartLocalWorkers(Game& game, int32_t count,
+	std::vector<WorkerAddress>& addresses)
+{
+	std::vector<std::unique_ptr<SimulationWorker>> workers;
+	for (int32_t i = 0; i < count; ++i)
+	{
+		auto worker = std::make_unique<SimulationWorker>(game);
+		if (!worker->Start("127.0.0.1", 0))
+		{
+			continue;
+		}
+
+		worker->RunInBackground();
+		addresses.push_back({ "127.0.0.1", worker->GetPort() });
+		workers.push_back(std::move(worker));
+	}
+	return workers;
+}
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,93 @@
+//---------------------------------------------------------------
+//
+// DistributedSimulation.h
+//
+
+#pragma once
+
+#include "GameTypes.h"
+#include "Socket.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+struct SimulationJob
+{
+	// Monster to slay. If not set, every kill picks a random type.
+	std::optional<MonsterType> type;
+
+	int64_t count = 0;
+	uint64_t seed = 0;
+
+	// Workers must have loaded exactly this content. See Game::GetContentHash.
+	uint64_t contentHash = 0;
+
+	// The job is split into this many shards. Results depend on it, not on the worker count.
+	int32_t shardCount = 1;
+};
+
+struct WorkerAddress
+{
+	std::string host;
+	uint16_t port = 0;
+};
+
+// Parses "host:port,host:port,...". Returns false if any entry is malformed.
+bool ParseWorkerAddresses(const std::string& addressList, std::vector<WorkerAddress>& addresses);
+
+// Splits the job into shards and hands them out to the workers over TCP. A shard whose worker
+// disconnects, hangs or turns out to have different content is retried on another worker, or
+// on the same one if no other is left. The merged result is the same as running every shard
+// locally.
+bool SimulateDistributed(const SimulationJob& job, const std::vector<WorkerAddress>& workers,
+	LootSession& lootSession);
+
+class Game;
+
+// Serves shards for coordinators. Runs one shard at a time on its own thread.
+class SimulationWorker
+{
+public:
+	explicit SimulationWorker(Game& game);
+	~SimulationWorker();
+
+	// Port 0 picks any free port. See GetPort.
+	bool Start(const std::string& host, uint16_t port);
+	void Stop();
+
+	// Blocks and serves shards until Stop is called from elsewhere.
+	void Run();
+
+	// Same as Run, but on a thread of our own that Stop joins.
+	void RunInBackground();
+
+	uint16_t GetPort() const { return m_port; }
+
+private:
+	void ServeConnection(Socket& connection);
+
+private:
+	Game& m_game;
+	Socket m_listener;
+	uint16_t m_port = 0;
+	std::atomic<bool> m_isRunning = false;
+	std::thread m_thread;
+};
+
+// Starts count workers on localhost ports of this process. They stand in for remote machines
+// when testing or when there's only one box.
+std::vector<std::unique_ptr<SimulationWorker>> StartLocalWorkers(Game& game, int32_t count,
+	std::vector<WorkerAddress>& addresses);
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,76 @@
+//---------------------------------------------------------------
+//
+// DropCombinationMap.cpp
+//
+
+#include "DropCombinationMap.h"
+
+#include <algorithm>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Slots to start with. Content rarely has more combinations than this.
+static const uint32_t s_initialSlotBits = 6;
+
+//---------------------------------------------------------------
+
+DropCombinationMap::DropCombinationMap()
+	: m_slots(size_t(1) << s_initialSlotBits)
+	, m_hashShift(64 - s_initialSlotBits)
+{
+
+}
+
+void DropCombinationMap::Merge(const DropCombinationMap& other)
+{
+	for (const Slot& slot : other.m_slots)
+	{
+		if (slot.count != 0)
+		{
+			Add(slot.mask, slot.count);
+		}
+	}
+}
+
+std::vector<std::pair<uint64_t, int64_t>> DropCombinationMap::GetCombinations() const
+{
+	std::vector<std::pair<uint64_t, int64_t>> combinations;
+	combinations.reserve(m_size);
+	for (const Slot& slot : m_slots)
+	{
+		if (slot.count != 0)
+		{
+			combinations.push_back({ slot.mask, slot.count });
+		}
+	}
+
+	// Ties go by mask, so the order doesn't depend on the table's layout.
+	std::sort(combinations.begin(), combinations.end(),
+		[](const std::pair<uint64_t, int64_t>& a, const std::pair<uint64_t, int64_t>& b)
+	{
+		return a.second != b.second ? a.second > b.second : a.first < b.first;
+	});
+	return combinations;
+}
+
+void DropCombinationMap::Grow()
+{
+	std::vector<Slot> slots(m_slots.size() * 2);
+	slots.swap(m_slots);
+	m_size = 0;
+	--m_hashShift;
+
+	for (const Slot& slot : slots)
+	{
+		if (slot.count != 0)
+		{
+			Add(slot.mask, slot.count);
+		}
+	}
+}
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,81 @@
+//---------------------------------------------------------------
+//
+// DropCombinationMap.h
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Kill counts by the combination of treasures dropped, as a mask with a bit per treasure
+// type. Open addressing with linear probing over a power of two table, kept at most half
+// full; a slot is empty while its count is 0, so the empty combination needs no special
+// case. Not thread safe; give each thread its own and merge them.
+class DropCombinationMap
+{
+public:
+	DropCombinationMap();
+
+	void Add(uint64_t mask, int64_t count = 1)
+	{
+		for (size_t index = GetHomeIndex(mask);; index = (index + 1) & (m_slots.size() - 1))
+		{
+			Slot& slot = m_slots[index];
+			if (slot.count == 0)
+			{
+				slot.mask = mask;
+				slot.count = count;
+				if (++m_size * 2 > m_slots.size())
+				{
+					Grow();
+				}
+				return;
+			}
+
+			if (slot.mask == mask)
+			{
+				slot.count += count;
+				return;
+			}
+		}
+	}
+
+	void Merge(const DropCombinationMap& other);
+
+	// Different combinations seen.
+	size_t GetSize() const { return m_size; }
+
+	// Every combination with its count, most common first.
+	std::vector<std::pair<uint64_t, int64_t>> GetCombinations() const;
+
+private:
+	struct Slot
+	{
+		uint64_t mask = 0;
+		int64_t count = 0;
+	};
+
+	// Fibonacci hashing: the top bits of the mask times 2^64 / golden ratio.
+	size_t GetHomeIndex(uint64_t mask) const
+	{
+		return static_cast<size_t>((mask * 0x9e3779b97f4a7c15ull) >> m_hashShift);
+	}
+
+	void Grow();
+
+private:
+	std::vector<Slot> m_slots;
+	size_t m_size = 0;
+	uint32_t m_hashShift = 0;
+};
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,118 @@
+//---------------------------------------------------------------
+//
+// DropCombinations.cpp
+//
+
+#include "DropCombinations.h"
+
+#include "Game.h"
+#include "PerfCounters.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Kills per block.
+static const int64_t s_combinationBlockSize = 65536;
+
+//---------------------------------------------------------------
+
+void RunDropCombinations(const Game& game, std::optional<MonsterType> type, int64_t killCount,
+	int32_t threadCount, uint64_t seed, DropCombinationReport& report)
+{
+	TRACE_SCOPE("RunDropCombinations");
+
+	const LootModel& lootModel = game.GetLootModel();
+	int64_t blockCount = (killCount + s_combinationBlockSize - 1) / s_combinationBlockSize;
+	std::atomic<int64_t> nextBlock = 0;
+	std::vector<DropCombinationMap> threadCombinations(static_cast<size_t>(std::max(threadCount, 1)));
+
+	auto runThread = [&](DropCombinationMap& combinations)
+	{
+		TRACE_SCOPE("DropCombinationThread");
+		PerfCounters::ScopedPhase perfPhase("DropCombinations");
+
+		RngState blockRng = SeedRng(seed);
+		int64_t blockRngIndex = 0;
+		int64_t threadKills = 0;
+		TreasureType drops[s_maxDropsPerKill];
+
+		for (int64_t block = nextBlock.fetch_add(1); block < blockCount; block = nextBlock.fetch_add(1))
+		{
+			for (; blockRngIndex < block; ++blockRngIndex)
+			{
+				JumpRng(blockRng);
+			}
+			RngState rng = blockRng;
+
+			int64_t blockKills = std::min(s_combinationBlockSize, killCount - block * s_combinationBlockSize);
+			for (int64_t kill = 0; kill < blockKills; ++kill)
+			{
+				MonsterType monsterType = type.has_value() ? type.value() : lootModel.RollMonsterType(rng);
+				size_t dropCount = game.RollDrops(monsterType, rng, drops);
+
+				uint64_t mask = 0;
+				for (size_t i = 0; i < dropCount; ++i)
+				{
+					size_t treasureIndex = static_cast<size_t>(drops[i]);
+					if (treasureIndex < s_numTreasureTypes)
+					{
+						mask |= uint64_t(1) << treasureIndex;
+					}
+				}
+				combinations.Add(mask);
+			}
+			threadKills += blockKills;
+		}
+		perfPhase.SetKillCount(threadKills);
+	};
+
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < threadCombinations.size(); ++i)
+	{
+		threads.emplace_back(runThread, std::ref(threadCombinations[i]));
+	}
+	runThread(threadCombinations[0]);
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	report.killCount = killCount;
+	for (const DropCombinationMap& combinations : threadCombinations)
+	{
+		report.combinations.Merge(combinations);
+	}
+
+	// Every kill of a combination has the same pairs, so the matrix comes from the
+	// combinations rather than from each kill.
+	for (const std::pair<uint64_t, int64_t>& combination : report.combinations.GetCombinations())
+	{
+		for (size_t i = 0; i < s_numTreasureTypes; ++i)
+		{
+			if (!(combination.first & (uint64_t(1) << i)))
+			{
+				continue;
+			}
+
+			for (size_t j = 0; j < s_numTreasureTypes; ++j)
+			{
+				if (combination.first & (uint64_t(1) << j))
+				{
+					report.coOccurrences[i][j] += combination.second;
+				}
+			}
+		}
+	}
+}
+
+//===============================================================
+
+} // namespace LootSimulator
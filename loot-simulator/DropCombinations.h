@@ -0,0 +1,46 @@
+//---------------------------------------------------------------
+//
+// DropCombinations.h
+//
+
+#pragma once
+
+#include "DropCombinationMap.h"
+#include "GameTypes.h"
+#include "LootCounters.h"
+
+#include <cstdint>
+#include <optional>
+
+namespace LootSimulator {
+
+//===============================================================
+
+class Game;
+
+static_assert(s_numTreasureTypes <= 64, "Drop combinations need a mask bit per treasure type");
+
+// Which treasures dropped together over a batch of kills.
+struct DropCombinationReport
+{
+	int64_t killCount = 0;
+
+	// Kills by the treasures they dropped, bit i for treasure type i. A treasure dropping
+	// more than once in a kill is in its combination once.
+	DropCombinationMap combinations;
+
+	// [i][j] is how many kills dropped both treasure i and j; [i][i] how many dropped i.
+	int64_t coOccurrences[s_numTreasureTypes][s_numTreasureTypes] = {};
+};
+
+// Slays killCount monsters of type, or random ones if it isn't set, on threadCount threads
+// and counts every kill's combination of drops. Each thread counts into its own map, and
+// they're merged once all are done, so nothing is locked while killing. The kills are cut
+// into blocks and block i always draws from substream i of seed, so the thread count
+// doesn't change the result. Nobody is notified.
+void RunDropCombinations(const Game& game, std::optional<MonsterType> type, int64_t killCount,
+	int32_t threadCount, uint64_t seed, DropCombinationReport& report);
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,307 @@
+//---------------------------------------------------------------
+//
+// DropDistribution.cpp
+//
+
+#include "DropDistribution.h"
+
+#include "LootModel.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <numeric>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Chances below this at either end of a distribution are dropped.
+static const double s_negligibleProbability = 1e-15;
+
+// Convolutions where the shorter side is at most this long are done directly. Below it
+// that is both faster and more precise than going through FFTs.
+static const size_t s_maxDirectConvolutionLength = 64;
+
+// Counts with their chances, while a power is being worked out.
+struct CountChances
+{
+	int64_t firstCount = 0;
+	std::vector<double> chances;
+};
+
+// In place radix 2 FFT. values.size() must be a power of two.
+static void TransformFourier(std::vector<std::complex<double>>& values, bool isInverse)
+{
+	size_t n = values.size();
+	for (size_t i = 1, j = 0; i < n; ++i)
+	{
+		size_t bit = n >> 1;
+		for (; j & bit; bit >>= 1)
+		{
+			j ^= bit;
+		}
+		j ^= bit;
+
+		if (i < j)
+		{
+			std::swap(values[i], values[j]);
+		}
+	}
+
+	std::vector<std::complex<double>> roots;
+	for (size_t length = 2; length <= n; length <<= 1)
+	{
+		// Every root straight from sin and cos, so errors don't build up over long transforms.
+		size_t half = length / 2;
+		double angle = (isInverse ? 2.0 : -2.0) * 3.141592653589793 / static_cast<double>(length);
+		roots.resize(half);
+		for (size_t k = 0; k < half; ++k)
+		{
+			roots[k] = std::polar(1.0, angle * static_cast<double>(k));
+		}
+
+		for (size_t start = 0; start < n; start += length)
+		{
+			for (size_t k = 0; k < half; ++k)
+			{
+				std::complex<double> even = values[start + k];
+				std::complex<double> odd = values[start + k + half] * roots[k];
+				values[start + k] = even + odd;
+				values[start + k + half] = even - odd;
+			}
+		}
+	}
+
+	if (isInverse)
+	{
+		for (std::complex<double>& value : values)
+		{
+			value /= static_cast<double>(n);
+		}
+	}
+}
+
+static std::vector<double> Convolve(const std::vector<double>& a, const std::vector<double>& b)
+{
+	std::vector<double> result(a.size() + b.size() - 1, 0.0);
+	if (std::min(a.size(), b.size()) <= s_maxDirectConvolutionLength)
+	{
+		for (size_t i = 0; i < a.size(); ++i)
+		{
+			for (size_t j = 0; j < b.size(); ++j)
+			{
+				result[i + j] += a[i] * b[j];
+			}
+		}
+		return result;
+	}
+
+	size_t n = 1;
+	while (n < result.size())
+	{
+		n <<= 1;
+	}
+
+	// Both real inputs go through one transform, a as the real part and b as the imaginary.
+	std::vector<std::complex<double>> values(n);
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		values[i].real(a[i]);
+	}
+	for (size_t i = 0; i < b.size(); ++i)
+	{
+		values[i].imag(b[i]);
+	}
+	TransformFourier(values, false);
+
+	// Split them back out through their symmetry and multiply.
+	std::vector<std::complex<double>> products(n);
+	for (size_t k = 0; k < n; ++k)
+	{
+		std::complex<double> value = values[k];
+		std::complex<double> mirror = std::conj(values[(n - k) & (n - 1)]);
+		std::complex<double> aValue = (value + mirror) * 0.5;
+		std::complex<double> bValue = (value - mirror) * std::complex<double>(0.0, -0.5);
+		products[k] = aValue * bValue;
+	}
+	TransformFourier(products, true);
+
+	for (size_t i = 0; i < result.size(); ++i)
+	{
+		result[i] = products[i].real();
+	}
+	return result;
+}
+
+// Drops negligible counts from both ends. FFT noise can leave tiny negative chances, which
+// count as none.
+static void TrimNegligible(CountChances& counts)
+{
+	std::vector<double>& chances = counts.chances;
+	for (double& chance : chances)
+	{
+		chance = std::max(chance, 0.0);
+	}
+
+	size_t first = 0;
+	while (first + 1 < chances.size() && chances[first] < s_negligibleProbability)
+	{
+		++first;
+	}
+
+	size_t last = chances.size();
+	while (last > first + 1 && chances[last - 1] < s_negligibleProbability)
+	{
+		--last;
+	}
+
+	chances.erase(chances.begin() + last, chances.end());
+	chances.erase(chances.begin(), chances.begin() + first);
+	counts.firstCount += static_cast<int64_t>(first);
+}
+
+static CountChances Convolve(const CountChances& a, const CountChances& b)
+{
+	CountChances result;
+	result.firstCount = a.firstCount + b.firstCount;
+	result.chances = Convolve(a.chances, b.chances);
+	TrimNegligible(result);
+	return result;
+}
+
+//---------------------------------------------------------------
+
+DropDistribution::DropDistribution()
+	: DropDistribution(0, { 1.0 })
+{
+
+}
+
+DropDistribution::DropDistribution(int64_t firstCount, std::vector<double> probabilities)
+	: m_firstCount(firstCount)
+	, m_probabilities(std::move(probabilities))
+{
+	if (m_probabilities.empty())
+	{
+		m_probabilities.push_back(1.0);
+	}
+
+	m_cumulative.resize(m_probabilities.size());
+	std::partial_sum(m_probabilities.begin(), m_probabilities.end(), m_cumulative.begin());
+}
+
+double DropDistribution::GetProbability(int64_t count) const
+{
+	if (count < GetFirstCount() || count > GetLastCount())
+	{
+		return 0.0;
+	}
+	return m_probabilities[static_cast<size_t>(count - m_firstCount)];
+}
+
+double DropDistribution::GetCumulativeProbability(int64_t count) const
+{
+	if (count < GetFirstCount())
+	{
+		return 0.0;
+	}
+	count = std::min(count, GetLastCount());
+	return std::min(m_cumulative[static_cast<size_t>(count - m_firstCount)], 1.0);
+}
+
+int64_t DropDistribution::GetCountAtPercentile(double percentile) const
+{
+	// Against the total rather than 1, so the trimmed tails can't push it off the end.
+	double fraction = std::min(std::max(percentile, 0.0), 100.0) / 100.0;
+	double target = fraction * m_cumulative.back();
+	auto it = std::lower_bound(m_cumulative.begin(), m_cumulative.end(), target);
+	size_t index = std::min(static_cast<size_t>(std::distance(m_cumulative.begin(), it)),
+		m_cumulative.size() - 1);
+	return m_firstCount + static_cast<int64_t>(index);
+}
+
+int64_t DropDistribution::GetMostLikelyCount() const
+{
+	auto it = std::max_element(m_probabilities.begin(), m_probabilities.end());
+	return m_firstCount + static_cast<int64_t>(std::distance(m_probabilities.begin(), it));
+}
+
+double DropDistribution::GetMean() const
+{
+	double mean = 0.0;
+	for (size_t i = 0; i < m_probabilities.size(); ++i)
+	{
+		mean += static_cast<double>(m_firstCount + static_cast<int64_t>(i)) * m_probabilities[i];
+	}
+	return mean;
+}
+
+//---------------------------------------------------------------
+
+DropDistribution GetConvolutionPower(const std::vector<double>& chances, int64_t count)
+{
+	TRACE_SCOPE("GetConvolutionPower");
+
+	CountChances result;
+	result.chances.push_back(1.0);
+
+	CountChances power;
+	power.chances = chances.empty() ? std::vector<double>{ 1.0 } : chances;
+	TrimNegligible(power);
+
+	// Exponentiation by squaring: power holds the distribution of 1, 2, 4... draws.
+	for (; count > 0; count >>= 1)
+	{
+		if (count & 1)
+		{
+			result = Convolve(result, power);
+		}
+		if (count > 1)
+		{
+			power = Convolve(power, power);
+		}
+	}
+
+	// The trimmed tails and FFT noise leave the chances a little short of 1, which drags
+	// the mean of millions of draws off by more than the chances themselves are off.
+	double total = std::accumulate(result.chances.begin(), result.chances.end(), 0.0);
+	for (double& chance : result.chances)
+	{
+		chance /= total;
+	}
+	return DropDistribution(result.firstCount, std::move(result.chances));
+}
+
+DropDistribution GetDropDistribution(const LootModel& lootModel, std::optional<MonsterType> type,
+	TreasureType treasure, uint32_t magicFindBucket, int64_t killCount)
+{
+	std::vector<double> chances;
+	if (type.has_value())
+	{
+		lootModel.GetDropCountChances(type.value(), treasure, magicFindBucket, chances);
+		return GetConvolutionPower(chances, killCount);
+	}
+
+	// A random kill is a mix of every type's kill, weighted by how likely it spawns.
+	std::vector<double> killChances;
+	std::vector<double> typeChances;
+	for (size_t m = 0; m < s_numMonsterTypes; ++m)
+	{
+		MonsterType monsterType = static_cast<MonsterType>(m);
+		double encounterChance = lootModel.GetEncounterChance(monsterType);
+		lootModel.GetDropCountChances(monsterType, treasure, magicFindBucket, typeChances);
+
+		killChances.resize(std::max(killChances.size(), typeChances.size()), 0.0);
+		for (size_t k = 0; k < typeChances.size(); ++k)
+		{
+			killChances[k] += encounterChance * typeChances[k];
+		}
+	}
+	return GetConvolutionPower(killChances, killCount);
+}
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,72 @@
+//---------------------------------------------------------------
+//
+// DropDistribution.h
+//
+
+#pragma once
+
+#include "GameTypes.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+class LootModel;
+
+// Chance of every count of something, like how many of a treasure a number of kills drop.
+// Only counts from GetFirstCount to GetLastCount are kept; the chance of anything outside
+// them is too small to matter.
+class DropDistribution
+{
+public:
+	// Zero, certainly.
+	DropDistribution();
+
+	// probabilities[i] is the chance of firstCount + i.
+	DropDistribution(int64_t firstCount, std::vector<double> probabilities);
+
+	// Chance of exactly count.
+	double GetProbability(int64_t count) const;
+
+	// Chance of count or fewer.
+	double GetCumulativeProbability(int64_t count) const;
+
+	// Smallest count with at least percentile of the chance at or below it, e.g. 10.0.
+	int64_t GetCountAtPercentile(double percentile) const;
+
+	// Count with the highest chance.
+	int64_t GetMostLikelyCount() const;
+
+	double GetMean() const;
+
+	int64_t GetFirstCount() const { return m_firstCount; }
+	int64_t GetLastCount() const { return m_firstCount + static_cast<int64_t>(m_probabilities.size()) - 1; }
+
+private:
+	int64_t m_firstCount = 0;
+	std::vector<double> m_probabilities;
+
+	// Running sums of m_probabilities.
+	std::vector<double> m_cumulative;
+};
+
+// Distribution of the sum of count independent draws that are k with chance chances[k].
+// Raised by repeated squaring, convolving with FFTs once both sides are long, so count can
+// run into the millions. Counts whose chance is below about 1e-15 are dropped from the
+// tails as they go, which is also about as precise as the convolutions are, and the rest
+// are scaled back up to add up to 1.
+DropDistribution GetConvolutionPower(const std::vector<double>& chances, int64_t count);
+
+// Exact distribution of how many of treasure killCount kills of type drop, or of random
+// kills if type isn't set, in the given magic find bucket. Worked out from the tables
+// without rolling anything.
+DropDistribution GetDropDistribution(const LootModel& lootModel, std::optional<MonsterType> type,
+	TreasureType treasure, uint32_t magicFindBucket, int64_t killCount);
+
+//===============================================================
+
+} // namespace LootSimulator
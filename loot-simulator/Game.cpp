@@ -5,53 +5,81 @@
 
 #include "Game.h"
 
+#include "Checkpoint.h"
+#include "ContentLoader.h"
 #include "GameEvents.h"
+#include "LiveStats.h"
 #include "Log.h"
+#include "PerfCounters.h"
+#include "ShardedSimulation.h"
+#include "Trace.h"
 
-#include <fstream>
-#include <random>
+#include <algorithm>
+#include <numeric>
+
+// Set to 1 to build with the content baked in by generate_enum_bindings.py --baked
+// instead of loading it from JSON at startup.
+#ifndef LOOTSIM_BAKED_CONTENT
+#define LOOTSIM_BAKED_CONTENT 0
+#endif
+
+#if LOOTSIM_BAKED_CONTENT
+#include "generated/BakedContent.h"
+#endif
 
 namespace LootSimulator {
 
 //===============================================================
 
-
-static std::string GetRelativePath(const std::string& path)
+// Baked builds roll through the generated tables, which make the same draws as the model.
+// Baked tables have no magic find, so magic find always rolls through the model.
+static size_t RollKill(const LootModel& lootModel, MonsterType type, uint32_t magicFindBucket,
+	RngState& rng, TreasureType (&drops)[s_maxDropsPerKill])
 {
-	std::string relativePath = "../";
-	relativePath.append(path);
-	return relativePath;
+#if LOOTSIM_BAKED_CONTENT
+	if (magicFindBucket == 0)
+	{
+		return RollBakedLoot(s_bakedMonsters, type, rng, drops);
+	}
+#endif
+	return lootModel.RollLoot(type, magicFindBucket, rng, drops);
 }
 
-//---------------------------------------------------------------
-
-static std::random_device s_rd;
-static std::mt19937 s_mt(s_rd());
-static float GetRandomFloat(float lowerBound, float upperBound)
+// Counts drops into the session, rolling a quantity for each that drops in quantities.
+static void AddDrops(const LootModel& lootModel, MonsterType type, const TreasureType* drops,
+	size_t dropCount, RngState& rng, LootSession& lootSession)
 {
-	std::uniform_real_distribution<> dist(lowerBound, upperBound);
-	return static_cast<float>(dist(s_mt));
-}
+	// Insert into the map if it doesn't exist and increment its count.
+	TreasureMap& treasures = lootSession.lootMap[type];
+	for (size_t i = 0; i < dropCount; ++i)
+	{
+		// A table that can't drop anything gives NONE, which isn't loot.
+		if (drops[i] == TreasureType::NONE)
+		{
+			continue;
+		}
 
-static int32_t GetRandomInt(int32_t lowerBound, int32_t upperBound)
-{
-	std::uniform_int_distribution<> dist(lowerBound, upperBound);
-	return static_cast<int>(dist(s_mt));
+		treasures[drops[i]]++;
+		if (lootModel.HasQuantity(type, drops[i]))
+		{
+			lootSession.quantityTotals[type][drops[i]] += lootModel.RollQuantity(type, drops[i], rng);
+		}
+	}
 }
 
 //---------------------------------------------------------------
 
-Treasure LootTable::Roll() const
+Treasure LootTable::Roll(RngState& rng) const
 {
 	// Roulette selection.
 	float weightTotal = 0.0f;
-	for (auto t : treasures)
+	for (const Treasure& t : treasures)
 	{
 		weightTotal += t.dropRate;
 	}
 
-	float randomNumber = GetRandomFloat(0.0f, weightTotal);
-	for (auto t : treasures)
+	float randomNumber = NextRandomFloat(rng, 0.0f, weightTotal);
+	for (const Treasure& t : treasures)
 	{
 
 		if (randomNumber < t.dropRate)
@@ -62,8 +90,13 @@ Treasure LootTable::Roll() const
 		randomNumber -= t.dropRate;
 	}
 
-	// Shouldn't ever get here.
-	return {};
+	// Rounding in the subtractions can carry the roll past the end. It belongs to the last
+	// treasure that can drop.
+	auto it = std::find_if(treasures.rbegin(), treasures.rend(), [](const Treasure& t)
+	{
+		return t.dropRate > 0.0f;
+	});
+	return it != treasures.rend() ? *it : Treasure();
 }
 
 //---------------------------------------------------------------
@@ -75,13 +108,13 @@ Treasure LootTable::Roll() const
 	// if not, then roll each of the other tables.
 
 
-void Monster::RerollLoot()
+void Monster::RerollLoot(RngState& rng)
 {
 	lootDrops.clear();
 
 	// Drop rates imply mutual exclusivity.
 	// Split tables that have drop rates from tables that drop no matter what.
-	auto it = std::partition(std::begin(tables), std::end(tables),
+	auto it = std::stable_partition(std::begin(tables), std::end(tables),
 		[](const LootTable& table)
 	{
 		return table.dropRate != 1.0f;
@@ -100,7 +133,7 @@ void Monster::RerollLoot()
 	}
 	dropRates.push_back(1.0f - exclusiveTableDropRate);
 
-	float randomNumber = GetRandomFloat(0.0f, 1.0f);
+	float randomNumber = NextRandomFloat(rng, 0.0f, 1.0f);
 
 	size_t tableIndex = 0;
 	for (; tableIndex < dropRates.size(); ++tableIndex)
@@ -117,59 +150,115 @@ void Monster::RerollLoot()
 	// we'll pick from the other tables.
 	if (tableIndex < numExclusive)
 	{
-		lootDrops.push_back(tables[tableIndex].Roll());
+		lootDrops.push_back(tables[tableIndex].Roll(rng));
 		return;
 	}
 
 	// Tables which have a 100% drop rate will all roll a loot piece.
 	for (size_t i = numExclusive; i < tables.size(); ++i)
 	{
-		lootDrops.push_back(tables[i].Roll());
+		lootDrops.push_back(tables[i].Roll(rng));
 	}
 }
 
 //---------------------------------------------------------------
 
-static const std::string s_monsterData = "../resources/monsters.json";
-static const std::string s_test = "../resources/loot-tables/variety-tier-1.json";
+// Content paths are relative to the repository root, one up from where we run.
+static const std::string s_contentRoot = "..";
 
 Game::Game()
 	: m_events(std::make_unique<GameEvents>())
+	, m_rng(SeedRngFromDevice())
+{
+}
+
+void Game::SetSeed(uint64_t seed)
+{
+	m_rng = SeedRng(seed);
+}
+
+void Game::SetShardCount(int32_t shardCount)
 {
+	m_shardCount = std::max(shardCount, 1);
 }
 
 bool Game::LoadData()
 {
+	TRACE_SCOPE("LoadData");
+	PerfCounters::ScopedPhase perfPhase("LoadData");
+
+	std::vector<EncounterTable> encounterTables;
+#if LOOTSIM_BAKED_CONTENT
+	CreateBakedMonsters(s_bakedMonsters, s_bakedTreasureNames, m_strings, m_monsterData);
+	CreateBakedEncounterTables(s_bakedEncounters, m_strings, encounterTables);
+	m_pityRules.assign(std::begin(s_bakedPityRules), std::end(s_bakedPityRules));
+	m_treasureValues.assign(std::begin(s_bakedTreasureValues), std::end(s_bakedTreasureValues));
+#else
 	// All of our data is defined here.
-	std::ifstream fileStream(s_monsterData);
-	if (!fileStream.is_open())
+	std::string error;
+	if (!LoadContent(s_contentRoot, m_monsterData, m_strings, error)
+		|| !LoadEncounterTables(s_contentRoot, m_monsterData, m_strings, encounterTables, error)
+		|| !LoadPityRules(s_contentRoot, m_monsterData, m_pityRules, error)
+		|| !LoadTreasureValues(s_contentRoot, m_treasureValues, error))
 	{
-		LOG_DEBUG("Could not open file. file=" + s_monsterData);
+		LOG_ERROR("Could not load content. {}", error);
 		return false;
 	}
+#endif
 
-	using json = nlohmann::json;
-	json monsterJsonData;
-	fileStream >> monsterJsonData;
-
-	uint32_t numMonsterTypes = monsterJsonData["numMonsterTypes"];
+	if (!encounterTables.empty())
+	{
+		auto it = m_zone.empty() ? std::begin(encounterTables)
+			: std::find_if(std::begin(encounterTables), std::end(encounterTables), [this](const EncounterTable& table)
+		{
+			return m_strings.Get(table.zoneId) == m_zone;
+		});
 
-	for (const auto& monsterJson: monsterJsonData["monsters"])
+		if (it == std::end(encounterTables))
+		{
+			LOG_ERROR("Unknown zone. zone={}", m_zone);
+			return false;
+		}
+		m_encounterTable = std::move(*it);
+	}
+	else if (!m_zone.empty())
 	{
-		m_monsterData.insert(monsterJson.get<Monster>());
+		LOG_ERROR("The content has no zones. zone={}", m_zone);
+		return false;
 	}
 
 	for (const auto& monster : m_monsterData)
 	{
+		size_t monsterIndex = static_cast<size_t>(monster.type);
+		if (monsterIndex < s_numMonsterTypes)
+		{
+			m_monsterNames[monsterIndex] = m_strings.Get(monster.nameId);
+		}
+
 		for (const auto& table : monster.tables)
 		{
 			for (const auto& treasure : table.treasures)
 			{
-				m_treasureData.insert(treasure);
+				// The first name seen for a type wins, should tables disagree.
+				size_t treasureIndex = static_cast<size_t>(treasure.type);
+				if (treasureIndex < s_numTreasureTypes && m_treasureNames[treasureIndex].empty())
+				{
+					m_treasureNames[treasureIndex] = m_strings.Get(treasure.nameId);
+				}
 			}
 		}
 	}
 
+	ComputeContentHash();
+
+	m_lootModel = LootModel(m_monsterData, encounterTables.empty() ? nullptr : &m_encounterTable);
+	if (m_lootModel.GetMaxDropCount() > s_maxDropsPerKill)
+	{
+		LOG_ERROR("A monster can drop more than {} items at once. drops={}", s_maxDropsPerKill,
+			m_lootModel.GetMaxDropCount());
+		return false;
+	}
+
 	m_isDataLoaded = true;
 	m_events->GetLoadingCompleteEvent().notify();
 
@@ -178,6 +267,8 @@ bool Game::LoadData()
 
 void Game::SlayMonster(std::optional<MonsterType> type)
 {
+	TRACE_SCOPE("SlayMonster");
+
 	m_droppedLootMap.clear();
 	if (!m_isDataLoaded)
 	{
@@ -185,41 +276,38 @@ void Game::SlayMonster(std::optional<MonsterType> type)
 		return;
 	}
 
-	LootSession lootSession;
-
-	Monster& m = type != std::nullopt
-		? CreateMonsterForType(type.value())
-		: CreateRandomMonster();
+	ScopedLatency latency(m_slayLatency);
 
-	lootSession.monsterCounts[m.type]++;
+	LootSession lootSession;
+	if (SimulateKill(type, m_rng, lootSession))
+	{
+		ReportLoot(lootSession);
+	}
+}
 
-	m.RerollLoot();
+bool Game::SimulateKill(std::optional<MonsterType> type, RngState& rng, LootSession& lootSession) const
+{
+	MonsterType monsterType = type.has_value() ? type.value() : m_lootModel.RollMonsterType(rng);
+	lootSession.monsterCounts[monsterType]++;
 
-	std::vector<std::string> lootNames;
-	std::transform(std::cbegin(m.lootDrops), std::cend(m.lootDrops),
-		std::back_inserter(lootNames),
-		[](const Treasure& t)
+	TreasureType drops[s_maxDropsPerKill];
+	size_t dropCount = RollKill(m_lootModel, monsterType, m_magicFindBucket, rng, drops);
+	if (dropCount == 0)
 	{
-		return t.name;
-	});
+		return false;
+	}
 
-	if (!lootNames.empty())
-	{
-		// Begin populating the results.
-		TreasureMap treasures = lootSession.lootMap[m.type];
-		for (auto treasure : m.lootDrops)
-		{
-			// Insert into the map if it doesn't exist and increment its count.
-			treasures[treasure.type]++;
-		}
+	AddDrops(m_lootModel, monsterType, drops, dropCount, rng, lootSession);
+	lootSession.monsters.insert(monsterType);
+	return true;
+}
 
-		lootSession.lootMap[m.type] = treasures;
-		lootSession.monsters.insert(m.type);
-		m_events->GetLootDroppedEvent().notify(lootSession);
-	}
+size_t Game::RollDrops(MonsterType type, RngState& rng, TreasureType (&drops)[s_maxDropsPerKill]) const
+{
+	return RollKill(m_lootModel, type, m_magicFindBucket, rng, drops);
 }
 
-void Game::SlayBatchOfMonsters(int32_t count, std::optional<MonsterType> type)
+void Game::SlayBatchOfMonsters(int64_t count, std::optional<MonsterType> type)
 {
 	if (!m_isDataLoaded)
 	{
@@ -229,158 +317,345 @@ void Game::SlayBatchOfMonsters(int32_t count, std::optional<MonsterType> type)
 
 	m_droppedLootMap.clear();
 
-	LootSession lootSession;
-
 	// We're going to build a large pile of loot and report the results.
 	// This is simply so the console doesn't scroll forever on large numbers
 	// of monster slayings requested.
-
-	bool isRandom = !type.has_value();
-	Monster m = !isRandom
-		? CreateMonsterForType(type.value())
-		: CreateRandomMonster();
-
-	int remaining = count;
-	while (remaining--)
+	std::vector<LootSession> lootSessions(1);
+	if (!m_workers.empty())
 	{
-		// If we weren't given a type then every monster will be random.
-		if (isRandom)
+		SimulationJob job;
+		job.type = type;
+		job.count = count;
+		job.seed = NextRandom(m_rng);
+		job.contentHash = m_contentHash;
+		job.shardCount = std::max(m_shardCount, static_cast<int32_t>(m_workers.size()));
+
+		// The kills happen on the workers, so this thread only counts its wait for them.
+		PerfCounters::ScopedPhase perfPhase("WorkerWait");
+		if (!SimulateDistributed(job, m_workers, lootSessions.front()))
 		{
-			m = CreateRandomMonster();
+			m_events->GetGameErrorEvent().notify("Distributed simulation failed.");
+			return;
+		}
+	}
+	else if (m_shardCount > 1)
+	{
+		// Each run gets its own seed off of our stream so repeated runs differ but the
+		// whole sequence still follows from the game's seed. The kills happen in the shard
+		// processes, so this thread only counts its wait for them.
+		PerfCounters::ScopedPhase perfPhase("ShardWait");
+		if (!SimulateSharded(*this, count, type, NextRandom(m_rng), m_shardCount,
+			lootSessions.front()))
+		{
+			m_events->GetGameErrorEvent().notify("Sharded simulation failed.");
+			return;
+		}
+	}
+	else
+	{
+		BatchCheckpoint checkpoint;
+		checkpoint.contentHash = m_contentHash;
+		checkpoint.type = type.value_or(MonsterType::NONE);
+		checkpoint.totalCount = count;
+		checkpoint.remainingCount = count;
+		checkpoint.rng = m_rng;
+		if (!type.has_value())
+		{
+			m_lootModel.RollMonsterCounts(count, checkpoint.rng, checkpoint.typeCounts);
 		}
 
-		lootSession.monsterCounts[m.type]++;
-		m.RerollLoot();
-
-		// Begin populating the results.
-		TreasureMap treasures = lootSession.lootMap[m.type];
-		for (auto treasure : m.lootDrops)
 		{
-			// Insert into the map if it doesn't exist and increment its count.
-			treasures[treasure.type]++;
+			PerfCounters::ScopedPhase perfPhase("BatchLoop");
+			perfPhase.SetKillCount(count);
+			RunCheckpointedBatch(checkpoint);
 		}
 
-		lootSession.lootMap[m.type] = treasures;
-		lootSession.monsters.insert(m.type);
+		m_rng = checkpoint.rng;
+
+		TRACE_SCOPE("MergeResults");
+		PerfCounters::ScopedPhase perfPhase("MergeResults");
+		AppendToLootSession(checkpoint.counters, lootSessions.front());
 	}
 
-	m_events->GetLootDroppedEvent().notify(lootSession);
+	// Batches only count drops. Quantities are drawn in bulk from the final counts, so they
+	// don't depend on how the batch was split up.
+	m_lootModel.RollSessionQuantities(lootSessions.front(), m_rng);
+	ReportLoot(lootSessions.front());
 }
 
-const std::string& Game::GetMonsterName(MonsterType type)
+bool Game::ResumeBatchOfMonsters(const std::string& checkpointPath)
 {
-	auto it = std::find_if(std::begin(m_monsterData), std::end(m_monsterData),
-		[type](const Monster& monster)
+	if (!m_isDataLoaded)
 	{
-		return monster.type == type;
-	});
+		LOG_DEBUG("Attempted to say monster with no data loaded.");
+		return false;
+	}
 
-	return it->name;
-}
+	BatchCheckpoint checkpoint;
+	if (!LoadCheckpoint(checkpointPath, checkpoint))
+	{
+		m_events->GetGameErrorEvent().notify("Could not load checkpoint " + checkpointPath);
+		return false;
+	}
 
-const std::string& Game::GetTreasureName(TreasureType type)
-{
-	auto it = std::find_if(std::begin(m_treasureData), std::end(m_treasureData),
-		[type](const Treasure& treasure)
-		{
-			return treasure.type == type;
-		});
+	if (checkpoint.contentHash != m_contentHash)
+	{
+		m_events->GetGameErrorEvent().notify("Checkpoint was made with different content.");
+		return false;
+	}
+
+	{
+		PerfCounters::ScopedPhase perfPhase("BatchLoop");
+		perfPhase.SetKillCount(checkpoint.remainingCount);
+		RunCheckpointedBatch(checkpoint);
+	}
+
+	LootSession lootSession;
+	{
+		TRACE_SCOPE("MergeResults");
+		PerfCounters::ScopedPhase perfPhase("MergeResults");
+		AppendToLootSession(checkpoint.counters, lootSession);
+	}
 
-	return it->name;
+	// Continues from the stream an uninterrupted batch would have had, so quantities agree.
+	RngState rng = checkpoint.rng;
+	m_lootModel.RollSessionQuantities(lootSession, rng);
+	ReportLoot(lootSession);
+	return true;
 }
 
-Monster Game::CreateRandomMonster()
+void Game::SetCheckpointing(const std::string& checkpointPath, int64_t checkpointInterval)
 {
-	int32_t randomNumber = GetRandomInt(0, static_cast<int32_t>(MonsterType::NUM_TYPES) - 1);
-	return CreateMonsterForType(static_cast<MonsterType>(randomNumber));
+	m_checkpointPath = checkpointPath;
+	m_checkpointInterval = std::max<int64_t>(checkpointInterval, 1);
 }
 
-Monster Game::CreateMonsterForType(MonsterType type)
+void Game::RunCheckpointedBatch(BatchCheckpoint& checkpoint)
 {
-	auto it = std::find_if(std::begin(m_monsterData), std::end(m_monsterData),
-		[type](const Monster& monster)
+	std::optional<MonsterType> type;
+	if (checkpoint.type != MonsterType::NONE)
 	{
-		return monster.type == type;
-	});
-
-	return *it;
-}
+		type = checkpoint.type;
+	}
 
+	bool isCheckpointing = !m_checkpointPath.empty();
+	int64_t interval = isCheckpointing ? m_checkpointInterval : checkpoint.remainingCount;
+	StatsProgress progress(checkpoint.remainingCount);
 
-//---------------------------------------------------------------
-// nlohmann::json helpers.
+	// Chunk boundaries don't affect the draws, so a resumed run matches an uninterrupted one.
+	while (checkpoint.remainingCount > 0)
+	{
+		int64_t chunk = std::min(interval, checkpoint.remainingCount);
+		if (type.has_value())
+		{
+			SimulateBatch(chunk, type, checkpoint.rng, checkpoint.counters, &progress);
+		}
+		else
+		{
+			// Random batches carry on through the types where the last chunk stopped.
+			int64_t chunkLeft = chunk;
+			for (size_t i = 0; i < s_numMonsterTypes && chunkLeft > 0; ++i)
+			{
+				int64_t typeLeft = checkpoint.typeCounts[i] - checkpoint.counters.monsterCounts[i];
+				int64_t typeChunk = std::min(typeLeft, chunkLeft);
+				SimulateBatch(typeChunk, static_cast<MonsterType>(i), checkpoint.rng, checkpoint.counters, &progress);
+				chunkLeft -= typeChunk;
+			}
+		}
+		checkpoint.remainingCount -= chunk;
 
-void to_json(json& j, const Monster& m)
-{
-	j = json {
-		{ "name", m.name },
-		{ "type", m.type },
-		{ "lootData", m.tables }
-	};
+		// Losing a checkpoint only costs us the ability to resume, so keep going.
+		TRACE_SCOPE("SaveCheckpoint");
+		if (isCheckpointing && !SaveCheckpoint(m_checkpointPath, checkpoint))
+		{
+			LOG_WARNING("Could not save checkpoint. file={}", m_checkpointPath);
+		}
+	}
 }
 
-void from_json(const json& j, Monster& m)
+void Game::SimulatePartitionedBatch(std::optional<MonsterType> type,
+	const std::vector<int32_t>& counts, std::vector<LootSession>& sessions)
 {
-	j.at("name").get_to(m.name);
-	j.at("type").get_to(m.type);
-	j.at("tables").get_to(m.tables);
-}
+	TRACE_SCOPE("SimulatePartitionedBatch");
 
-void to_json(json& j, const LootTable& table)
-{
-	j = json {
-		{ "dropRate", table.dropRate },
-		{ "path", table.path }
-	};
+	sessions.resize(counts.size());
+	if (!m_isDataLoaded)
+	{
+		LOG_DEBUG("Attempted to say monster with no data loaded.");
+		return;
+	}
+
+	// Settle each partition's monsters up front, then slay every kill of a type as one bulk
+	// batch. Kills are independent, so which partition each monster went to can be decided
+	// afterwards: drops are shared out one partition at a time, each taking a binomial share
+	// of what is left in proportion to its share of the kills that are left.
+	std::vector<LootCounters> partitions(counts.size());
+	LootCounters bulkCounters;
+	for (size_t i = 0; i < counts.size(); ++i)
+	{
+		if (type.has_value())
+		{
+			partitions[i].monsterCounts[static_cast<size_t>(type.value())] = counts[i];
+		}
+		else
+		{
+			m_lootModel.RollMonsterCounts(counts[i], m_rng, partitions[i].monsterCounts);
+		}
+		for (size_t m = 0; m < s_numMonsterTypes; ++m)
+		{
+			bulkCounters.monsterCounts[m] += partitions[i].monsterCounts[m];
+		}
+	}
+
+	StatsProgress progress(std::accumulate(std::begin(counts), std::end(counts), int64_t(0)));
+	for (size_t m = 0; m < s_numMonsterTypes; ++m)
+	{
+		int64_t remainingKills = bulkCounters.monsterCounts[m];
+		if (remainingKills == 0)
+		{
+			continue;
+		}
+
+		// SimulateBatch adds the kills to the counters again.
+		bulkCounters.monsterCounts[m] = 0;
+		SimulateBatch(remainingKills, static_cast<MonsterType>(m), m_rng, bulkCounters, &progress);
+
+		int64_t* remainingDrops = bulkCounters.lootCounts[m];
+		for (LootCounters& partition : partitions)
+		{
+			int64_t kills = partition.monsterCounts[m];
+			double share = static_cast<double>(kills) / static_cast<double>(remainingKills);
+			for (size_t t = 0; t < s_numTreasureTypes; ++t)
+			{
+				int64_t drops = kills == remainingKills ? remainingDrops[t]
+					: NextRandomBinomial(m_rng, remainingDrops[t], share);
+				partition.lootCounts[m][t] = drops;
+				remainingDrops[t] -= drops;
+			}
+			remainingKills -= kills;
+		}
+	}
+
+	for (size_t i = 0; i < counts.size(); ++i)
+	{
+		AppendToLootSession(partitions[i], sessions[i]);
+		m_lootModel.RollSessionQuantities(sessions[i], m_rng);
+	}
 }
 
-void from_json(const json& j, LootTable& table)
+void Game::SimulateBatch(int64_t count, std::optional<MonsterType> type, RngState& rng,
+	LootCounters& counters, StatsProgress* progress)
 {
-	// Set some optional data.
-	// Tables are not required to have a drop rate and default to 100%.
-	if (j.find("dropRate") != j.end())
+	TRACE_SCOPE("SimulateBatch");
+	TRACE_COUNTER("BatchKills", count);
+
+	if (!m_isDataLoaded)
 	{
-		j.at("dropRate").get_to(table.dropRate);
+		LOG_DEBUG("Attempted to say monster with no data loaded.");
+		return;
 	}
 
-	// Find and populate treasures.
-	j.at("path").get_to(table.path);
+	// Batches that are run in pieces report against the whole rather than each piece.
+	std::optional<StatsProgress> ownProgress;
+	if (!progress)
+	{
+		progress = &ownProgress.emplace(count);
+	}
 
-	std::vector<Treasure> treasures;
-	std::ifstream fileStream(GetRelativePath(table.path));
-	if (!fileStream.is_open())
+	// Random batches settle how many of each monster spawn up front, then run each type
+	// as a fixed type batch.
+	if (!type.has_value())
 	{
-		LOG_DEBUG("Could not open treasure data file. file=" + table.path);
+		int64_t typeCounts[s_numMonsterTypes];
+		m_lootModel.RollMonsterCounts(count, rng, typeCounts);
+		for (size_t i = 0; i < s_numMonsterTypes; ++i)
+		{
+			SimulateBatch(typeCounts[i], static_cast<MonsterType>(i), rng, counters, progress);
+		}
 		return;
 	}
 
-	json treasureJsonData;
-	fileStream >> treasureJsonData;
-	treasures.reserve(treasures.size() + treasureJsonData["numItems"]);
+	MonsterType monsterType = type.value();
+	size_t monsterIndex = static_cast<size_t>(monsterType);
+	counters.monsterCounts[monsterIndex] += count;
 
-	for (const auto& treasureData : treasureJsonData["items"])
+	TreasureType drops[s_maxDropsPerKill];
+	while (count-- > 0)
 	{
-		treasures.emplace_back(treasureData.get<Treasure>());
+		size_t dropCount = RollKill(m_lootModel, monsterType, m_magicFindBucket, rng, drops);
+		for (size_t i = 0; i < dropCount; ++i)
+		{
+			// NONE would index before the start of the counters.
+			size_t treasureIndex = static_cast<size_t>(drops[i]);
+			if (treasureIndex < s_numTreasureTypes)
+			{
+				counters.lootCounts[monsterIndex][treasureIndex]++;
+			}
+		}
+
+		progress->AddKill(dropCount);
 	}
+}
 
-	table.treasures = std::move(treasures);
+std::string_view Game::GetMonsterName(MonsterType type) const
+{
+	size_t index = static_cast<size_t>(type);
+	return index < s_numMonsterTypes ? m_monsterNames[index] : std::string_view();
+}
 
+std::string_view Game::GetTreasureName(TreasureType type) const
+{
+	size_t index = static_cast<size_t>(type);
+	return index < s_numTreasureTypes ? m_treasureNames[index] : std::string_view();
 }
 
-void to_json(json& j, const Treasure& treasure)
+void Game::ReportLoot(const LootSession& lootSession)
 {
-	j = json {
-		{ "type", treasure.type },
-		{ "name", treasure.name },
-		{ "dropRate", treasure.dropRate }
-	};
+	// Listeners run inside notify, so this is where reporting time shows up.
+	TRACE_SCOPE("ReportLoot");
+	m_events->GetLootDroppedEvent().notify(lootSession);
 }
 
-void from_json(const json& j, Treasure& treasure)
+void Game::ComputeContentHash()
 {
-	j.at("type").get_to(treasure.type);
-	j.at("name").get_to(treasure.name);
-	j.at("dropRate").get_to(treasure.dropRate);
+	// FNV-1a over every value that affects a roll.
+	uint64_t hash = 14695981039346656037ull;
+	auto hashBytes = [&hash](const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+	};
+
+	for (const Monster& monster : m_monsterData)
+	{
+		hashBytes(&monster.type, sizeof(monster.type));
+		for (const LootTable& table : monster.tables)
+		{
+			hashBytes(table.path.data(), table.path.size());
+			hashBytes(&table.dropRate, sizeof(table.dropRate));
+			for (const Treasure& treasure : table.treasures)
+			{
+				hashBytes(&treasure.type, sizeof(treasure.type));
+				hashBytes(&treasure.dropRate, sizeof(treasure.dropRate));
+				hashBytes(&treasure.minQuantity, sizeof(treasure.minQuantity));
+				hashBytes(&treasure.maxQuantity, sizeof(treasure.maxQuantity));
+			}
+		}
+	}
+
+	for (const Encounter& encounter : m_encounterTable.encounters)
+	{
+		hashBytes(&encounter.type, sizeof(encounter.type));
+		hashBytes(&encounter.weight, sizeof(encounter.weight));
+	}
+
+	hashBytes(&m_magicFindBucket, sizeof(m_magicFindBucket));
+
+	m_contentHash = hash;
 }
 
 //===============================================================
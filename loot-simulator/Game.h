@@ -5,20 +5,29 @@
 
 #pragma once
 
+#include "DistributedSimulation.h"
 #include "GameTypes.h"
 #include "GameEvents.h"
+#include "LatencyHistogram.h"
+#include "LootCounters.h"
+#include "LootModel.h"
+#include "Random.h"
+#include "StringPool.h"
 #include "nlohmann/json/json.hpp"
 
 #include <memory>
 #include <optional>
 #include <set>
+#include <string_view>
 #include <vector>
 
 namespace LootSimulator {
 
 //===============================================================
 
+struct BatchCheckpoint;
 class GameEvents;
+class StatsProgress;
 class Game {
 public:
 	Game();
@@ -26,20 +35,91 @@ public:
 	// Populates all of our monsters from the data files.
 	bool LoadData();
 
-	// Slay a single monster. If type is not set, we'll pick random types.
+	// Slay a single monster. If type is not set, we'll pick random types. How long each
+	// call takes, reporting included, goes into GetSlayLatency.
 	void SlayMonster(std::optional<MonsterType> type);
 
-	// Slay many monsters. If type is not set, we'll pick random types.
-	void SlayBatchOfMonsters(int32_t count, std::optional<MonsterType> type);
+	// The kill SlayMonster makes, drawing from the given stream and adding to lootSession
+	// without notifying anyone. Only reads loaded data, so any number of threads can call
+	// it at once. Returns whether anything dropped.
+	bool SimulateKill(std::optional<MonsterType> type, RngState& rng, LootSession& lootSession) const;
+
+	// One kill's drops, counted nowhere, rolled the way every kill of the game is. Only
+	// reads loaded data, so any number of threads can call it at once.
+	size_t RollDrops(MonsterType type, RngState& rng, TreasureType (&drops)[s_maxDropsPerKill]) const;
+
+	// Slay many monsters. If type is not set, we'll pick random types. Progress is saved
+	// along the way if checkpointing is on and the batch runs in process.
+	void SlayBatchOfMonsters(int64_t count, std::optional<MonsterType> type);
+
+	// Continues a batch from a checkpoint file and reports it like SlayBatchOfMonsters. The
+	// result is identical to the batch having never stopped.
+	bool ResumeBatchOfMonsters(const std::string& checkpointPath);
+
+	// Saves a checkpoint every checkpointInterval kills. An empty path turns it off.
+	void SetCheckpointing(const std::string& checkpointPath, int64_t checkpointInterval);
+
+	// Slay the sum of counts monsters as one bulk batch per monster type without notifying
+	// anyone, then split the kills so that sessions[i] receives counts[i] of them.
+	void SimulatePartitionedBatch(std::optional<MonsterType> type,
+		const std::vector<int32_t>& counts, std::vector<LootSession>& sessions);
+
+	// Slay count monsters into dense counters, drawing from the given stream. Nothing is
+	// notified and the game's own stream is left alone, so this is safe to use for shards.
+	// Progress goes to live stats, through the given progress if the batch is part of a
+	// larger one.
+	void SimulateBatch(int64_t count, std::optional<MonsterType> type, RngState& rng,
+		LootCounters& counters, StatsProgress* progress = nullptr);
+
+	// Reseeds the game's stream. Runs are repeatable for a given seed and shard count.
+	void SetSeed(uint64_t seed);
+
+	// Random kills spawn monsters by this zone's encounter table. Empty picks the first
+	// zone in the content. Takes effect on LoadData.
+	void SetZone(const std::string& zone) { m_zone = zone; }
+
+	// Every kill rolls with this magic find, as a fraction: 0.5 for +50%. See
+	// LootModel::RollLoot. Takes effect on LoadData.
+	void SetMagicFind(float magicFind) { m_magicFindBucket = GetMagicFindBucket(magicFind); }
+
+	// Magic find bucket every kill rolls in, for working out what kills should drop.
+	uint32_t GetKillMagicFindBucket() const { return m_magicFindBucket; }
+
+	// Batches are split across this many worker processes. 1 runs in process.
+	void SetShardCount(int32_t shardCount);
+
+	// Batches are sent to these workers over TCP instead. Empty runs them here.
+	void SetDistributedWorkers(const std::vector<WorkerAddress>& workers) { m_workers = workers; }
+
+	// Whether LoadData succeeded. Nothing can be slain until it has.
+	bool IsDataLoaded() const { return m_isDataLoaded; }
+
+	// Identifies the loaded content. Changes whenever any monster, table, treasure, the
+	// zone's encounters or the magic find do.
+	uint64_t GetContentHash() const { return m_contentHash; }
+
+	// What every kill rolls against. Empty until LoadData.
+	const LootModel& GetLootModel() const { return m_lootModel; }
+
+	// Bad luck protection from the content. Only pity simulations use it.
+	const std::vector<PityRule>& GetPityRules() const { return m_pityRules; }
+
+	// Gold values from the content. Only loot value reports use them.
+	const std::vector<TreasureValue>& GetTreasureValues() const { return m_treasureValues; }
+
+	// Nanoseconds taken by every SlayMonster call so far.
+	const LatencyHistogram& GetSlayLatency() const { return m_slayLatency; }
 
 	GameEvents& GetGameEvents() { return *m_events.get(); };
-	const std::string& GetMonsterName(MonsterType type);
-	const std::string& GetTreasureName(TreasureType type);
+	// Names come from the string pool. Empty for types that weren't loaded.
+	std::string_view GetMonsterName(MonsterType type) const;
+	std::string_view GetTreasureName(TreasureType type) const;
 	const std::set<Monster>& GetMonsters() { return m_monsterData; }
 
 private:
-	Monster CreateRandomMonster();
-	Monster CreateMonsterForType(MonsterType type);
+	void ComputeContentHash();
+	void RunCheckpointedBatch(BatchCheckpoint& checkpoint);
+	void ReportLoot(const LootSession& lootSession);
 
 private:
 	// Events for us to fire when interesting things happen.
@@ -48,26 +128,41 @@ private:
 	// One of each monster goes here, populated from data.
 	std::set<Monster> m_monsterData;
 
-	// Aggregate of all treasure items.
-	std::set<Treasure> m_treasureData;
+	// Every name in the content, and views into it by type for display.
+	StringPool m_strings;
+	std::string_view m_monsterNames[s_numMonsterTypes];
+	std::string_view m_treasureNames[s_numTreasureTypes];
+
+	// Spawn weights of the zone random kills happen in. Empty if the content has no zones.
+	std::string m_zone;
+	EncounterTable m_encounterTable;
+
+	// Monster data compiled for rolling.
+	LootModel m_lootModel;
+	uint32_t m_magicFindBucket = 0;
+
+	std::vector<PityRule> m_pityRules;
+	std::vector<TreasureValue> m_treasureValues;
 
 	// Used to track loot history.
 	LootMap m_droppedLootMap;
 
-	bool m_isDataLoaded = false;
-};
+	// Every roll the game makes on its own behalf comes from here.
+	RngState m_rng;
 
-// nlohmann::json helpers.
+	int32_t m_shardCount = 1;
+	std::vector<WorkerAddress> m_workers;
 
-using nlohmann::json;
-void to_json(json& j, const Monster& m);
-void from_json(const json& j, Monster& m);
+	std::string m_checkpointPath;
+	int64_t m_checkpointInterval = 0;
 
-void to_json(json& j, const LootTable& m);
-void from_json(const json& j, LootTable& m);
+	// Hash of everything LoadData populated.
+	uint64_t m_contentHash = 0;
 
-void to_json(json& j, const Treasure& m);
-void from_json(const json& j, Treasure& m);
+	LatencyHistogram m_slayLatency;
+
+	bool m_isDataLoaded = false;
+};
 
 //===============================================================
 
@@ -5,15 +5,26 @@
 
 #include "GameController.h"
 
+#include "CompletionTime.h"
+#include "DistributedSimulation.h"
+#include "DropCombinations.h"
+#include "DropDistribution.h"
 #include "Game.h"
 #include "GameView.h"
+#include "LatencyBenchmark.h"
+#include "Log.h"
+#include "LootValue.h"
+#include "PitySimulation.h"
+#include "PopulationSimulation.h"
+#include "SimulationService.h"
 
 #include <algorithm>
+#include <future>
 #include <string>
 #include <sstream>
-#include <iomanip>
 #include <iterator>
 #include <iostream>
+#include <thread>
 
 namespace LootSimulator {
 
@@ -26,10 +37,48 @@ namespace LootSimulator {
 	// Min and Max number of monsters to slay.
 	static const std::pair<int32_t, int32_t> s_validCountRange = { 0, 99999 };
 
-GameController::GameController()
+	// Kills per thread for the latency benchmark if --batch doesn't say.
+	static const int64_t s_defaultLatencyKills = 1000000;
+
+	// Kills per player for pity simulations if --batch doesn't say.
+	static const int64_t s_defaultPityKills = 100;
+
+	// Kills per player for population simulations if --batch doesn't say.
+	static const int64_t s_defaultPopulationKills = 500;
+
+	// Kills for drop distributions if --batch doesn't say.
+	static const int64_t s_defaultDistributionKills = 1000;
+
+	// Players simulated for sets too large to work out exactly.
+	static const int64_t s_completionPlayerCount = 100000;
+
+	// Kills for drop combinations if --batch doesn't say.
+	static const int64_t s_defaultCombinationKills = 1000000;
+
+	// Kills for loot value reports if --batch doesn't say.
+	static const int64_t s_defaultValueKills = 1000000;
+
+	// Kills split between simulation service clients if --batch doesn't say.
+	static const int64_t s_defaultServedKills = 1000000;
+
+GameController::GameController(const SimulationOptions& options)
 	: m_game(std::make_unique<Game>())
 	, m_view(std::make_unique<GameView>(this))
+	, m_options(options)
 {
+	if (m_options.seed.has_value())
+	{
+		m_game->SetSeed(m_options.seed.value());
+	}
+	m_game->SetShardCount(m_options.shardCount);
+	m_game->SetZone(m_options.zone);
+	m_game->SetMagicFind(static_cast<float>(m_options.magicFindPercent) / 100.0f);
+
+	// A resumed batch keeps saving to the file it came from unless told otherwise.
+	const std::string& checkpointPath = m_options.checkpointPath.empty()
+		? m_options.resumePath
+		: m_options.checkpointPath;
+	m_game->SetCheckpointing(checkpointPath, m_options.checkpointInterval);
 }
 
 GameController::~GameController()
@@ -37,15 +86,68 @@ GameController::~GameController()
 
 }
 
-void GameController::Run()
+bool GameController::Run()
 {
 	if (!m_game->LoadData())
 	{
-		return;
+		return false;
+	}
+
+	if (m_options.workerPort.has_value())
+	{
+		RunWorker();
+		return true;
+	}
+
+	if (m_options.latencyThreadCount > 0)
+	{
+		return RunLatencyBenchmark();
+	}
+
+	if (m_options.pityPlayerCount > 0)
+	{
+		return RunPitySimulation();
+	}
+
+	if (m_options.populationPlayerCount > 0)
+	{
+		return RunPopulationSimulation();
 	}
 
+	if (!m_options.distributionTreasure.empty())
+	{
+		return RunDropDistribution();
+	}
+
+	if (!m_options.collectTreasures.empty())
+	{
+		return RunCompletionTime();
+	}
+
+	if (m_options.isCountingCombinations)
+	{
+		return RunDropCombinations();
+	}
+
+	if (m_options.valueSessionKills > 0)
+	{
+		return RunLootValue();
+	}
+
+	if (m_options.clientCount > 0)
+	{
+		return RunServedBatch();
+	}
+
+	StartWorkers();
 	Initialize();
 
+	if (!m_options.resumePath.empty() || m_options.batchCount > 0)
+	{
+		RunBatch();
+		return true;
+	}
+
 	bool done = false;
 	while (!done)
 	{
@@ -81,6 +183,14 @@ void GameController::Run()
 
 		WaitForInput();
 	}
+
+	const LatencyHistogram& latency = m_game->GetSlayLatency();
+	if (latency.GetCount() > 0)
+	{
+		LOG_INFO("Single kill latency. kills={} p50={}ns p99={}ns max={}ns", latency.GetCount(),
+			latency.GetValueAtPercentile(50.0), latency.GetValueAtPercentile(99.0), latency.GetMax());
+	}
+	return true;
 }
 
 void GameController::Initialize()
@@ -92,17 +202,315 @@ void GameController::Initialize()
 	m_view->Initialize();
 }
 
+void GameController::RunWorker()
+{
+	SimulationWorker worker(*m_game);
+	if (!worker.Start("", m_options.workerPort.value()))
+	{
+		m_view->PrintErrorMessage("Could not listen on port " + std::to_string(m_options.workerPort.value()));
+		return;
+	}
+
+	m_view->PrintWorkerListening(worker.GetPort());
+	worker.Run();
+}
+
+void GameController::StartWorkers()
+{
+	std::vector<WorkerAddress> addresses;
+	if (!m_options.workerAddresses.empty()
+		&& !ParseWorkerAddresses(m_options.workerAddresses, addresses))
+	{
+		m_view->PrintErrorMessage("Ignoring invalid worker list. workers=" + m_options.workerAddresses);
+		addresses.clear();
+	}
+
+	if (m_options.localWorkerCount > 0)
+	{
+		m_localWorkers = StartLocalWorkers(*m_game, m_options.localWorkerCount, addresses);
+	}
+
+	m_game->SetDistributedWorkers(addresses);
+}
+
+void GameController::RunBatch()
+{
+	if (!m_options.resumePath.empty())
+	{
+		m_game->ResumeBatchOfMonsters(m_options.resumePath);
+		return;
+	}
+
+	std::optional<MonsterType> type;
+	if (!GetBatchMonsterType(type))
+	{
+		return;
+	}
+
+	m_game->SlayBatchOfMonsters(m_options.batchCount, type);
+}
+
+bool GameController::RunLatencyBenchmark()
+{
+	std::optional<MonsterType> type;
+	if (!GetBatchMonsterType(type))
+	{
+		return false;
+	}
+
+	int64_t killsPerThread = m_options.batchCount > 0 ? m_options.batchCount : s_defaultLatencyKills;
+	uint64_t seed = m_options.seed.value_or(0);
+	LatencyHistogram latency = LootSimulator::RunLatencyBenchmark(*m_game, type,
+		m_options.latencyThreadCount, killsPerThread, seed);
+
+	m_view->PrintLatencyReport(latency, m_options.latencyThreadCount);
+
+	if (!m_options.latencySloNanoseconds.has_value())
+	{
+		return true;
+	}
+
+	uint64_t slo = m_options.latencySloNanoseconds.value();
+	bool isWithinSlo = latency.GetValueAtPercentile(99.0) <= slo;
+	m_view->PrintLatencySlo(slo, isWithinSlo);
+	return isWithinSlo;
+}
+
+bool GameController::RunPitySimulation()
+{
+	std::optional<MonsterType> type;
+	if (!GetBatchMonsterType(type))
+	{
+		return false;
+	}
+
+	if (m_game->GetPityRules().empty())
+	{
+		m_view->PrintErrorMessage("The content has no pity rules.");
+		return false;
+	}
+
+	int64_t killsPerPlayer = m_options.batchCount > 0 ? m_options.batchCount : s_defaultPityKills;
+	uint64_t seed = m_options.seed.value_or(0);
+	std::vector<PityRuleReport> reports = LootSimulator::RunPitySimulation(*m_game, type,
+		m_options.pityPlayerCount, killsPerPlayer, seed);
+
+	m_view->PrintPityReports(reports, m_options.pityPlayerCount, killsPerPlayer);
+	return true;
+}
+
+bool GameController::RunPopulationSimulation()
+{
+	std::optional<MonsterType> type;
+	if (!GetBatchMonsterType(type))
+	{
+		return false;
+	}
+
+	int64_t killsPerPlayer = m_options.batchCount > 0 ? m_options.batchCount : s_defaultPopulationKills;
+	int32_t threadCount = std::max(static_cast<int32_t>(std::thread::hardware_concurrency()), 1);
+	uint64_t seed = m_options.seed.value_or(0);
+	PopulationReport report;
+	LootSimulator::RunPopulationSimulation(*m_game, type, m_options.populationPlayerCount,
+		killsPerPlayer, threadCount, seed, report);
+
+	m_view->PrintPopulationReport(report, killsPerPlayer);
+	return true;
+}
+
+bool GameController::RunDropDistribution()
+{
+	std::optional<MonsterType> type;
+	if (!GetBatchMonsterType(type))
+	{
+		return false;
+	}
+
+	TreasureType treasure = GetTreasureTypeFromId(m_options.distributionTreasure);
+	if (treasure == TreasureType::NONE)
+	{
+		m_view->PrintErrorMessage("Unknown treasure type. treasure=" + m_options.distributionTreasure);
+		return false;
+	}
+
+	int64_t killCount = m_options.batchCount > 0 ? m_options.batchCount : s_defaultDistributionKills;
+	uint32_t magicFindBucket = GetMagicFindBucket(static_cast<float>(m_options.magicFindPercent) / 100.0f);
+	DropDistribution distribution = GetDropDistribution(m_game->GetLootModel(), type, treasure,
+		magicFindBucket, killCount);
+
+	m_view->PrintDropDistribution(distribution, treasure, killCount);
+	return true;
+}
+
+bool GameController::RunCompletionTime()
+{
+	std::optional<MonsterType> type;
+	if (!GetBatchMonsterType(type))
+	{
+		return false;
+	}
+
+	std::vector<TreasureType> treasures;
+	std::stringstream ids(m_options.collectTreasures);
+	std::string id;
+	while (std::getline(ids, id, ','))
+	{
+		TreasureType treasure = GetTreasureTypeFromId(id);
+		if (treasure == TreasureType::NONE)
+		{
+			m_view->PrintErrorMessage("Unknown treasure type. treasure=" + id);
+			return false;
+		}
+
+		if (std::find(treasures.begin(), treasures.end(), treasure) == treasures.end())
+		{
+			treasures.push_back(treasure);
+		}
+	}
+
+	if (treasures.empty() || treasures.size() > s_maxCompletionSetSize)
+	{
+		m_view->PrintErrorMessage("Sets must have 1 to " + std::to_string(s_maxCompletionSetSize) + " treasures.");
+		return false;
+	}
+
+	uint32_t magicFindBucket = GetMagicFindBucket(static_cast<float>(m_options.magicFindPercent) / 100.0f);
+	int32_t threadCount = std::max(static_cast<int32_t>(std::thread::hardware_concurrency()), 1);
+	CompletionReport report = GetCompletionTime(m_game->GetLootModel(), type, treasures, magicFindBucket,
+		s_completionPlayerCount, threadCount, m_options.seed.value_or(0));
+
+	m_view->PrintCompletionReport(report, treasures.size());
+	return true;
+}
+
+bool GameController::RunDropCombinations()
+{
+	std::optional<MonsterType> type;
+	if (!GetBatchMonsterType(type))
+	{
+		return false;
+	}
+
+	int64_t killCount = m_options.batchCount > 0 ? m_options.batchCount : s_defaultCombinationKills;
+	int32_t threadCount = std::max(static_cast<int32_t>(std::thread::hardware_concurrency()), 1);
+	DropCombinationReport report;
+	LootSimulator::RunDropCombinations(*m_game, type, killCount, threadCount, m_options.seed.value_or(0), report);
+
+	m_view->PrintDropCombinations(report);
+	return true;
+}
+
+bool GameController::RunLootValue()
+{
+	std::optional<MonsterType> type;
+	if (!GetBatchMonsterType(type))
+	{
+		return false;
+	}
+
+	if (m_game->GetTreasureValues().empty())
+	{
+		m_view->PrintErrorMessage("The content has no treasure values.");
+		return false;
+	}
+
+	int64_t killCount = m_options.batchCount > 0 ? m_options.batchCount : s_defaultValueKills;
+	int32_t threadCount = std::max(static_cast<int32_t>(std::thread::hardware_concurrency()), 1);
+	LootValueReport report;
+	RunLootValueSimulation(*m_game, type, killCount, m_options.valueSessionKills, threadCount,
+		m_options.seed.value_or(0), report);
+
+	double values[s_numTreasureTypes];
+	GetTreasureValueTable(m_game->GetTreasureValues(), values);
+	uint32_t magicFindBucket = GetMagicFindBucket(static_cast<float>(m_options.magicFindPercent) / 100.0f);
+	double expectedMean = 0.0;
+	double expectedVariance = 0.0;
+	GetExpectedLootValue(m_game->GetLootModel(), type, values, magicFindBucket, expectedMean, expectedVariance);
+
+	m_view->PrintLootValueReport(report, expectedMean, expectedVariance);
+	return true;
+}
+
+bool GameController::RunServedBatch()
+{
+	std::optional<MonsterType> type;
+	if (!GetBatchMonsterType(type))
+	{
+		return false;
+	}
+
+	int64_t killCount = m_options.batchCount > 0 ? m_options.batchCount : s_defaultServedKills;
+	int64_t clientCount = m_options.clientCount;
+	if (killCount / clientCount >= INT32_MAX)
+	{
+		m_view->PrintErrorMessage("Requests can't be over " + std::to_string(INT32_MAX) + " kills each.");
+		return false;
+	}
+
+	// Every client asks at once, so the service gets the chance to serve them in one run.
+	SimulationService service(*m_game);
+	service.Start();
+
+	std::vector<std::future<SimulationResult>> results(static_cast<size_t>(clientCount));
+	std::vector<std::thread> clients;
+	for (int64_t i = 0; i < clientCount; ++i)
+	{
+		clients.emplace_back([&, i]()
+		{
+			SimulationRequest request;
+			request.type = type;
+			request.count = static_cast<int32_t>(killCount / clientCount + (i < killCount % clientCount ? 1 : 0));
+			request.contentVersion = m_game->GetContentHash();
+			results[static_cast<size_t>(i)] = service.Submit(request);
+		});
+	}
+	for (std::thread& client : clients)
+	{
+		client.join();
+	}
+
+	bool isSuccess = true;
+	std::vector<SimulationResult> served;
+	for (std::future<SimulationResult>& result : results)
+	{
+		served.push_back(result.get());
+		isSuccess &= served.back().success;
+	}
+
+	service.Stop();
+	m_view->PrintServedResults(served, killCount, service.GetRunCount());
+	return isSuccess;
+}
+
+bool GameController::GetBatchMonsterType(std::optional<MonsterType>& type)
+{
+	type.reset();
+	if (m_options.batchMonster.empty() || m_options.batchMonster == "random")
+	{
+		return true;
+	}
+
+	// Unknown ids come back as NONE.
+	type = GetMonsterTypeFromId(m_options.batchMonster);
+	if (type == MonsterType::NONE)
+	{
+		m_view->PrintErrorMessage("Unknown monster type. monster=" + m_options.batchMonster);
+		return false;
+	}
+	return true;
+}
+
 GameEvents& GameController::GetGameEvents()
 {
 	return m_game->GetGameEvents();
 }
 
-const std::string& GameController::GetMonsterName(MonsterType type)
+std::string_view GameController::GetMonsterName(MonsterType type)
 {
 	return m_game->GetMonsterName(type);
 }
 
-const std::string& GameController::GetTreasureName(TreasureType type)
+std::string_view GameController::GetTreasureName(TreasureType type)
 {
 	return m_game->GetTreasureName(type);
 }
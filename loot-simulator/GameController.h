@@ -6,10 +6,12 @@
 #pragma once
 
 #include "GameTypes.h"
+#include "SimulationOptions.h"
 
 #include <memory>
 #include <set>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -31,21 +33,35 @@ using UserSelection = std::pair<int32_t, int32_t>;
 class Game;
 class GameEvents;
 class GameView;
+class SimulationWorker;
 class GameController
 {
 public:
-	GameController();
+	GameController(const SimulationOptions& options);
 	~GameController();
 
-	void Run();
+	// Returns false if the run failed, e.g. data didn't load or a benchmark missed its SLO.
+	bool Run();
 	void Initialize();
 	GameEvents& GetGameEvents();
 
-	const std::string& GetMonsterName(MonsterType type);
-	const std::string& GetTreasureName(TreasureType type);
+	std::string_view GetMonsterName(MonsterType type);
+	std::string_view GetTreasureName(TreasureType type);
 	const std::set<Monster>& GetMonsters();;
 
 private:
+	void RunBatch();
+	bool RunLatencyBenchmark();
+	bool RunPitySimulation();
+	bool RunPopulationSimulation();
+	bool RunDropDistribution();
+	bool RunCompletionTime();
+	bool RunDropCombinations();
+	bool RunLootValue();
+	bool RunServedBatch();
+	bool GetBatchMonsterType(std::optional<MonsterType>& type);
+	void RunWorker();
+	void StartWorkers();
 	UserSelection GetMoveInput();
 	std::vector<std::string> TokenizeString(const std::string& input);
 	bool IsValidInput(const std::vector<std::string>& tokens);
@@ -55,6 +71,10 @@ private:
 private:
 	std::unique_ptr<Game> m_game;
 	std::unique_ptr<GameView> m_view;
+	SimulationOptions m_options;
+
+	// Localhost workers batches are sent to, if we were asked to start any.
+	std::vector<std::unique_ptr<SimulationWorker>> m_localWorkers;
 	std::pair<int32_t, int32_t> m_optionSelectionRange;
 };
 
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include "Random.h"
+#include "StringPool.h"
 #include "generated/EnumDataBindings.h"
 
 #include <set>
@@ -15,10 +17,10 @@
 namespace LootSimulator {
 
 // Treasure item, count.
-using TreasureMap = std::unordered_map<TreasureType, int32_t>;
+using TreasureMap = std::unordered_map<TreasureType, int64_t>;
 
 // Monster to count of monster.
-using MonsterCountMap = std::unordered_map<MonsterType, int32_t>;
+using MonsterCountMap = std::unordered_map<MonsterType, int64_t>;
 
 // Monster to treasure dropped.
 using LootMap = std::unordered_map <MonsterType, TreasureMap>;
@@ -34,6 +36,10 @@ struct LootSession {
 
 	// Records the loot that drops for each monster.
 	LootMap lootMap;
+
+	// Total quantity dropped, for treasures that drop in quantities. Others drop one at a
+	// time, so their count is their quantity.
+	LootMap quantityTotals;
 };
 
 struct Treasure
@@ -43,12 +49,17 @@ struct Treasure
 	// Indicates the type of item.
 	TreasureType type = TreasureType::NONE;
 
-	// Display name for this item.
-	std::string name;
+	// Display name for this item, in the content's StringPool.
+	StringId nameId = s_invalidStringId;
 
 	// Indicates how likely this item is to drop. 0.0f - 1.0f.
 	float dropRate = 0.0f;
 
+	// How many drop at once, uniform in [minQuantity, maxQuantity]. Entries of the same
+	// type with different ranges and weights make a weighted range.
+	int32_t minQuantity = 1;
+	int32_t maxQuantity = 1;
+
 	friend bool operator<(const Treasure& l, const Treasure& r)
 	{
 		return l.type < r.type; // keep the same order
@@ -57,7 +68,8 @@ struct Treasure
 
 struct LootTable
 {
-	Treasure Roll() const;
+	// Reference roll for LootModel, which is what the simulator rolls with. See Monster::RerollLoot.
+	Treasure Roll(RngState& rng) const;
 
 	//--------------------------
 	// Model data
@@ -75,8 +87,9 @@ struct LootTable
 // TODO: Potentially split out the data model from the logical bits - if there is time.
 struct Monster
 {
-	// Rolls on loot for this monster.
-	void RerollLoot();
+	// Rolls on loot for this monster, straight from the content rules. Nothing in the
+	// simulator calls this; it's kept as the reference LootModel is tested against.
+	void RerollLoot(RngState& rng);
 
 	// Populated by rolling on loot.
 	std::vector<Treasure> lootDrops;
@@ -84,7 +97,8 @@ struct Monster
 	//--------------------------
 	// Model data
 
-	std::string name;
+	// Display name, in the content's StringPool.
+	StringId nameId = s_invalidStringId;
 	MonsterType type;
 
 	// List of loot tables we can choose from.
@@ -96,4 +110,38 @@ struct Monster
 	}
 };
 
+struct Encounter
+{
+	MonsterType type = MonsterType::NONE;
+
+	// Relative chance of this monster being the one that spawns.
+	float weight = 0.0f;
+};
+
+// Bad luck protection: a player who goes afterKills - 1 kills of monster in a row without
+// treasure dropping gets it from the next one regardless. Any drop of it resets the count.
+struct PityRule
+{
+	MonsterType monster = MonsterType::NONE;
+	TreasureType treasure = TreasureType::NONE;
+	int32_t afterKills = 0;
+};
+
+// What one of a treasure is worth to the economy, in gold. Treasures that drop in
+// quantities are worth this much per unit; treasures without a value are worth nothing.
+struct TreasureValue
+{
+	TreasureType treasure = TreasureType::NONE;
+	double value = 0.0;
+};
+
+// Monsters that spawn in one zone, for kills that don't pick a type.
+struct EncounterTable
+{
+	// Zone name, in the content's StringPool.
+	StringId zoneId = s_invalidStringId;
+
+	std::vector<Encounter> encounters;
+};
+
 } // namespace LootSimulator
@@ -5,16 +5,29 @@
 
 #include "GameView.h"
 
+#include "CompletionTime.h"
+#include "DropCombinations.h"
+#include "DropDistribution.h"
 #include "GameController.h"
 #include "GameEvents.h"
+#include "LatencyHistogram.h"
+#include "LootValue.h"
+#include "PitySimulation.h"
+#include "PopulationSimulation.h"
+#include "SimulationService.h"
 
 #include <algorithm>
+#include <cmath>
+#include <iomanip>
 #include <iostream>
+#include <string>
 
 namespace LootSimulator {
 
 //===============================================================
 
+// Most common drop combinations listed.
+static const size_t s_maxListedCombinations = 10;
 
 GameView::GameView(GameController* gameController)
 	: m_controller(gameController)
@@ -45,9 +58,9 @@ void GameView::Initialize()
 
 	e.GetLootDroppedEvent().subscribe([this](const LootSession& lootSession)
 	{
-		int32_t monsterTotal = std::accumulate(std::cbegin(lootSession.monsterCounts),
-			std::cend(lootSession.monsterCounts), 0,
-			[](int value, const std::pair<MonsterType, int32_t>& counts)
+		int64_t monsterTotal = std::accumulate(std::cbegin(lootSession.monsterCounts),
+			std::cend(lootSession.monsterCounts), int64_t(0),
+			[](int64_t value, const std::pair<MonsterType, int64_t>& counts)
 		{
 			return value + counts.second;
 		});
@@ -88,7 +101,7 @@ void GameView::PrintGamePrompt()
 			const std::set<Monster>& monsters = m_controller->GetMonsters();
 			for (const auto& monster : monsters)
 			{
-				 std::cout << optionNum++ << ". " << monster.name << "\n";
+				 std::cout << optionNum++ << ". " << m_controller->GetMonsterName(monster.type) << "\n";
 			}
 		}
 		break;
@@ -118,36 +131,267 @@ void GameView::PrintBackToMenuPrompt()
 	std::cout << "Press any key to go back to menu!";
 }
 
-void GameView::PrintTreasureItem(const std::pair<TreasureType, int>& itemSummary, int32_t totalMonsterCount)
+void GameView::PrintErrorMessage(std::string_view message)
 {
-	int32_t totalItemCount = itemSummary.second;
+	std::cout << message << "\n";
+}
+
+void GameView::PrintWorkerListening(uint16_t port)
+{
+	std::cout << "Serving shards on port " << port << "\n";
+}
+
+void GameView::PrintLatencyReport(const LatencyHistogram& latency, int32_t threadCount)
+{
+	std::cout << "Single kill latency, " << threadCount << " threads, " << latency.GetCount() << " kills\n"
+		<< "\tmean\t" << std::fixed << std::setprecision(1) << latency.GetMean() << " ns\n"
+		<< "\tp50\t" << latency.GetValueAtPercentile(50.0) << " ns\n"
+		<< "\tp99\t" << latency.GetValueAtPercentile(99.0) << " ns\n"
+		<< "\tp99.9\t" << latency.GetValueAtPercentile(99.9) << " ns\n"
+		<< "\tmax\t" << latency.GetMax() << " ns\n";
+}
+
+void GameView::PrintLatencySlo(uint64_t slo, bool isWithinSlo)
+{
+	std::cout << "p99 SLO of " << slo << " ns " << (isWithinSlo ? "met" : "missed") << "\n";
+}
+
+void GameView::PrintPityReports(const std::vector<PityRuleReport>& reports, int64_t playerCount,
+	int64_t killsPerPlayer)
+{
+	std::cout << "Pity over " << playerCount << " players, " << killsPerPlayer << " kills each\n"
+		<< std::fixed << std::setprecision(4);
+	for (const PityRuleReport& report : reports)
+	{
+		const PityRuleCounts& counts = report.counts;
+		if (counts.kills == 0)
+		{
+			continue;
+		}
+
+		double kills = static_cast<double>(counts.kills);
+		double naturalRate = static_cast<double>(counts.naturalDrops) / kills;
+		double effectiveRate = static_cast<double>(counts.naturalDrops + counts.pityDrops) / kills;
+
+		std::cout << m_controller->GetTreasureName(report.rule.treasure) << " from "
+			<< m_controller->GetMonsterName(report.rule.monster) << ", guaranteed every "
+			<< report.rule.afterKills << " kills\n"
+			<< "\tkills\t\t" << counts.kills << "\n"
+			<< "\tbase rate\t" << report.baseRate * 100.0 << "%\n"
+			<< "\tnatural rate\t" << naturalRate * 100.0 << "%\n"
+			<< "\tpity drops\t" << counts.pityDrops << "\n"
+			<< "\teffective rate\t" << effectiveRate * 100.0 << "%\n";
+	}
+}
+
+void GameView::PrintPopulationReport(const PopulationReport& report, int64_t killsPerPlayer)
+{
+	std::cout << "Population of " << report.playerCount << " players, " << killsPerPlayer
+		<< " kills each\n" << std::fixed << std::setprecision(2);
+	for (size_t t = 0; t < s_numTreasureTypes; ++t)
+	{
+		const CountHistogram& counts = report.treasureCounts[t];
+		if (counts.GetMax() == 0)
+		{
+			continue;
+		}
+
+		double noneShare = static_cast<double>(counts.GetCountAtValue(0))
+			/ static_cast<double>(counts.GetCount());
+
+		std::cout << m_controller->GetTreasureName(static_cast<TreasureType>(t)) << "\n"
+			<< "\tmean\t" << counts.GetMean() << "\n"
+			<< "\tp10\t" << counts.GetValueAtPercentile(10.0) << "\n"
+			<< "\tp50\t" << counts.GetValueAtPercentile(50.0) << "\n"
+			<< "\tp90\t" << counts.GetValueAtPercentile(90.0) << "\n"
+			<< "\tp99\t" << counts.GetValueAtPercentile(99.0) << "\n"
+			<< "\tmax\t" << counts.GetMax() << "\n"
+			<< "\tnone\t" << noneShare * 100.0 << "%\n";
+	}
+}
+
+void GameView::PrintDropDistribution(const DropDistribution& distribution, TreasureType treasure, int64_t killCount)
+{
+	std::cout << m_controller->GetTreasureName(treasure) << " over " << killCount << " kills\n"
+		<< std::fixed << std::setprecision(4)
+		<< "\tmean\t\t" << distribution.GetMean() << "\n"
+		<< "\tmost likely\t" << distribution.GetMostLikelyCount() << "\n"
+		<< "\tnone\t\t" << distribution.GetProbability(0) * 100.0 << "%\n";
+	for (double percentile : { 1.0, 10.0, 50.0, 90.0, 99.0 })
+	{
+		std::cout << "\tp" << static_cast<int32_t>(percentile) << "\t\t"
+			<< distribution.GetCountAtPercentile(percentile) << "\n";
+	}
+}
+
+void GameView::PrintCompletionReport(const CompletionReport& report, size_t treasureCount)
+{
+	if (!report.canComplete)
+	{
+		std::cout << "Some of the set never drops.\n";
+		return;
+	}
+
+	std::cout << "Kills to collect " << treasureCount << " treasures";
+	if (report.isExact)
+	{
+		std::cout << ", exact\n";
+	}
+	else
+	{
+		std::cout << ", over " << report.playerCount << " simulated players\n";
+	}
+
+	std::cout << std::fixed << std::setprecision(2) << "\tmean\t" << report.expectedKills << "\n";
+	for (size_t i = 0; i < std::size(s_completionPercentiles); ++i)
+	{
+		std::cout << "\tp" << static_cast<int32_t>(s_completionPercentiles[i]) << "\t"
+			<< report.percentileKills[i] << "\n";
+	}
+}
+
+void GameView::PrintDropCombinations(const DropCombinationReport& report)
+{
+	double kills = static_cast<double>(report.killCount);
+	std::vector<std::pair<uint64_t, int64_t>> combinations = report.combinations.GetCombinations();
+	std::cout << report.combinations.GetSize() << " drop combinations over " << report.killCount << " kills\n"
+		<< std::fixed << std::setprecision(4);
+	for (size_t i = 0; i < std::min(combinations.size(), s_maxListedCombinations); ++i)
+	{
+		std::string names;
+		for (size_t t = 0; t < s_numTreasureTypes; ++t)
+		{
+			if (combinations[i].first & (uint64_t(1) << t))
+			{
+				names += names.empty() ? "" : " + ";
+				names += m_controller->GetTreasureName(static_cast<TreasureType>(t));
+			}
+		}
+
+		std::cout << "\t" << (names.empty() ? "(no drops)" : names) << "\t" << combinations[i].second
+			<< " (" << static_cast<double>(combinations[i].second) / kills * 100.0 << "%)\n";
+	}
+
+	// How often each pair drops together, and how often the second comes with the first.
+	std::cout << "Treasures dropped together\n";
+	for (size_t i = 0; i < s_numTreasureTypes; ++i)
+	{
+		for (size_t j = i + 1; j < s_numTreasureTypes; ++j)
+		{
+			int64_t together = report.coOccurrences[i][j];
+			if (together == 0)
+			{
+				continue;
+			}
+
+			std::string_view firstName = m_controller->GetTreasureName(static_cast<TreasureType>(i));
+			std::cout << "\t" << firstName << " + "
+				<< m_controller->GetTreasureName(static_cast<TreasureType>(j)) << "\t" << together
+				<< " (" << static_cast<double>(together) / kills * 100.0 << "% of kills, "
+				<< static_cast<double>(together) / static_cast<double>(report.coOccurrences[i][i]) * 100.0
+				<< "% of " << firstName << ")\n";
+		}
+	}
+}
+
+void GameView::PrintLootValueReport(const LootValueReport& report, double modelMean, double modelVariance)
+{
+	double sessionKills = static_cast<double>(report.sessionKills);
+	std::cout << std::fixed << std::setprecision(2)
+		<< "Percentiles are histogram bucket bounds, at most 1% above the value.\n";
+	PrintValueMoments("Gold per kill", report.killValues, report.killHistogram, modelMean, modelVariance);
+	if (report.sessionValues.GetCount() > 0)
+	{
+		std::string title = "Gold per " + std::to_string(report.sessionKills) + " kill session";
+		PrintValueMoments(title, report.sessionValues, report.sessionHistogram,
+			modelMean * sessionKills, modelVariance * sessionKills);
+	}
+}
+
+void GameView::PrintServedResults(const std::vector<SimulationResult>& results, int64_t killCount, int64_t runCount)
+{
+	std::cout << results.size() << " clients, " << killCount << " kills\n";
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const SimulationResult& result = results[i];
+
+		int64_t kills = 0;
+		int64_t drops = 0;
+		for (const auto& counts : result.lootSession.monsterCounts)
+		{
+			kills += counts.second;
+		}
+		for (const auto& treasures : result.lootSession.lootMap)
+		{
+			for (const auto& treasure : treasures.second)
+			{
+				drops += treasure.second;
+			}
+		}
+
+		std::cout << "\tclient " << i + 1 << "\t" << (result.success ? "" : "failed, ") << kills
+			<< " kills, " << drops << " drops\n";
+	}
+	std::cout << "Served in " << runCount << " runs\n";
+}
+
+void GameView::PrintTreasureItem(const std::pair<TreasureType, int64_t>& itemSummary, const TreasureMap* quantityTotals,
+	int64_t totalMonsterCount)
+{
+	int64_t totalItemCount = itemSummary.second;
 	float percentOfTotal = static_cast<float>(totalItemCount) / static_cast<float>(totalMonsterCount) * 100;
 
 	std::cout << "\tLoot: " << m_controller->GetTreasureName(itemSummary.first) << "\n";
 	std::cout << "\tCount: " << itemSummary.second << "(" << percentOfTotal << "%)";
+
+	// Only treasures that drop in quantities have a total.
+	if (quantityTotals && quantityTotals->count(itemSummary.first) != 0)
+	{
+		int64_t quantity = quantityTotals->at(itemSummary.first);
+		double perMonster = static_cast<double>(quantity) / static_cast<double>(totalMonsterCount);
+		std::cout << "\n\tQuantity: " << quantity << "(" << perMonster << " per monster)";
+	}
 	std::cout << "\n\n";
 }
 
-void GameView::PrintTreasureCollection(const TreasureMap& treasureMap, int32_t totalMonsterCount)
+void GameView::PrintTreasureCollection(const TreasureMap& treasureMap, const TreasureMap* quantityTotals,
+	int64_t totalMonsterCount)
 {
-	for (const std::pair<TreasureType, int32_t>& item : treasureMap)
+	for (const auto& item : treasureMap)
 	{
-		PrintTreasureItem(item, totalMonsterCount);
+		PrintTreasureItem(item, quantityTotals, totalMonsterCount);
 	}
 }
 
-void GameView::PrintLootSummary(const LootSession& lootSession, int32_t totalMonsterCount)
+void GameView::PrintLootSummary(const LootSession& lootSession, int64_t totalMonsterCount)
 {
 	for (MonsterType type : lootSession.monsters)
 	{
 		std::cout << "Monster: " << m_controller->GetMonsterName(type) << "\n";
 		std::cout << "Count: " << lootSession.monsterCounts.at(type) << "\n";
 
-		PrintTreasureCollection(lootSession.lootMap.at(type), totalMonsterCount);
+		auto quantityTotals = lootSession.quantityTotals.find(type);
+		PrintTreasureCollection(lootSession.lootMap.at(type),
+			quantityTotals != lootSession.quantityTotals.end() ? &quantityTotals->second : nullptr,
+			totalMonsterCount);
 		std::cout << "\n\n---------------------------------------------------------\n\n";
 	}
 }
 
+void GameView::PrintValueMoments(std::string_view title, const ValueMoments& moments,
+	const LatencyHistogram& histogram, double modelMean, double modelVariance)
+{
+	std::cout << title << ", " << moments.GetCount() << " of them\n"
+		<< "\tmean\t\t" << moments.GetMean() << " (model " << modelMean << ")\n"
+		<< "\tstd dev\t\t" << moments.GetStandardDeviation() << " (model " << std::sqrt(modelVariance) << ")\n"
+		<< "\tskewness\t" << moments.GetSkewness() << "\n"
+		<< "\tkurtosis\t" << moments.GetExcessKurtosis() << "\n"
+		<< "\tp50\t\t<= " << histogram.GetValueAtPercentile(50.0) << "\n"
+		<< "\tp99\t\t<= " << histogram.GetValueAtPercentile(99.0) << "\n"
+		<< "\tp99.9\t\t<= " << histogram.GetValueAtPercentile(99.9) << "\n"
+		<< "\tmax\t\t" << moments.GetMax() << "\n";
+}
+
 //===============================================================
 
 } // namespace LootSimulator
@@ -7,12 +7,23 @@
 
 #include "GameTypes.h"
 
+#include <string_view>
 #include <utility>
+#include <vector>
 
 namespace LootSimulator {
 
 //===============================================================
+struct CompletionReport;
+struct DropCombinationReport;
+class DropDistribution;
 class GameController;
+class LatencyHistogram;
+struct LootValueReport;
+struct PityRuleReport;
+struct PopulationReport;
+struct SimulationResult;
+class ValueMoments;
 class GameView {
 public:
 	GameView(GameController* gameController);
@@ -24,10 +35,31 @@ public:
 	void PrintMovePrompt();
 	void PrintBackToMenuPrompt();
 
+	// Reports why a run couldn't go ahead, one line per message.
+	void PrintErrorMessage(std::string_view message);
+
+	void PrintWorkerListening(uint16_t port);
+	void PrintLatencyReport(const LatencyHistogram& latency, int32_t threadCount);
+	void PrintLatencySlo(uint64_t slo, bool isWithinSlo);
+	void PrintPityReports(const std::vector<PityRuleReport>& reports, int64_t playerCount, int64_t killsPerPlayer);
+	void PrintPopulationReport(const PopulationReport& report, int64_t killsPerPlayer);
+	void PrintDropDistribution(const DropDistribution& distribution, TreasureType treasure, int64_t killCount);
+	void PrintCompletionReport(const CompletionReport& report, size_t treasureCount);
+	void PrintDropCombinations(const DropCombinationReport& report);
+
+	// The model's mean and variance are of one kill's value.
+	void PrintLootValueReport(const LootValueReport& report, double modelMean, double modelVariance);
+
+	void PrintServedResults(const std::vector<SimulationResult>& results, int64_t killCount, int64_t runCount);
+
 private: 
-	void PrintTreasureItem(const std::pair<TreasureType, int>& itemSummary, int32_t totalMonsterCount);
-	void PrintTreasureCollection(const TreasureMap& treasureMap, int32_t totalMonsterCount);
-	void PrintLootSummary(const LootSession& lootSessions, int32_t totalMonsterCount);
+	void PrintTreasureItem(const std::pair<TreasureType, int64_t>& itemSummary, const TreasureMap* quantityTotals,
+		int64_t totalMonsterCount);
+	void PrintTreasureCollection(const TreasureMap& treasureMap, const TreasureMap* quantityTotals,
+		int64_t totalMonsterCount);
+	void PrintLootSummary(const LootSession& lootSessions, int64_t totalMonsterCount);
+	void PrintValueMoments(std::string_view title, const ValueMoments& moments, const LatencyHistogram& histogram,
+		double modelMean, double modelVariance);
 
 private:
 	GameController* m_controller = nullptr;
@@ -0,0 +1,107 @@
+//---------------------------------------------------------------
+//
+// LatencyBenchmark.cpp
+//
+
+#include "LatencyBenchmark.h"
+
+#include "Game.h"
+#include "PerfCounters.h"
+#include "Trace.h"
+
+#include <atomic>
+#include <initializer_list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Zeroes every count but keeps the entries, so once each monster and treasure has been seen
+// a kill adds to the session without allocating.
+static void ResetLootSession(LootSession& lootSession)
+{
+	for (auto& monsterCount : lootSession.monsterCounts)
+	{
+		monsterCount.second = 0;
+	}
+	for (LootMap* lootMap : { &lootSession.lootMap, &lootSession.quantityTotals })
+	{
+		for (auto& treasures : *lootMap)
+		{
+			for (auto& treasure : treasures.second)
+			{
+				treasure.second = 0;
+			}
+		}
+	}
+}
+
+LatencyHistogram RunLatencyBenchmark(const Game& game, std::optional<MonsterType> type,
+	int32_t threadCount, int64_t killsPerThread, uint64_t seed)
+{
+	TRACE_SCOPE("RunLatencyBenchmark");
+
+	LatencyHistogram merged;
+	std::mutex mergeMutex;
+
+	// Nobody starts until everyone is ready, so the threads really do contend.
+	std::atomic<int32_t> readyCount = 0;
+
+	auto runThread = [&](int32_t threadIndex)
+	{
+		RngState rng = SeedRng(seed);
+		for (int32_t i = 0; i < threadIndex; ++i)
+		{
+			JumpRng(rng);
+		}
+
+		LatencyHistogram histogram;
+		readyCount.fetch_add(1);
+		while (readyCount.load() < threadCount)
+		{
+			std::this_thread::yield();
+		}
+
+		{
+			TRACE_SCOPE("LatencyBenchmarkThread");
+			PerfCounters::ScopedPhase perfPhase("LatencyBenchmark");
+			perfPhase.SetKillCount(killsPerThread);
+
+			// One session for every kill, so the timings are of the kill rather than of
+			// building and freeing its maps.
+			LootSession lootSession;
+			for (int64_t i = 0; i < killsPerThread; ++i)
+			{
+				{
+					ScopedLatency latency(histogram);
+					game.SimulateKill(type, rng, lootSession);
+				}
+				ResetLootSession(lootSession);
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(mergeMutex);
+		merged.Merge(histogram);
+	};
+
+	std::vector<std::thread> threads;
+	for (int32_t i = 1; i < threadCount; ++i)
+	{
+		threads.emplace_back(runThread, i);
+	}
+	runThread(0);
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	return merged;
+}
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,28 @@
+//---------------------------------------------------------------
+//
+// LatencyBenchmark.h
+//
+
+#pragma once
+
+#include "GameTypes.h"
+#include "LatencyHistogram.h"
+
+#include <cstdint>
+#include <optional>
+
+namespace LootSimulator {
+
+//===============================================================
+
+class Game;
+
+// Times killsPerThread single kills on each of threadCount threads, all running at once
+// against the same game, and returns the nanoseconds each kill took. Every thread draws
+// from its own substream of seed. Nobody is notified, so this measures the kill itself.
+LatencyHistogram RunLatencyBenchmark(const Game& game, std::optional<MonsterType> type,
+	int32_t threadCount, int64_t killsPerThread, uint64_t seed);
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,107 @@
+//---------------------------------------------------------------
+//
+// LatencyHistogram.cpp
+//
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace LootSimulator {
+
+//===============================================================
+
+static size_t GetHighestBit(uint64_t value)
+{
+	size_t bit = 0;
+	while (value >>= 1)
+	{
+		++bit;
+	}
+	return bit;
+}
+
+LatencyHistogram::LatencyHistogram()
+	: m_counts(GetIndex(UINT64_MAX) + 1, 0)
+{
+}
+
+// Values below twice the sub bucket count get a slot each. Above that, values whose highest
+// bit is s_subBucketBits + k share each slot with 2^k - 1 neighbours.
+size_t LatencyHistogram::GetIndex(uint64_t value)
+{
+	size_t highestBit = GetHighestBit(value);
+	size_t shift = highestBit > s_subBucketBits ? highestBit - s_subBucketBits : 0;
+	return static_cast<size_t>(shift * s_subBucketCount + (value >> shift));
+}
+
+uint64_t LatencyHistogram::GetHighestEquivalentValue(size_t index)
+{
+	size_t shift = index < 2 * s_subBucketCount ? 0 : static_cast<size_t>(index / s_subBucketCount - 1);
+	uint64_t subBucket = index - shift * s_subBucketCount;
+	return ((subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t value)
+{
+	m_counts[GetIndex(value)]++;
+	m_totalCount++;
+	m_min = std::min(m_min, value);
+	m_max = std::max(m_max, value);
+	m_sum += static_cast<double>(value);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+	for (size_t i = 0; i < m_counts.size(); ++i)
+	{
+		m_counts[i] += other.m_counts[i];
+	}
+	m_totalCount += other.m_totalCount;
+	m_min = std::min(m_min, other.m_min);
+	m_max = std::max(m_max, other.m_max);
+	m_sum += other.m_sum;
+}
+
+void LatencyHistogram::Reset()
+{
+	std::fill(m_counts.begin(), m_counts.end(), 0);
+	m_totalCount = 0;
+	m_min = UINT64_MAX;
+	m_max = 0;
+	m_sum = 0.0;
+}
+
+uint64_t LatencyHistogram::GetValueAtPercentile(double percentile) const
+{
+	if (m_totalCount == 0)
+	{
+		return 0;
+	}
+
+	double fraction = std::min(std::max(percentile, 0.0), 100.0) / 100.0;
+	uint64_t target = std::max<uint64_t>(
+		static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(m_totalCount))), 1);
+
+	uint64_t seen = 0;
+	for (size_t i = 0; i < m_counts.size(); ++i)
+	{
+		seen += m_counts[i];
+		if (seen >= target)
+		{
+			// Never report past what was actually recorded.
+			return std::min(GetHighestEquivalentValue(i), m_max);
+		}
+	}
+	return m_max;
+}
+
+double LatencyHistogram::GetMean() const
+{
+	return m_totalCount > 0 ? m_sum / static_cast<double>(m_totalCount) : 0.0;
+}
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,82 @@
+//---------------------------------------------------------------
+//
+// LatencyHistogram.h
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Log-linear histogram in the style of HdrHistogram. Every power of two range is split
+// into s_subBucketCount linear slots, so any recorded value comes back within 1% no
+// matter its size, and recording is a couple of shifts and an increment.
+// Not thread safe; give each thread its own and merge them.
+class LatencyHistogram
+{
+public:
+	LatencyHistogram();
+
+	void Record(uint64_t value);
+	void Merge(const LatencyHistogram& other);
+	void Reset();
+
+	// Top of the bucket holding the smallest recorded value that percentile of all values
+	// are at or below, e.g. 99.9. At most 1% above that value, and never above GetMax.
+	uint64_t GetValueAtPercentile(double percentile) const;
+
+	uint64_t GetCount() const { return m_totalCount; }
+	uint64_t GetMin() const { return m_totalCount > 0 ? m_min : 0; }
+	uint64_t GetMax() const { return m_max; }
+	double GetMean() const;
+
+private:
+	static size_t GetIndex(uint64_t value);
+	static uint64_t GetHighestEquivalentValue(size_t index);
+
+private:
+	static const uint32_t s_subBucketBits = 7;
+	static const uint64_t s_subBucketCount = uint64_t(1) << s_subBucketBits;
+
+	std::vector<uint64_t> m_counts;
+	uint64_t m_totalCount = 0;
+	uint64_t m_min = UINT64_MAX;
+	uint64_t m_max = 0;
+
+	// Doubles so a long run of large values can't overflow.
+	double m_sum = 0.0;
+};
+
+// Records the nanoseconds it was alive for.
+class ScopedLatency
+{
+public:
+	explicit ScopedLatency(LatencyHistogram& histogram)
+		: m_histogram(histogram)
+		, m_start(std::chrono::steady_clock::now())
+	{
+	}
+
+	~ScopedLatency()
+	{
+		auto elapsed = std::chrono::steady_clock::now() - m_start;
+		m_histogram.Record(static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+	}
+
+	ScopedLatency(const ScopedLatency&) = delete;
+	ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+	LatencyHistogram& m_histogram;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,271 @@
+//---------------------------------------------------------------
+//
+// LiveStats.cpp
+//
+
+#include "LiveStats.h"
+
+#include "Log.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <unistd.h>
+#endif
+
+namespace LootSimulator {
+
+//===============================================================
+
+static const std::chrono::milliseconds s_refreshInterval(500);
+
+static StatsSegment s_segment;
+static std::atomic<StatsSegmentLayout*> s_layout = nullptr;
+
+static std::mutex s_publisherMutex;
+static std::condition_variable s_stopPublisher;
+static std::thread s_publisher;
+static bool s_isPublishing = false;
+static bool s_isPaused = false;
+
+// What the summary's rates are worked out from. Kept across pauses.
+struct PublisherState
+{
+	std::chrono::steady_clock::time_point start;
+	std::chrono::steady_clock::time_point lastRefresh;
+	uint64_t lastKills = 0;
+	uint64_t lastRolls = 0;
+};
+
+static PublisherState s_publisherState;
+
+static uint32_t GetCurrentProcessIdentifier()
+{
+#ifdef _WIN32
+	return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+	return static_cast<uint32_t>(getpid());
+#endif
+}
+
+static uint64_t GetResidentBytes()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters = {};
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return 0;
+	}
+	return static_cast<uint64_t>(counters.WorkingSetSize);
+#else
+	// Second field is the resident set in pages.
+	std::ifstream statm("/proc/self/statm");
+	uint64_t totalPages = 0;
+	uint64_t residentPages = 0;
+	if (!(statm >> totalPages >> residentPages))
+	{
+		return 0;
+	}
+	return residentPages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+static void RefreshSummary(StatsSegmentLayout& layout, std::chrono::steady_clock::time_point start,
+	uint64_t& lastKills, uint64_t& lastRolls, std::chrono::steady_clock::time_point& lastRefresh)
+{
+	uint64_t kills = layout.releasedKills.load(std::memory_order_relaxed);
+	uint64_t rolls = layout.releasedRolls.load(std::memory_order_relaxed);
+	uint64_t targetKills = layout.releasedTargetKills.load(std::memory_order_relaxed);
+	for (const StatsSlot& slot : layout.slots)
+	{
+		if (slot.isActive.load(std::memory_order_relaxed))
+		{
+			kills += slot.kills.load(std::memory_order_relaxed);
+			rolls += slot.rolls.load(std::memory_order_relaxed);
+			targetKills += slot.targetKills.load(std::memory_order_relaxed);
+		}
+	}
+
+	auto now = std::chrono::steady_clock::now();
+	double elapsedSeconds = std::chrono::duration<double>(now - lastRefresh).count();
+	uint64_t killsPerSecond = 0;
+	uint64_t rollsPerSecond = 0;
+	if (elapsedSeconds > 0.0 && kills >= lastKills && rolls >= lastRolls)
+	{
+		killsPerSecond = static_cast<uint64_t>((kills - lastKills) / elapsedSeconds);
+		rollsPerSecond = static_cast<uint64_t>((rolls - lastRolls) / elapsedSeconds);
+	}
+
+	uint64_t etaSeconds = UINT64_MAX;
+	if (killsPerSecond > 0 && targetKills > kills)
+	{
+		etaSeconds = (targetKills - kills) / killsPerSecond;
+	}
+
+	auto uptime = std::chrono::duration_cast<std::chrono::milliseconds>(now - start);
+	layout.uptimeMilliseconds.store(static_cast<uint64_t>(uptime.count()), std::memory_order_relaxed);
+	layout.totalKills.store(kills, std::memory_order_relaxed);
+	layout.totalRolls.store(rolls, std::memory_order_relaxed);
+	layout.targetKills.store(targetKills, std::memory_order_relaxed);
+	layout.killsPerSecond.store(killsPerSecond, std::memory_order_relaxed);
+	layout.rollsPerSecond.store(rollsPerSecond, std::memory_order_relaxed);
+	layout.residentBytes.store(GetResidentBytes(), std::memory_order_relaxed);
+	layout.etaSeconds.store(etaSeconds, std::memory_order_relaxed);
+	layout.publishCount.fetch_add(1, std::memory_order_relaxed);
+
+	lastKills = kills;
+	lastRolls = rolls;
+	lastRefresh = now;
+}
+
+static void RunPublisher(StatsSegmentLayout* layout)
+{
+	PublisherState& state = s_publisherState;
+	std::unique_lock<std::mutex> lock(s_publisherMutex);
+	while (s_isPublishing && !s_isPaused)
+	{
+		s_stopPublisher.wait_for(lock, s_refreshInterval);
+		RefreshSummary(*layout, state.start, state.lastKills, state.lastRolls, state.lastRefresh);
+	}
+}
+
+//---------------------------------------------------------------
+
+bool LiveStats::Start(const std::string& path)
+{
+	std::lock_guard<std::mutex> lock(s_publisherMutex);
+	if (s_isPublishing)
+	{
+		return true;
+	}
+
+	if (!s_segment.Create(path))
+	{
+		LOG_ERROR("Could not create stats segment. file={}", path);
+		return false;
+	}
+
+	s_isPublishing = true;
+	s_publisherState = PublisherState();
+	s_publisherState.start = std::chrono::steady_clock::now();
+	s_publisherState.lastRefresh = s_publisherState.start;
+	s_layout.store(s_segment.GetLayout(), std::memory_order_release);
+	s_publisher = std::thread(RunPublisher, s_segment.GetLayout());
+	return true;
+}
+
+void LiveStats::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(s_publisherMutex);
+		if (!s_isPublishing)
+		{
+			return;
+		}
+		s_isPublishing = false;
+	}
+
+	s_stopPublisher.notify_all();
+	if (s_publisher.joinable())
+	{
+		s_publisher.join();
+	}
+
+	s_isPaused = false;
+	s_layout.store(nullptr, std::memory_order_release);
+	s_segment.Close();
+}
+
+void LiveStats::PauseForFork()
+{
+	{
+		std::lock_guard<std::mutex> lock(s_publisherMutex);
+		if (!s_isPublishing || s_isPaused)
+		{
+			return;
+		}
+		s_isPaused = true;
+	}
+
+	s_stopPublisher.notify_all();
+	s_publisher.join();
+}
+
+void LiveStats::ResumeAfterFork()
+{
+	std::lock_guard<std::mutex> lock(s_publisherMutex);
+	if (!s_isPublishing || !s_isPaused)
+	{
+		return;
+	}
+
+	s_isPaused = false;
+	s_publisher = std::thread(RunPublisher, s_segment.GetLayout());
+}
+
+StatsSegmentLayout* LiveStats::GetLayout()
+{
+	return s_layout.load(std::memory_order_acquire);
+}
+
+//---------------------------------------------------------------
+
+StatsProgress::StatsProgress(int64_t targetKills)
+{
+	StatsSegmentLayout* layout = LiveStats::GetLayout();
+	if (!layout)
+	{
+		return;
+	}
+
+	for (StatsSlot& slot : layout->slots)
+	{
+		uint32_t isActive = 0;
+		if (slot.isActive.compare_exchange_strong(isActive, 1, std::memory_order_acquire))
+		{
+			slot.processId.store(GetCurrentProcessIdentifier(), std::memory_order_relaxed);
+			slot.kills.store(0, std::memory_order_relaxed);
+			slot.rolls.store(0, std::memory_order_relaxed);
+			slot.targetKills.store(static_cast<uint64_t>(targetKills), std::memory_order_relaxed);
+			m_slot = &slot;
+			return;
+		}
+	}
+
+	// Out of slots. This batch just won't show up on its own.
+}
+
+StatsProgress::~StatsProgress()
+{
+	StatsSegmentLayout* layout = LiveStats::GetLayout();
+	if (!m_slot || !layout)
+	{
+		return;
+	}
+
+	// Hand our totals over before freeing the slot so they keep counting.
+	layout->releasedKills.fetch_add(m_kills, std::memory_order_relaxed);
+	layout->releasedRolls.fetch_add(m_rolls, std::memory_order_relaxed);
+	layout->releasedTargetKills.fetch_add(m_slot->targetKills.load(std::memory_order_relaxed),
+		std::memory_order_relaxed);
+	m_slot->isActive.store(0, std::memory_order_release);
+}
+
+void StatsProgress::Publish()
+{
+	m_slot->kills.store(m_kills, std::memory_order_relaxed);
+	m_slot->rolls.store(m_rolls, std::memory_order_relaxed);
+}
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,70 @@
+//---------------------------------------------------------------
+//
+// LiveStats.h
+//
+
+#pragma once
+
+#include "StatsSegment.h"
+
+#include <cstdint>
+#include <string>
+
+namespace LootSimulator {
+
+//===============================================================
+
+namespace LiveStats {
+
+// Creates the stats segment at path and starts refreshing its summary in the background.
+bool Start(const std::string& path);
+void Stop();
+
+// Stops refreshing the summary, so no thread of ours holds a lock when the process forks.
+// Progress keeps being published into the segment.
+void PauseForFork();
+
+// Restarts the refreshing PauseForFork stopped, carrying on where it left off.
+void ResumeAfterFork();
+
+// The segment everyone publishes into, or null if live stats are off.
+StatsSegmentLayout* GetLayout();
+
+} // namespace LiveStats
+
+// Claims a stats slot for one batch. Kills are counted locally and only every
+// s_publishInterval of them are written to the shared slot, so the loop's own cache
+// lines stay untouched. Does nothing when live stats are off.
+class StatsProgress
+{
+public:
+	explicit StatsProgress(int64_t targetKills);
+	~StatsProgress();
+
+	StatsProgress(const StatsProgress&) = delete;
+	StatsProgress& operator=(const StatsProgress&) = delete;
+
+	void AddKill(uint64_t rolls)
+	{
+		++m_kills;
+		m_rolls += rolls;
+		if ((m_kills & (s_publishInterval - 1)) == 0 && m_slot)
+		{
+			Publish();
+		}
+	}
+
+private:
+	void Publish();
+
+private:
+	static const uint64_t s_publishInterval = 4096;
+
+	StatsSlot* m_slot = nullptr;
+	uint64_t m_kills = 0;
+	uint64_t m_rolls = 0;
+};
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -5,64 +5,420 @@
 
 #include "Log.h"
 
-#include <algorithm>
-#include <iostream>
-#include <sstream>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
+#ifdef _WIN32
 #define NOMINMAX
 #include <windows.h>
+#endif
 
 namespace {
 
 //==============================================================================
 
-const int s_maxLength = 70;
+using Logger::Detail::ArgumentType;
+using Logger::Detail::LogRecord;
 
-enum MessageType
+// Records per thread. Must be a power of two.
+const size_t s_ringCapacity = 256;
+
+// How often the flusher wakes up on its own.
+const std::chrono::milliseconds s_flushInterval(10);
+
+// Single producer, single consumer. Only the owning thread writes records and only the
+// flusher reads them, so the two indices are all the synchronization we need.
+struct LogRing
 {
-	DEBUG_WINDOW,
-	CONSOLE
+	alignas(64) std::atomic<uint64_t> head = 0;
+	alignas(64) std::atomic<uint64_t> tail = 0;
+
+	// Set once the owning thread exits. The flusher frees the ring after draining it.
+	std::atomic<bool> isAbandoned = false;
+
+	LogRecord records[s_ringCapacity];
 };
 
-void AppendLoggingInfoToLog(const std::string& fileName, int lineNumber, std::string& messageOut)
+class LogSystem
 {
-	// Remove full path from the filename.
-	std::string strippedFilename;
-	size_t i = fileName.rfind('\\');
-	if (i != std::string::npos)
+public:
+	~LogSystem()
+	{
+		Shutdown();
+	}
+
+	bool Initialize(const std::string& path)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_isRunning)
+		{
+			return true;
+		}
+
+		if (m_isShutDown)
+		{
+			return false;
+		}
+
+		m_file = stderr;
+		if (!path.empty())
+		{
+			FILE* file = std::fopen(path.c_str(), "a");
+			if (!file)
+			{
+				std::fprintf(stderr, "Could not open log file, using stderr. file=%s\n", path.c_str());
+			}
+			else
+			{
+				m_file = file;
+			}
+		}
+
+		m_isRunning = true;
+		m_flusher = std::thread(&LogSystem::RunFlusher, this);
+		return m_file != stderr || path.empty();
+	}
+
+	// Final. Whatever is logged afterwards is written out by the thread logging it.
+	void Shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_isShutDown)
+			{
+				return;
+			}
+			m_isRunning = false;
+			m_isShutDown = true;
+		}
+
+		m_wakeFlusher.notify_all();
+		if (m_flusher.joinable())
+		{
+			m_flusher.join();
+		}
+
+		// Pick up anything logged while the flusher was on its way out.
+		Flush();
+
+		std::lock_guard<std::mutex> drainLock(m_drainMutex);
+		uint64_t droppedCount = GetDroppedCount();
+		if (droppedCount > 0)
+		{
+			std::fprintf(m_file, "[%.6f] WARNING Dropped log messages, thread buffers were full. count=%llu\n",
+				static_cast<double>(Logger::Detail::GetTimestamp() - m_startTimestamp) / 1e9,
+				static_cast<unsigned long long>(droppedCount));
+		}
+
+		if (m_file != stderr)
+		{
+			std::fclose(m_file);
+		}
+		m_file = stderr;
+	}
+
+	bool IsShutDown() const
+	{
+		return m_isShutDown;
+	}
+
+	void PauseFlusher()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!m_isRunning || m_isPaused)
+			{
+				return;
+			}
+			m_isPaused = true;
+		}
+
+		m_wakeFlusher.notify_all();
+		m_flusher.join();
+		Flush();
+	}
+
+	void ResumeFlusher()
 	{
-		strippedFilename = fileName.substr(i + 1, fileName.length());
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_isRunning || !m_isPaused)
+		{
+			return;
+		}
+
+		m_isPaused = false;
+		m_flusher = std::thread(&LogSystem::RunFlusher, this);
+	}
+
+	LogRing* RegisterRing()
+	{
+		auto ring = std::make_shared<LogRing>();
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_isRunning && !m_isShutDown)
+		{
+			// Nobody initialized us. Fall back to stderr rather than losing messages.
+			m_file = stderr;
+			m_isRunning = true;
+			m_flusher = std::thread(&LogSystem::RunFlusher, this);
+		}
+		m_rings.push_back(ring);
+		return ring.get();
+	}
+
+	void IncrementDropped()
+	{
+		m_droppedCount.fetch_add(1, std::memory_order_relaxed);
 	}
 
-	std::stringstream ss;
-	ss << messageOut;
-	ss << " <" << strippedFilename;
-	ss << "> (" << lineNumber << ")\n";
-	messageOut = ss.str();
+	uint64_t GetDroppedCount() const
+	{
+		return m_droppedCount.load(std::memory_order_relaxed);
+	}
+
+	void Flush()
+	{
+		// Each ring has a single consumer, so only one flush runs at a time.
+		std::lock_guard<std::mutex> drainLock(m_drainMutex);
+
+		std::vector<std::shared_ptr<LogRing>> rings;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			rings = m_rings;
+		}
+
+		bool hasAbandonedRings = false;
+		for (const std::shared_ptr<LogRing>& ring : rings)
+		{
+			// Read the flag before draining so nothing committed before it was set is missed.
+			bool isAbandoned = ring->isAbandoned.load(std::memory_order_acquire);
+			DrainRing(*ring);
+			hasAbandonedRings |= isAbandoned;
+		}
+		std::fflush(m_file);
+
+		if (hasAbandonedRings)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(),
+				[](const std::shared_ptr<LogRing>& ring)
+			{
+				return ring->isAbandoned.load(std::memory_order_acquire)
+					&& ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire);
+			}), m_rings.end());
+		}
+	}
+
+private:
+	void RunFlusher()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (m_isRunning && !m_isPaused)
+		{
+			m_wakeFlusher.wait_for(lock, s_flushInterval);
+
+			lock.unlock();
+			Flush();
+			lock.lock();
+		}
+	}
+
+	void DrainRing(LogRing& ring)
+	{
+		uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+		uint64_t head = ring.head.load(std::memory_order_acquire);
+		for (; tail != head; ++tail)
+		{
+			WriteRecord(ring.records[tail & (s_ringCapacity - 1)]);
+		}
+		ring.tail.store(tail, std::memory_order_release);
+	}
+
+	void WriteRecord(const LogRecord& record)
+	{
+		static const char* s_levelNames[] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+
+		char timestamp[32];
+		std::snprintf(timestamp, sizeof(timestamp), "[%.6f] ",
+			static_cast<double>(record.timestamp - m_startTimestamp) / 1e9);
+
+		std::string message = timestamp;
+		message += s_levelNames[record.level];
+		message += ' ';
+		AppendFormattedMessage(record, message);
+		message += " <";
+		message += record.fileName;
+		message += "> (";
+		message += std::to_string(record.lineNumber);
+		message += ")\n";
+
+		std::fwrite(message.data(), 1, message.size(), m_file);
+#ifdef _WIN32
+		OutputDebugStringA(message.c_str());
+#endif
+	}
+
+	// Replaces each {} in the format with the next argument.
+	static void AppendFormattedMessage(const LogRecord& record, std::string& message)
+	{
+		const uint8_t* argument = record.arguments;
+		uint8_t remainingArguments = record.argumentCount;
+
+		for (const char* c = record.format; *c; ++c)
+		{
+			if (c[0] != '{' || c[1] != '}' || remainingArguments == 0)
+			{
+				message += *c;
+				continue;
+			}
+
+			++c;
+			--remainingArguments;
+
+			ArgumentType type;
+			std::memcpy(&type, argument, sizeof(type));
+			argument += sizeof(type);
+
+			if (type == ArgumentType::STRING)
+			{
+				uint16_t length = 0;
+				std::memcpy(&length, argument, sizeof(length));
+				argument += sizeof(length);
+				message.append(reinterpret_cast<const char*>(argument), length);
+				argument += length;
+				continue;
+			}
+
+			uint64_t bits = 0;
+			std::memcpy(&bits, argument, sizeof(bits));
+			argument += sizeof(bits);
+
+			if (type == ArgumentType::SIGNED)
+			{
+				message += std::to_string(static_cast<int64_t>(bits));
+			}
+			else if (type == ArgumentType::UNSIGNED)
+			{
+				message += std::to_string(bits);
+			}
+			else
+			{
+				double number = 0.0;
+				std::memcpy(&number, &bits, sizeof(number));
+				char buffer[32];
+				std::snprintf(buffer, sizeof(buffer), "%g", number);
+				message += buffer;
+			}
+		}
+	}
+
+private:
+	std::mutex m_mutex;
+	std::condition_variable m_wakeFlusher;
+	std::thread m_flusher;
+	bool m_isRunning = false;
+	bool m_isPaused = false;
+	std::atomic<bool> m_isShutDown = false;
+	std::mutex m_drainMutex;
+
+	FILE* m_file = stderr;
+	uint64_t m_startTimestamp = Logger::Detail::GetTimestamp();
+	std::vector<std::shared_ptr<LogRing>> m_rings;
+	std::atomic<uint64_t> m_droppedCount = 0;
+};
+
+LogSystem s_logSystem;
+
+// Registers the calling thread's ring on first use and abandons it on thread exit.
+struct ThreadRing
+{
+	~ThreadRing()
+	{
+		if (ring)
+		{
+			ring->isAbandoned.store(true, std::memory_order_release);
+		}
+	}
+
+	LogRing* ring = nullptr;
+};
+
+thread_local ThreadRing s_threadRing;
+
+LogRing& GetThreadRing()
+{
+	if (!s_threadRing.ring)
+	{
+		s_threadRing.ring = s_logSystem.RegisterRing();
+	}
+	return *s_threadRing.ring;
 }
 
 //==============================================================================
 
 } // anonymous namespace
 
-void Logger::LogDebugMessage(const std::string& message, LogSink messageType,
-	const char* fileName, int lineNumber)
+bool Logger::Initialize(const std::string& path)
 {
-	if (message.empty())
-		return;
-
-	std::string guardedMessage = message;
-	AppendLoggingInfoToLog(fileName, lineNumber, guardedMessage);
-
-	switch (messageType)
-	{
-	case DEBUG_WINDOW:
-		OutputDebugString(guardedMessage.c_str());
-		break;
-	case CONSOLE:
-		std::cout << guardedMessage;
-		break;
-	default:
-		break;
+	return s_logSystem.Initialize(path);
+}
+
+void Logger::Shutdown()
+{
+	s_logSystem.Shutdown();
+}
+
+uint64_t Logger::GetDroppedMessageCount()
+{
+	return s_logSystem.GetDroppedCount();
+}
+
+void Logger::Flush()
+{
+	s_logSystem.Flush();
+}
+
+void Logger::PauseForFork()
+{
+	s_logSystem.PauseFlusher();
+}
+
+void Logger::ResumeAfterFork()
+{
+	s_logSystem.ResumeFlusher();
+}
+
+uint64_t Logger::Detail::GetTimestamp()
+{
+	auto sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch).count());
+}
+
+LogRecord* Logger::Detail::BeginRecord()
+{
+	LogRing& ring = GetThreadRing();
+	uint64_t head = ring.head.load(std::memory_order_relaxed);
+	if (head - ring.tail.load(std::memory_order_acquire) >= s_ringCapacity)
+	{
+		s_logSystem.IncrementDropped();
+		return nullptr;
+	}
+	return &ring.records[head & (s_ringCapacity - 1)];
+}
+
+void Logger::Detail::CommitRecord()
+{
+	LogRing& ring = *s_threadRing.ring;
+	ring.head.store(ring.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+
+	// Nobody is left to drain the ring once the flusher is gone for good.
+	if (s_logSystem.IsShutDown())
+	{
+		s_logSystem.Flush();
 	}
 }
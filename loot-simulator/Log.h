@@ -5,32 +5,238 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
+#include <type_traits>
 
 namespace Logger {
 
 //==============================================================================
 
-enum LogSink
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARNING 2
+#define LOG_LEVEL_ERROR 3
+#define LOG_LEVEL_NONE 4
+
+// Sites below this level compile away entirely, arguments included.
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+enum LogLevel : uint8_t
+{
+	LEVEL_DEBUG = LOG_LEVEL_DEBUG,
+	LEVEL_INFO = LOG_LEVEL_INFO,
+	LEVEL_WARNING = LOG_LEVEL_WARNING,
+	LEVEL_ERROR = LOG_LEVEL_ERROR
+};
+
+// Starts the background flusher. Messages go to the file at path, or stderr if it's empty.
+// Logging before this starts it with stderr.
+bool Initialize(const std::string& path);
+
+// Writes out everything logged so far, then how many messages were dropped, and stops the
+// flusher for good. Anything logged afterwards is written out right away by the thread
+// that logs it.
+void Shutdown();
+
+// Number of messages dropped because a thread's buffer was full.
+uint64_t GetDroppedMessageCount();
+
+// Writes out everything logged so far, from any thread, right away.
+void Flush();
+
+// Stops the flusher, so no thread of ours holds a lock when the process forks. Logging
+// carries on into the buffers, and a forked child calls Flush before it exits to write
+// out its own messages.
+void PauseForFork();
+
+// Restarts the flusher PauseForFork stopped.
+void ResumeAfterFork();
+
+//------------------------------------------------------------------------------
+// Implementation details for the macros below.
+
+namespace Detail {
+
+// Messages are copied into fixed size records. Formatting happens on the flusher thread,
+// so a record holds the format string and the raw arguments.
+static const size_t s_recordArgumentBytes = 200;
+
+enum class ArgumentType : uint8_t
 {
-	DEBUG_WINDOW,
-	CONSOLE
+	SIGNED,
+	UNSIGNED,
+	FLOATING,
+	STRING
 };
 
-// Super crude, quick and dirty logger for desperate situations.
-void LogDebugMessage(const std::string& message, LogSink messageType, const char* fileName,
-	int lineNumber);
+struct LogRecord
+{
+	uint64_t timestamp = 0;
+
+	// Both point at string literals, which outlive any record.
+	const char* format = nullptr;
+	const char* fileName = nullptr;
+
+	int32_t lineNumber = 0;
+	LogLevel level = LEVEL_DEBUG;
+	uint8_t argumentCount = 0;
+	uint16_t argumentBytes = 0;
+	uint8_t arguments[s_recordArgumentBytes];
+};
+
+// Returns the calling thread's next free record, or null if its buffer is full.
+LogRecord* BeginRecord();
+
+// Hands the record returned by BeginRecord over to the flusher.
+void CommitRecord();
 
-#define LOG_DEBUG_CONSOLE(msg)                                          \
-{                                                                       \
-	LogDebugMessage(msg, Logger::CONSOLE, __FILE__, __LINE__);          \
+inline void AppendBytes(LogRecord& record, const void* data, size_t size)
+{
+	std::memcpy(record.arguments + record.argumentBytes, data, size);
+	record.argumentBytes = static_cast<uint16_t>(record.argumentBytes + size);
+}
+
+// Strings are copied, truncated to whatever room is left.
+inline void AppendArgument(LogRecord& record, std::string_view value)
+{
+	size_t headerSize = sizeof(ArgumentType) + sizeof(uint16_t);
+	size_t available = s_recordArgumentBytes - record.argumentBytes;
+	if (available < headerSize)
+	{
+		return;
+	}
+
+	ArgumentType type = ArgumentType::STRING;
+	uint16_t length = static_cast<uint16_t>((std::min)(value.size(), available - headerSize));
+	AppendBytes(record, &type, sizeof(type));
+	AppendBytes(record, &length, sizeof(length));
+	AppendBytes(record, value.data(), length);
+	++record.argumentCount;
 }
 
-#define LOG_DEBUG(msg)                                                  \
-{                                                                       \
-	LogDebugMessage(msg, Logger::DEBUG_WINDOW, __FILE__, __LINE__);     \
+inline void AppendArgument(LogRecord& record, const std::string& value)
+{
+	AppendArgument(record, std::string_view(value));
 }
 
+inline void AppendArgument(LogRecord& record, const char* value)
+{
+	AppendArgument(record, std::string_view(value ? value : "(null)"));
+}
+
+template <typename T>
+inline void AppendArgument(LogRecord& record, const T& value)
+{
+	static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+		"Log arguments must be numbers, enums or strings.");
+
+	ArgumentType type;
+	uint64_t bits = 0;
+	if constexpr (std::is_floating_point<T>::value)
+	{
+		type = ArgumentType::FLOATING;
+		double number = static_cast<double>(value);
+		std::memcpy(&bits, &number, sizeof(bits));
+	}
+	else if constexpr (std::is_enum<T>::value || std::is_signed<T>::value)
+	{
+		type = ArgumentType::SIGNED;
+		bits = static_cast<uint64_t>(static_cast<int64_t>(value));
+	}
+	else
+	{
+		type = ArgumentType::UNSIGNED;
+		bits = static_cast<uint64_t>(value);
+	}
+
+	if (s_recordArgumentBytes - record.argumentBytes < sizeof(type) + sizeof(bits))
+	{
+		return;
+	}
+
+	AppendBytes(record, &type, sizeof(type));
+	AppendBytes(record, &bits, sizeof(bits));
+	++record.argumentCount;
+}
+
+uint64_t GetTimestamp();
+
+template <typename... Args>
+void WriteRecord(LogLevel level, const char* fileName, int32_t lineNumber, const char* format,
+	const Args&... args)
+{
+	LogRecord* record = BeginRecord();
+	if (!record)
+	{
+		return;
+	}
+
+	record->timestamp = GetTimestamp();
+	record->format = format;
+	record->fileName = fileName;
+	record->lineNumber = lineNumber;
+	record->level = level;
+	record->argumentCount = 0;
+	record->argumentBytes = 0;
+	(AppendArgument(*record, args), ...);
+
+	CommitRecord();
+}
+
+// Strips the directories off of __FILE__ at compile time.
+constexpr const char* GetFileName(const char* path)
+{
+	const char* fileName = path;
+	for (const char* c = path; *c; ++c)
+	{
+		if (*c == '/' || *c == '\\')
+		{
+			fileName = c + 1;
+		}
+	}
+	return fileName;
+}
+
+} // namespace Detail
+
+// Each {} in the format is replaced by the next argument when the message is written out.
+// The format must be a string literal.
+#define LOG_WRITE(level, format, ...)                                                  \
+{                                                                                      \
+	static constexpr const char* s_logFileName = Logger::Detail::GetFileName(__FILE__); \
+	Logger::Detail::WriteRecord(level, s_logFileName, __LINE__, format, ##__VA_ARGS__);  \
+}
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(format, ...) LOG_WRITE(Logger::LEVEL_DEBUG, format, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(format, ...) {}
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(format, ...) LOG_WRITE(Logger::LEVEL_INFO, format, ##__VA_ARGS__)
+#else
+#define LOG_INFO(format, ...) {}
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_WARNING
+#define LOG_WARNING(format, ...) LOG_WRITE(Logger::LEVEL_WARNING, format, ##__VA_ARGS__)
+#else
+#define LOG_WARNING(format, ...) {}
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(format, ...) LOG_WRITE(Logger::LEVEL_ERROR, format, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(format, ...) {}
+#endif
+
 //==============================================================================
 
 } // namespace Logger
@@ -0,0 +1,50 @@
+//---------------------------------------------------------------
+//
+// LootCounters.cpp
+//
+
+#include "LootCounters.h"
+
+namespace LootSimulator {
+
+//===============================================================
+
+void MergeLootCounters(LootCounters& into, const LootCounters& from)
+{
+	for (size_t m = 0; m < s_numMonsterTypes; ++m)
+	{
+		into.monsterCounts[m] += from.monsterCounts[m];
+		for (size_t t = 0; t < s_numTreasureTypes; ++t)
+		{
+			into.lootCounts[m][t] += from.lootCounts[m][t];
+		}
+	}
+}
+
+void AppendToLootSession(const LootCounters& counters, LootSession& lootSession)
+{
+	for (size_t m = 0; m < s_numMonsterTypes; ++m)
+	{
+		if (counters.monsterCounts[m] == 0)
+		{
+			continue;
+		}
+
+		MonsterType monsterType = static_cast<MonsterType>(m);
+		lootSession.monsters.insert(monsterType);
+		lootSession.monsterCounts[monsterType] += counters.monsterCounts[m];
+
+		TreasureMap& treasures = lootSession.lootMap[monsterType];
+		for (size_t t = 0; t < s_numTreasureTypes; ++t)
+		{
+			if (counters.lootCounts[m][t] != 0)
+			{
+				treasures[static_cast<TreasureType>(t)] += counters.lootCounts[m][t];
+			}
+		}
+	}
+}
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,38 @@
+//---------------------------------------------------------------
+//
+// LootCounters.h
+//
+
+#pragma once
+
+#include "GameTypes.h"
+
+#include <cstdint>
+
+namespace LootSimulator {
+
+//===============================================================
+
+static const size_t s_numMonsterTypes = static_cast<size_t>(MonsterType::NUM_TYPES);
+static const size_t s_numTreasureTypes = static_cast<size_t>(TreasureType::NUM_TYPES);
+
+// Flat, fixed size version of LootSession. Plain data only, so it can live in shared
+// memory or be written out as is.
+struct LootCounters
+{
+	// Kills per monster type.
+	int64_t monsterCounts[s_numMonsterTypes] = {};
+
+	// Drops per monster type, per treasure type.
+	int64_t lootCounts[s_numMonsterTypes][s_numTreasureTypes] = {};
+};
+
+// Adds every counter in from to into.
+void MergeLootCounters(LootCounters& into, const LootCounters& from);
+
+// Expands the counters into a session. Only monsters that were slain show up.
+void AppendToLootSession(const LootCounters& counters, LootSession& lootSession);
+
+//===============================================================
+
+} // namespace LootSimulator
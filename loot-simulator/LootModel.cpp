@@ -0,0 +1,762 @@
+//---------------------------------------------------------------
+//
+// LootModel.cpp
+//
+
+#include "LootModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <numeric>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Quantity totals over more drops than this come from the normal approximation.
+static const int64_t s_maxExactQuantityDrops = 64;
+
+// Box-Muller. Only used by bulk quantities, so speed doesn't matter.
+static double NextStandardNormal(RngState& rng)
+{
+	double radius = std::sqrt(-2.0 * std::log(1.0 - NextRandomDouble(rng)));
+	return radius * std::cos(6.283185307179586 * NextRandomDouble(rng));
+}
+
+// Variant tables one thread has looked up, indexed by table, for the cache and bucket it
+// last rolled with. Holding them keeps them valid if the cache evicts them meanwhile.
+struct ResolvedVariants
+{
+	uint64_t cacheId = 0;
+	uint32_t magicFindBucket = 0;
+	std::vector<std::shared_ptr<const AliasTable>> tables;
+};
+
+static thread_local ResolvedVariants t_resolvedVariants;
+
+uint32_t GetMagicFindBucket(float magicFind)
+{
+	if (!(magicFind > 0.0f))
+	{
+		return 0;
+	}
+	float bucket = std::round(magicFind / s_magicFindStep);
+	return bucket >= s_maxMagicFindBucket ? s_maxMagicFindBucket : static_cast<uint32_t>(bucket);
+}
+
+//---------------------------------------------------------------
+
+template <typename Function>
+void LootModel::ForEachTreasureChance(const CompiledMonster& monster, Function addTreasure) const
+{
+	const CompiledTable* tables = m_tables.data() + monster.firstTable;
+
+	auto addTable = [&](const CompiledTable& table, double tableChance)
+	{
+		if (table.weightTotal <= 0.0f)
+		{
+			return;
+		}
+
+		for (uint32_t i = 0; i < table.treasureCount; ++i)
+		{
+			uint32_t treasureIndex = table.firstTreasure + i;
+			addTreasure(treasureIndex, tableChance
+				* static_cast<double>(m_weights[treasureIndex]) / static_cast<double>(table.weightTotal));
+		}
+	};
+
+	// One exclusive table drops with its own rate, otherwise every guaranteed table does.
+	double exclusiveChance = 0.0;
+	for (uint32_t i = 0; i < monster.exclusiveCount; ++i)
+	{
+		double tableChance = std::min(static_cast<double>(tables[i].dropRate), 1.0 - exclusiveChance);
+		addTable(tables[i], tableChance);
+		exclusiveChance += tableChance;
+	}
+
+	for (uint32_t i = monster.exclusiveCount; i < monster.tableCount; ++i)
+	{
+		addTable(tables[i], 1.0 - exclusiveChance);
+	}
+}
+
+LootModel::LootModel()
+	: m_tableVariants(std::make_unique<AliasTableCache>(s_maxCachedTableVariants))
+{
+	double weights[s_numMonsterTypes];
+	std::fill(std::begin(weights), std::end(weights), 1.0);
+	CompileEncounters(weights);
+}
+
+LootModel::LootModel(const std::set<Monster>& monsters, const EncounterTable* encounters)
+	: LootModel()
+{
+	if (encounters)
+	{
+		double weights[s_numMonsterTypes] = {};
+		for (const Encounter& encounter : encounters->encounters)
+		{
+			size_t monsterIndex = static_cast<size_t>(encounter.type);
+			if (monsterIndex < s_numMonsterTypes)
+			{
+				weights[monsterIndex] += encounter.weight;
+			}
+		}
+		CompileEncounters(weights);
+	}
+
+	for (const Monster& monster : monsters)
+	{
+		size_t monsterIndex = static_cast<size_t>(monster.type);
+		if (monsterIndex >= s_numMonsterTypes)
+		{
+			continue;
+		}
+
+		// Same split as RerollLoot, so tables end up in the same order it rolls them in.
+		std::vector<LootTable> tables = monster.tables;
+		auto it = std::stable_partition(std::begin(tables), std::end(tables),
+			[](const LootTable& table)
+		{
+			return table.dropRate != 1.0f;
+		});
+
+		CompiledMonster& compiled = m_monsters[monsterIndex];
+		compiled.firstTable = static_cast<uint32_t>(m_tables.size());
+		compiled.exclusiveCount = static_cast<uint32_t>(std::distance(std::begin(tables), it));
+		compiled.tableCount = static_cast<uint32_t>(tables.size());
+		compiled.isLoaded = true;
+
+		for (const LootTable& table : tables)
+		{
+			CompiledTable compiledTable;
+			compiledTable.firstTreasure = static_cast<uint32_t>(m_treasureTypes.size());
+			compiledTable.treasureCount = static_cast<uint32_t>(table.treasures.size());
+			compiledTable.dropRate = table.dropRate;
+			for (const Treasure& treasure : table.treasures)
+			{
+				compiledTable.weightTotal += treasure.dropRate;
+				m_weights.push_back(treasure.dropRate);
+				m_treasureTypes.push_back(treasure.type);
+			}
+			m_tables.push_back(compiledTable);
+		}
+
+		size_t guaranteedCount = compiled.tableCount - compiled.exclusiveCount;
+		size_t maxDrops = std::max<size_t>(guaranteedCount, compiled.exclusiveCount > 0 ? 1 : 0);
+		m_maxDropCount = std::max(m_maxDropCount, maxDrops);
+
+		CompileQuantities(monster.type, tables);
+	}
+}
+
+void LootModel::CompileEncounters(const double (&weights)[s_numMonsterTypes])
+{
+	if (std::accumulate(std::begin(weights), std::end(weights), 0.0) <= 0.0)
+	{
+		return;
+	}
+	m_encounters = BuildAliasTable(std::vector<double>(std::begin(weights), std::end(weights)));
+
+	// Summed from the end so the last type with any weight gets a share of exactly one.
+	double weightLeft = 0.0;
+	for (size_t i = s_numMonsterTypes; i-- > 0;)
+	{
+		weightLeft += weights[i];
+		m_encounterShares[i] = weightLeft > 0.0 ? weights[i] / weightLeft : 0.0;
+	}
+}
+
+void LootModel::CompileQuantities(MonsterType type, const std::vector<LootTable>& tables)
+{
+	// Treasures are in the same order as the compiled tables, so index i is entry i.
+	std::vector<const Treasure*> treasures;
+	for (const LootTable& table : tables)
+	{
+		for (const Treasure& treasure : table.treasures)
+		{
+			treasures.push_back(&treasure);
+		}
+	}
+
+	if (treasures.empty())
+	{
+		return;
+	}
+
+	std::vector<QuantityRange> ranges[s_numTreasureTypes];
+	uint32_t firstTreasure = m_tables[m_monsters[static_cast<size_t>(type)].firstTable].firstTreasure;
+	ForEachTreasureChance(m_monsters[static_cast<size_t>(type)], [&](uint32_t treasureIndex, double chance)
+	{
+		const Treasure& treasure = *treasures[treasureIndex - firstTreasure];
+		size_t typeIndex = static_cast<size_t>(treasure.type);
+		if (typeIndex >= s_numTreasureTypes || chance <= 0.0)
+		{
+			return;
+		}
+
+		std::vector<QuantityRange>& typeRanges = ranges[typeIndex];
+		auto it = std::find_if(typeRanges.begin(), typeRanges.end(), [&treasure](const QuantityRange& range)
+		{
+			return range.min == treasure.minQuantity && range.max == treasure.maxQuantity;
+		});
+
+		if (it != typeRanges.end())
+		{
+			it->weight += chance;
+		}
+		else
+		{
+			typeRanges.push_back({ treasure.minQuantity, treasure.maxQuantity, chance });
+		}
+	});
+
+	for (size_t t = 0; t < s_numTreasureTypes; ++t)
+	{
+		if (ranges[t].empty())
+		{
+			continue;
+		}
+
+		CompiledQuantity& quantity = m_quantities[static_cast<size_t>(type)][t];
+		quantity.firstRange = static_cast<uint32_t>(m_quantityRanges.size());
+		quantity.rangeCount = static_cast<uint32_t>(ranges[t].size());
+		quantity.min = INT32_MAX;
+		quantity.max = 0;
+
+		// Moments of the mixture of discrete uniform ranges.
+		double mean = 0.0;
+		double meanSquare = 0.0;
+		for (const QuantityRange& range : ranges[t])
+		{
+			double rangeMean = (static_cast<double>(range.min) + range.max) / 2.0;
+			double width = static_cast<double>(range.max) - range.min + 1.0;
+			double rangeVariance = (width * width - 1.0) / 12.0;
+
+			quantity.weightTotal += range.weight;
+			mean += range.weight * rangeMean;
+			meanSquare += range.weight * (rangeVariance + rangeMean * rangeMean);
+			quantity.min = std::min(quantity.min, range.min);
+			quantity.max = std::max(quantity.max, range.max);
+			m_quantityRanges.push_back(range);
+		}
+
+		quantity.mean = mean / quantity.weightTotal;
+		quantity.variance = std::max(meanSquare / quantity.weightTotal - quantity.mean * quantity.mean, 0.0);
+	}
+}
+
+template <typename RollTableFunction>
+size_t LootModel::RollMonster(MonsterType type, RngState& rng, TreasureType* out, size_t capacity,
+	RollTableFunction rollTable) const
+{
+	size_t monsterIndex = static_cast<size_t>(type);
+	if (monsterIndex >= s_numMonsterTypes || !m_monsters[monsterIndex].isLoaded)
+	{
+		return 0;
+	}
+
+	const CompiledMonster& monster = m_monsters[monsterIndex];
+	const CompiledTable* tables = m_tables.data() + monster.firstTable;
+
+	// Either one exclusive table drops, or every guaranteed one does.
+	float randomNumber = NextRandomFloat(rng, 0.0f, 1.0f);
+	for (uint32_t i = 0; i < monster.exclusiveCount; ++i)
+	{
+		float dropRate = tables[i].dropRate;
+		if (randomNumber < dropRate)
+		{
+			if (capacity > 0)
+			{
+				out[0] = rollTable(tables[i], rng);
+			}
+			return 1;
+		}
+		randomNumber -= dropRate;
+	}
+
+	size_t dropCount = 0;
+	for (uint32_t i = monster.exclusiveCount; i < monster.tableCount; ++i, ++dropCount)
+	{
+		if (dropCount < capacity)
+		{
+			out[dropCount] = rollTable(tables[i], rng);
+		}
+		else
+		{
+			// Still draw, so the stream stays where RerollLoot would leave it.
+			rollTable(tables[i], rng);
+		}
+	}
+	return dropCount;
+}
+
+size_t LootModel::RollLoot(MonsterType type, RngState& rng, TreasureType* out, size_t capacity) const
+{
+	return RollMonster(type, rng, out, capacity, [this](const CompiledTable& table, RngState& tableRng)
+	{
+		return RollTable(table, tableRng);
+	});
+}
+
+size_t LootModel::RollLoot(MonsterType type, uint32_t magicFindBucket, RngState& rng, TreasureType* out,
+	size_t capacity) const
+{
+	if (magicFindBucket == 0)
+	{
+		return RollLoot(type, rng, out, capacity);
+	}
+
+	return RollMonster(type, rng, out, capacity, [this, magicFindBucket](const CompiledTable& table, RngState& tableRng)
+	{
+		return RollTableVariant(table, magicFindBucket, tableRng);
+	});
+}
+
+MonsterType LootModel::RollMonsterType(RngState& rng) const
+{
+	// The column is picked the way NextRandomInt would, so equal weights draw exactly what
+	// a uniform pick does.
+	return static_cast<MonsterType>(PickAlias(m_encounters, rng));
+}
+
+void LootModel::RollMonsterCounts(int64_t count, RngState& rng, int64_t (&counts)[s_numMonsterTypes]) const
+{
+	// Each type takes its binomial share of the kills the types before it left over.
+	for (size_t i = 0; i < s_numMonsterTypes; ++i)
+	{
+		counts[i] = NextRandomBinomial(rng, count, m_encounterShares[i]);
+		count -= counts[i];
+	}
+}
+
+void LootModel::GetExpectedDropCounts(MonsterType type,
+	double (&expectedCounts)[s_numTreasureTypes]) const
+{
+	std::fill(std::begin(expectedCounts), std::end(expectedCounts), 0.0);
+	if (!HasMonster(type))
+	{
+		return;
+	}
+
+	ForEachTreasureChance(m_monsters[static_cast<size_t>(type)], [&](uint32_t treasureIndex, double chance)
+	{
+		size_t typeIndex = static_cast<size_t>(m_treasureTypes[treasureIndex]);
+		if (typeIndex < s_numTreasureTypes)
+		{
+			expectedCounts[typeIndex] += chance;
+		}
+	});
+}
+
+void LootModel::GetDropCountChances(MonsterType type, TreasureType treasure, uint32_t magicFindBucket,
+	std::vector<double>& chances) const
+{
+	chances.assign(1, 1.0);
+	if (!HasMonster(type))
+	{
+		return;
+	}
+
+	const CompiledMonster& monster = m_monsters[static_cast<size_t>(type)];
+	const CompiledTable* tables = m_tables.data() + monster.firstTable;
+
+	// An exclusive table drops one treasure at most. Same table chances as
+	// ForEachTreasureChance.
+	chances[0] = 0.0;
+	chances.resize(2, 0.0);
+	double exclusiveChance = 0.0;
+	for (uint32_t i = 0; i < monster.exclusiveCount; ++i)
+	{
+		double tableChance = std::min(static_cast<double>(tables[i].dropRate), 1.0 - exclusiveChance);
+		double treasureChance = GetTableChance(tables[i], treasure, magicFindBucket);
+		chances[0] += tableChance * (1.0 - treasureChance);
+		chances[1] += tableChance * treasureChance;
+		exclusiveChance += tableChance;
+	}
+
+	// Every guaranteed table rolls on its own, so their counts add up.
+	std::vector<double> guaranteedChances(1, 1.0);
+	for (uint32_t i = monster.exclusiveCount; i < monster.tableCount; ++i)
+	{
+		double treasureChance = GetTableChance(tables[i], treasure, magicFindBucket);
+		guaranteedChances.push_back(0.0);
+		for (size_t k = guaranteedChances.size() - 1; k > 0; --k)
+		{
+			guaranteedChances[k] = guaranteedChances[k] * (1.0 - treasureChance)
+				+ guaranteedChances[k - 1] * treasureChance;
+		}
+		guaranteedChances[0] *= 1.0 - treasureChance;
+	}
+
+	double guaranteedChance = 1.0 - exclusiveChance;
+	chances.resize(std::max(chances.size(), guaranteedChances.size()), 0.0);
+	for (size_t k = 0; k < guaranteedChances.size(); ++k)
+	{
+		chances[k] += guaranteedChance * guaranteedChances[k];
+	}
+
+	while (chances.size() > 1 && chances.back() <= 0.0)
+	{
+		chances.pop_back();
+	}
+}
+
+void LootModel::GetDropMaskChances(MonsterType type, const std::vector<TreasureType>& treasures,
+	uint32_t magicFindBucket, std::vector<std::pair<uint64_t, double>>& maskChances) const
+{
+	maskChances.assign(1, { 0, 1.0 });
+	if (!HasMonster(type))
+	{
+		return;
+	}
+
+	const CompiledMonster& monster = m_monsters[static_cast<size_t>(type)];
+	const CompiledTable* tables = m_tables.data() + monster.firstTable;
+
+	// Masks one roll of a table can give: a bit for each treasure it can pick, or none.
+	std::vector<std::pair<uint64_t, double>> tableMasks;
+	auto getTableMasks = [&](const CompiledTable& table)
+	{
+		tableMasks.clear();
+		double treasureChance = 0.0;
+		for (size_t i = 0; i < treasures.size(); ++i)
+		{
+			double chance = GetTableChance(table, treasures[i], magicFindBucket);
+			if (chance > 0.0)
+			{
+				tableMasks.push_back({ uint64_t(1) << i, chance });
+				treasureChance += chance;
+			}
+		}
+		tableMasks.push_back({ 0, std::max(1.0 - treasureChance, 0.0) });
+	};
+
+	// Ordered, so the same content always lists masks the same way.
+	std::map<uint64_t, double> killMasks;
+	double exclusiveChance = 0.0;
+	for (uint32_t i = 0; i < monster.exclusiveCount; ++i)
+	{
+		double tableChance = std::min(static_cast<double>(tables[i].dropRate), 1.0 - exclusiveChance);
+		getTableMasks(tables[i]);
+		for (const std::pair<uint64_t, double>& tableMask : tableMasks)
+		{
+			killMasks[tableMask.first] += tableChance * tableMask.second;
+		}
+		exclusiveChance += tableChance;
+	}
+
+	// Guaranteed tables all roll, so their masks combine.
+	std::map<uint64_t, double> guaranteedMasks = { { 0, 1.0 } };
+	std::map<uint64_t, double> nextMasks;
+	for (uint32_t i = monster.exclusiveCount; i < monster.tableCount; ++i)
+	{
+		getTableMasks(tables[i]);
+		nextMasks.clear();
+		for (const std::pair<const uint64_t, double>& mask : guaranteedMasks)
+		{
+			for (const std::pair<uint64_t, double>& tableMask : tableMasks)
+			{
+				nextMasks[mask.first | tableMask.first] += mask.second * tableMask.second;
+			}
+		}
+		guaranteedMasks.swap(nextMasks);
+	}
+
+	for (const std::pair<const uint64_t, double>& mask : guaranteedMasks)
+	{
+		killMasks[mask.first] += (1.0 - exclusiveChance) * mask.second;
+	}
+
+	maskChances.clear();
+	for (const std::pair<const uint64_t, double>& mask : killMasks)
+	{
+		if (mask.second > 0.0)
+		{
+			maskChances.push_back(mask);
+		}
+	}
+}
+
+void LootModel::GetValueMoments(MonsterType type, const double (&values)[s_numTreasureTypes],
+	uint32_t magicFindBucket, double& mean, double& meanSquare) const
+{
+	mean = 0.0;
+	meanSquare = 0.0;
+	if (!HasMonster(type))
+	{
+		return;
+	}
+
+	const CompiledMonster& monster = m_monsters[static_cast<size_t>(type)];
+	const CompiledTable* tables = m_tables.data() + monster.firstTable;
+
+	// Mean and mean square of what one roll of a table is worth. Each drop's quantity is
+	// drawn on its own, so a treasure's value has its quantity's mean and variance.
+	auto getTableMoments = [&](const CompiledTable& table, double& tableMean, double& tableMeanSquare)
+	{
+		tableMean = 0.0;
+		tableMeanSquare = 0.0;
+		for (size_t t = 0; t < s_numTreasureTypes; ++t)
+		{
+			TreasureType treasure = static_cast<TreasureType>(t);
+			double chance = values[t] != 0.0 ? GetTableChance(table, treasure, magicFindBucket) : 0.0;
+			if (chance <= 0.0)
+			{
+				continue;
+			}
+
+			const CompiledQuantity* quantity = GetQuantity(type, treasure);
+			double quantityMean = quantity ? quantity->mean : 1.0;
+			double quantityVariance = quantity ? quantity->variance : 0.0;
+			tableMean += chance * values[t] * quantityMean;
+			tableMeanSquare += chance * values[t] * values[t] * (quantityVariance + quantityMean * quantityMean);
+		}
+	};
+
+	// Same table chances as ForEachTreasureChance.
+	double tableMean = 0.0;
+	double tableMeanSquare = 0.0;
+	double exclusiveChance = 0.0;
+	for (uint32_t i = 0; i < monster.exclusiveCount; ++i)
+	{
+		double tableChance = std::min(static_cast<double>(tables[i].dropRate), 1.0 - exclusiveChance);
+		getTableMoments(tables[i], tableMean, tableMeanSquare);
+		mean += tableChance * tableMean;
+		meanSquare += tableChance * tableMeanSquare;
+		exclusiveChance += tableChance;
+	}
+
+	// Guaranteed tables roll on their own, so their means and variances add up.
+	double guaranteedMean = 0.0;
+	double guaranteedVariance = 0.0;
+	for (uint32_t i = monster.exclusiveCount; i < monster.tableCount; ++i)
+	{
+		getTableMoments(tables[i], tableMean, tableMeanSquare);
+		guaranteedMean += tableMean;
+		guaranteedVariance += tableMeanSquare - tableMean * tableMean;
+	}
+
+	double guaranteedChance = 1.0 - exclusiveChance;
+	mean += guaranteedChance * guaranteedMean;
+	meanSquare += guaranteedChance * (guaranteedVariance + guaranteedMean * guaranteedMean);
+}
+
+double LootModel::GetEncounterChance(MonsterType type) const
+{
+	size_t monsterIndex = static_cast<size_t>(type);
+	if (monsterIndex >= s_numMonsterTypes)
+	{
+		return 0.0;
+	}
+
+	double chanceLeft = 1.0;
+	for (size_t i = 0; i < monsterIndex; ++i)
+	{
+		chanceLeft *= 1.0 - m_encounterShares[i];
+	}
+	return chanceLeft * m_encounterShares[monsterIndex];
+}
+
+bool LootModel::HasQuantity(MonsterType monster, TreasureType treasure) const
+{
+	const CompiledQuantity* quantity = GetQuantity(monster, treasure);
+	return quantity && (quantity->min != 1 || quantity->max != 1);
+}
+
+int64_t LootModel::RollQuantity(MonsterType monster, TreasureType treasure, RngState& rng) const
+{
+	const CompiledQuantity* quantity = GetQuantity(monster, treasure);
+	if (!quantity || quantity->min == quantity->max)
+	{
+		return quantity ? quantity->min : 1;
+	}
+
+	const QuantityRange* range = m_quantityRanges.data() + quantity->firstRange;
+	if (quantity->rangeCount > 1)
+	{
+		const QuantityRange* lastRange = range + quantity->rangeCount - 1;
+		double randomNumber = NextRandomDouble(rng) * quantity->weightTotal;
+		for (; range != lastRange && randomNumber >= range->weight; ++range)
+		{
+			randomNumber -= range->weight;
+		}
+	}
+
+	return range->min == range->max ? range->min : NextRandomInt(rng, range->min, range->max);
+}
+
+int64_t LootModel::RollQuantityTotal(MonsterType monster, TreasureType treasure, int64_t dropCount,
+	RngState& rng) const
+{
+	const CompiledQuantity* quantity = GetQuantity(monster, treasure);
+	if (dropCount <= 0 || !quantity || quantity->min == quantity->max)
+	{
+		return std::max<int64_t>(dropCount, 0) * (quantity ? quantity->min : 1);
+	}
+
+	if (dropCount <= s_maxExactQuantityDrops)
+	{
+		int64_t total = 0;
+		for (int64_t i = 0; i < dropCount; ++i)
+		{
+			total += RollQuantity(monster, treasure, rng);
+		}
+		return total;
+	}
+
+	double count = static_cast<double>(dropCount);
+	double total = std::round(count * quantity->mean
+		+ std::sqrt(count * quantity->variance) * NextStandardNormal(rng));
+	total = std::clamp(total, count * quantity->min, count * quantity->max);
+	return static_cast<int64_t>(total);
+}
+
+void LootModel::RollSessionQuantities(LootSession& lootSession, RngState& rng) const
+{
+	for (size_t m = 0; m < s_numMonsterTypes; ++m)
+	{
+		MonsterType monsterType = static_cast<MonsterType>(m);
+		auto loot = lootSession.lootMap.find(monsterType);
+		if (loot == lootSession.lootMap.end())
+		{
+			continue;
+		}
+
+		for (size_t t = 0; t < s_numTreasureTypes; ++t)
+		{
+			TreasureType treasureType = static_cast<TreasureType>(t);
+			auto dropCount = loot->second.find(treasureType);
+			if (dropCount != loot->second.end() && HasQuantity(monsterType, treasureType))
+			{
+				lootSession.quantityTotals[monsterType][treasureType]
+					+= RollQuantityTotal(monsterType, treasureType, dropCount->second, rng);
+			}
+		}
+	}
+}
+
+bool LootModel::HasMonster(MonsterType type) const
+{
+	size_t monsterIndex = static_cast<size_t>(type);
+	return monsterIndex < s_numMonsterTypes && m_monsters[monsterIndex].isLoaded;
+}
+
+const LootModel::CompiledQuantity* LootModel::GetQuantity(MonsterType monster, TreasureType treasure) const
+{
+	size_t monsterIndex = static_cast<size_t>(monster);
+	size_t treasureIndex = static_cast<size_t>(treasure);
+	if (monsterIndex >= s_numMonsterTypes || treasureIndex >= s_numTreasureTypes
+		|| m_quantities[monsterIndex][treasureIndex].rangeCount == 0)
+	{
+		return nullptr;
+	}
+	return &m_quantities[monsterIndex][treasureIndex];
+}
+
+TreasureType LootModel::RollTable(const CompiledTable& table, RngState& rng) const
+{
+	// Roulette selection, with the same arithmetic as LootTable::Roll.
+	const float* weights = m_weights.data() + table.firstTreasure;
+	float randomNumber = NextRandomFloat(rng, 0.0f, table.weightTotal);
+	for (uint32_t i = 0; i < table.treasureCount; ++i)
+	{
+		if (randomNumber < weights[i])
+		{
+			return m_treasureTypes[table.firstTreasure + i];
+		}
+		randomNumber -= weights[i];
+	}
+
+	// Rounding in the subtractions can carry the roll past the end. It belongs to the last
+	// entry that can drop.
+	for (uint32_t i = table.treasureCount; i-- > 0;)
+	{
+		if (weights[i] > 0.0f)
+		{
+			return m_treasureTypes[table.firstTreasure + i];
+		}
+	}
+	return TreasureType::NONE;
+}
+
+double LootModel::GetTableChance(const CompiledTable& table, TreasureType treasure,
+	uint32_t magicFindBucket) const
+{
+	if (table.weightTotal <= 0.0f)
+	{
+		return 0.0;
+	}
+
+	// The weights RollTable or RollTableVariant pick by.
+	double exponent = 1.0 / (1.0 + magicFindBucket * static_cast<double>(s_magicFindStep));
+	double weightTotal = 0.0;
+	double treasureWeight = 0.0;
+	for (uint32_t i = 0; i < table.treasureCount; ++i)
+	{
+		double weight = static_cast<double>(m_weights[table.firstTreasure + i]);
+		if (magicFindBucket > 0)
+		{
+			weight = std::pow(weight, exponent);
+		}
+
+		weightTotal += weight;
+		if (m_treasureTypes[table.firstTreasure + i] == treasure)
+		{
+			treasureWeight += weight;
+		}
+	}
+
+	// Unscaled weights are picked against the table's own float total, as RollTable does
+	// and ForEachTreasureChance assumes, so every model of a kill agrees.
+	if (magicFindBucket == 0)
+	{
+		weightTotal = static_cast<double>(table.weightTotal);
+	}
+	return weightTotal > 0.0 ? treasureWeight / weightTotal : 0.0;
+}
+
+TreasureType LootModel::RollTableVariant(const CompiledTable& table, uint32_t magicFindBucket,
+	RngState& rng) const
+{
+	// Tables that can't drop anything still draw, as RollTable does.
+	if (table.weightTotal <= 0.0f)
+	{
+		NextRandom(rng);
+		return TreasureType::NONE;
+	}
+
+	// A thread rolls the same bucket kill after kill, so it only goes to the shared cache
+	// the first time it meets each table in it.
+	ResolvedVariants& resolved = t_resolvedVariants;
+	if (resolved.cacheId != m_tableVariants->GetId() || resolved.magicFindBucket != magicFindBucket)
+	{
+		resolved.cacheId = m_tableVariants->GetId();
+		resolved.magicFindBucket = magicFindBucket;
+		resolved.tables.assign(m_tables.size(), nullptr);
+	}
+
+	size_t tableIndex = static_cast<size_t>(&table - m_tables.data());
+	std::shared_ptr<const AliasTable>& variant = resolved.tables[tableIndex];
+	if (!variant)
+	{
+		variant = m_tableVariants->GetOrBuild((static_cast<uint64_t>(tableIndex) << 32) | magicFindBucket, [&]()
+		{
+			double exponent = 1.0 / (1.0 + magicFindBucket * static_cast<double>(s_magicFindStep));
+			std::vector<double> weights(table.treasureCount);
+			for (uint32_t i = 0; i < table.treasureCount; ++i)
+			{
+				weights[i] = std::pow(static_cast<double>(m_weights[table.firstTreasure + i]), exponent);
+			}
+			return BuildAliasTable(weights);
+		});
+	}
+
+	return m_treasureTypes[table.firstTreasure + PickAlias(*variant, rng)];
+}
+
+//===============================================================
+
+} // namespace LootSimulator
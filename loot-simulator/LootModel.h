@@ -0,0 +1,219 @@
+//---------------------------------------------------------------
+//
+// LootModel.h
+//
+
+#pragma once
+
+#include "AliasTableCache.h"
+#include "GameTypes.h"
+#include "LootCounters.h"
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// No kill drops more than this. Content that could is rejected when it's loaded.
+static const size_t s_maxDropsPerKill = 64;
+
+// Magic find is rounded to steps of this, so players with about the same value share
+// compiled tables.
+static const float s_magicFindStep = 0.05f;
+
+// Magic find above this many steps, +1000%, rolls as this many.
+static const uint32_t s_maxMagicFindBucket = 200;
+
+// Table variants kept compiled at once, across every table and magic find bucket.
+static const size_t s_maxCachedTableVariants = 4096;
+
+// Bucket of a magic find given as a fraction, 0.5 for +50%. 0 for none, or anything that
+// isn't a positive number.
+uint32_t GetMagicFindBucket(float magicFind);
+
+// Immutable, flattened copy of the loaded monsters built for rolling. Everything a kill
+// touches is in a few contiguous arrays, and rolling allocates nothing, takes no locks
+// and notifies nobody, so any number of threads can roll on one model at once.
+// Rolls draw exactly what Monster::RerollLoot would, so both give the same drops for
+// the same stream.
+class LootModel
+{
+public:
+	LootModel();
+
+	// Random kills spawn monsters by the weights in encounters. Without one every monster
+	// type is as likely.
+	explicit LootModel(const std::set<Monster>& monsters, const EncounterTable* encounters = nullptr);
+
+	// Rolls one kill of type, writing up to capacity drops to out. Returns how many
+	// dropped, which can be more than capacity; GetMaxDropCount is always enough.
+	size_t RollLoot(MonsterType type, RngState& rng, TreasureType* out, size_t capacity) const;
+
+	template <size_t N>
+	size_t RollLoot(MonsterType type, RngState& rng, TreasureType (&out)[N]) const
+	{
+		return RollLoot(type, rng, out, N);
+	}
+
+	// Rolls one kill of type for a player in the given magic find bucket. Magic find evens
+	// out every table, raising its weights to 1 / (1 + magic find), so rare treasures drop
+	// more often at the expense of common ones. Bucket 0 rolls exactly as RollLoot does.
+	// Other buckets pick from an alias table per loot table, built the first time it's
+	// needed and cached, so a roll stays constant time however many players there are.
+	// Each thread remembers the tables of the bucket it last rolled, so rolling the same
+	// bucket again takes no locks. Quantity totals of batches still come from the unmodified weights.
+	size_t RollLoot(MonsterType type, uint32_t magicFindBucket, RngState& rng, TreasureType* out,
+		size_t capacity) const;
+
+	template <size_t N>
+	size_t RollLoot(MonsterType type, uint32_t magicFindBucket, RngState& rng, TreasureType (&out)[N]) const
+	{
+		return RollLoot(type, magicFindBucket, rng, out, N);
+	}
+
+	// Picks a monster type the way random kills do. One draw, off an alias table.
+	MonsterType RollMonsterType(RngState& rng) const;
+
+	// Splits count random kills across monster types all at once, drawing the counts
+	// RollMonsterType would give count times from their multinomial distribution. Costs
+	// the same however large count is, so batches can then run each type on its own.
+	void RollMonsterCounts(int64_t count, RngState& rng, int64_t (&counts)[s_numMonsterTypes]) const;
+
+	// Exact number of each treasure one kill of type drops on average, indexed by treasure
+	// type. Worked out from the tables rather than by rolling.
+	void GetExpectedDropCounts(MonsterType type, double (&expectedCounts)[s_numTreasureTypes]) const;
+
+	// Chance of each number of treasure one kill of type drops, in the given magic find
+	// bucket: chances[k] is the chance of exactly k. Worked out from the tables, so a kill
+	// with several guaranteed tables isn't treated as a single yes or no.
+	void GetDropCountChances(MonsterType type, TreasureType treasure, uint32_t magicFindBucket,
+		std::vector<double>& chances) const;
+
+	// Chance of each set of treasures one kill of type drops, as a mask with bit i for
+	// treasures[i], ignoring everything else. Only masks that can happen are listed, so
+	// the list stays short however many treasures there are. At most 64 treasures.
+	void GetDropMaskChances(MonsterType type, const std::vector<TreasureType>& treasures,
+		uint32_t magicFindBucket, std::vector<std::pair<uint64_t, double>>& maskChances) const;
+
+	// Mean and mean square of what one kill of type is worth in the given magic find bucket,
+	// with each treasure worth values[t] per unit. Quantities count, with their own spread.
+	// Worked out from the tables rather than by rolling.
+	void GetValueMoments(MonsterType type, const double (&values)[s_numTreasureTypes], uint32_t magicFindBucket,
+		double& mean, double& meanSquare) const;
+
+	// Chance a random kill spawns type.
+	double GetEncounterChance(MonsterType type) const;
+
+	// Most drops any one kill can produce.
+	size_t GetMaxDropCount() const { return m_maxDropCount; }
+
+	// Whether treasure drops in quantities for monster rather than one at a time.
+	bool HasQuantity(MonsterType monster, TreasureType treasure) const;
+
+	// Quantity of one drop of treasure from a kill of monster. Draws nothing for treasures
+	// that always drop the same quantity, so content without quantities rolls as before.
+	int64_t RollQuantity(MonsterType monster, TreasureType treasure, RngState& rng) const;
+
+	// Total quantity of dropCount drops. Small counts are rolled drop by drop. Large ones
+	// are drawn at once from the normal distribution the sum tends to, using the mean and
+	// variance of the ranges, so the cost doesn't grow with the count.
+	int64_t RollQuantityTotal(MonsterType monster, TreasureType treasure, int64_t dropCount,
+		RngState& rng) const;
+
+	// Adds quantity totals for everything lootSession counted, for batches that only
+	// counted drops. Draws in a fixed order, so the same counts and stream always agree.
+	void RollSessionQuantities(LootSession& lootSession, RngState& rng) const;
+
+	bool HasMonster(MonsterType type) const;
+
+private:
+	struct CompiledTable
+	{
+		uint32_t firstTreasure = 0;
+		uint32_t treasureCount = 0;
+
+		// Summed in data order, exactly as LootTable::Roll does.
+		float weightTotal = 0.0f;
+
+		// Chance of this table being the one picked, for exclusive tables.
+		float dropRate = 1.0f;
+	};
+
+	// Exclusive tables come first, then guaranteed ones, in RerollLoot's order.
+	struct CompiledMonster
+	{
+		uint32_t firstTable = 0;
+		uint32_t exclusiveCount = 0;
+		uint32_t tableCount = 0;
+		bool isLoaded = false;
+	};
+
+	// One treasure entry's quantity range, weighted by its chance to drop per kill.
+	struct QuantityRange
+	{
+		int32_t min = 1;
+		int32_t max = 1;
+		double weight = 0.0;
+	};
+
+	// Every range one treasure drops with for one monster, and their moments.
+	struct CompiledQuantity
+	{
+		uint32_t firstRange = 0;
+		uint32_t rangeCount = 0;
+		double weightTotal = 0.0;
+		double mean = 1.0;
+		double variance = 0.0;
+		int32_t min = 1;
+		int32_t max = 1;
+	};
+
+	TreasureType RollTable(const CompiledTable& table, RngState& rng) const;
+
+	// Chance one roll of table in the given magic find bucket picks treasure.
+	double GetTableChance(const CompiledTable& table, TreasureType treasure, uint32_t magicFindBucket) const;
+	TreasureType RollTableVariant(const CompiledTable& table, uint32_t magicFindBucket, RngState& rng) const;
+
+	// The exclusive or guaranteed tables of a kill, picking each table's treasure with
+	// rollTable(table, rng).
+	template <typename RollTableFunction>
+	size_t RollMonster(MonsterType type, RngState& rng, TreasureType* out, size_t capacity,
+		RollTableFunction rollTable) const;
+
+	// Calls addTreasure(treasureIndex, chance) with each treasure entry of monster and its
+	// chance to drop per kill.
+	template <typename Function>
+	void ForEachTreasureChance(const CompiledMonster& monster, Function addTreasure) const;
+
+	void CompileQuantities(MonsterType type, const std::vector<LootTable>& tables);
+	void CompileEncounters(const double (&weights)[s_numMonsterTypes]);
+	const CompiledQuantity* GetQuantity(MonsterType monster, TreasureType treasure) const;
+
+private:
+	CompiledMonster m_monsters[s_numMonsterTypes];
+	std::vector<CompiledTable> m_tables;
+	std::vector<float> m_weights;
+	std::vector<TreasureType> m_treasureTypes;
+	size_t m_maxDropCount = 0;
+
+	CompiledQuantity m_quantities[s_numMonsterTypes][s_numTreasureTypes];
+	std::vector<QuantityRange> m_quantityRanges;
+
+	// Alias table over monster types.
+	AliasTable m_encounters;
+
+	// Chance a random kill is type i given it isn't any type before i.
+	double m_encounterShares[s_numMonsterTypes] = {};
+
+	// Tables with magic find applied, keyed by table index and bucket.
+	std::unique_ptr<AliasTableCache> m_tableVariants;
+};
+
+//===============================================================
+
+} // namespace LootSimulator
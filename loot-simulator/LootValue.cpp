@@ -0,0 +1,171 @@
+//---------------------------------------------------------------
+//
+// LootValue.cpp
+//
+
+#include "LootValue.h"
+
+#include "Game.h"
+#include "PerfCounters.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <thread>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Roughly how many kills make a block. Blocks are always whole sessions.
+static const int64_t s_valueBlockKills = 65536;
+
+//---------------------------------------------------------------
+
+void GetTreasureValueTable(const std::vector<TreasureValue>& treasureValues,
+	double (&values)[s_numTreasureTypes])
+{
+	std::fill(std::begin(values), std::end(values), 0.0);
+	for (const TreasureValue& treasureValue : treasureValues)
+	{
+		size_t treasureIndex = static_cast<size_t>(treasureValue.treasure);
+		if (treasureIndex < s_numTreasureTypes)
+		{
+			values[treasureIndex] = treasureValue.value;
+		}
+	}
+}
+
+void RunLootValueSimulation(const Game& game, std::optional<MonsterType> type, int64_t killCount,
+	int64_t sessionKills, int32_t threadCount, uint64_t seed, LootValueReport& report)
+{
+	TRACE_SCOPE("RunLootValueSimulation");
+
+	report.killCount = killCount;
+	report.sessionKills = sessionKills;
+
+	const LootModel& lootModel = game.GetLootModel();
+	double values[s_numTreasureTypes];
+	GetTreasureValueTable(game.GetTreasureValues(), values);
+
+	int64_t blockKills = std::max(s_valueBlockKills / sessionKills, int64_t(1)) * sessionKills;
+	int64_t blockCount = (killCount + blockKills - 1) / blockKills;
+	std::atomic<int64_t> nextBlock = 0;
+	std::mutex mergeMutex;
+
+	// Written by whichever thread ran the block, read once they've all joined.
+	std::vector<ValueMoments> blockKillValues(static_cast<size_t>(blockCount));
+	std::vector<ValueMoments> blockSessionValues(static_cast<size_t>(blockCount));
+
+	auto runThread = [&]()
+	{
+		TRACE_SCOPE("LootValueThread");
+		PerfCounters::ScopedPhase perfPhase("LootValue");
+
+		LatencyHistogram killHistogram;
+		LatencyHistogram sessionHistogram;
+		RngState blockRng = SeedRng(seed);
+		int64_t blockRngIndex = 0;
+		int64_t threadKills = 0;
+		TreasureType drops[s_maxDropsPerKill];
+
+		for (int64_t block = nextBlock.fetch_add(1); block < blockCount; block = nextBlock.fetch_add(1))
+		{
+			for (; blockRngIndex < block; ++blockRngIndex)
+			{
+				JumpRng(blockRng);
+			}
+			RngState rng = blockRng;
+
+			ValueMoments& killValues = blockKillValues[static_cast<size_t>(block)];
+			ValueMoments& sessionValues = blockSessionValues[static_cast<size_t>(block)];
+			int64_t kills = std::min(blockKills, killCount - block * blockKills);
+			double sessionValue = 0.0;
+			for (int64_t kill = 1; kill <= kills; ++kill)
+			{
+				MonsterType monsterType = type.has_value() ? type.value() : lootModel.RollMonsterType(rng);
+				size_t dropCount = game.RollDrops(monsterType, rng, drops);
+
+				double killValue = 0.0;
+				for (size_t i = 0; i < dropCount; ++i)
+				{
+					size_t treasureIndex = static_cast<size_t>(drops[i]);
+					if (treasureIndex >= s_numTreasureTypes)
+					{
+						continue;
+					}
+
+					double value = values[treasureIndex];
+					killValue += value * static_cast<double>(lootModel.RollQuantity(monsterType, drops[i], rng));
+				}
+				killValues.Record(killValue);
+				killHistogram.Record(static_cast<uint64_t>(std::llround(killValue)));
+
+				// Only whole sessions count; a batch that doesn't divide leaves a short one out.
+				sessionValue += killValue;
+				if (kill % sessionKills == 0)
+				{
+					sessionValues.Record(sessionValue);
+					sessionHistogram.Record(static_cast<uint64_t>(std::llround(sessionValue)));
+					sessionValue = 0.0;
+				}
+			}
+			threadKills += kills;
+		}
+		perfPhase.SetKillCount(threadKills);
+
+		std::lock_guard<std::mutex> lock(mergeMutex);
+		report.killHistogram.Merge(killHistogram);
+		report.sessionHistogram.Merge(sessionHistogram);
+	};
+
+	std::vector<std::thread> threads;
+	for (int32_t i = 1; i < threadCount; ++i)
+	{
+		threads.emplace_back(runThread);
+	}
+	runThread();
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	for (size_t block = 0; block < blockKillValues.size(); ++block)
+	{
+		report.killValues.Merge(blockKillValues[block]);
+		report.sessionValues.Merge(blockSessionValues[block]);
+	}
+}
+
+void GetExpectedLootValue(const LootModel& lootModel, std::optional<MonsterType> type,
+	const double (&values)[s_numTreasureTypes], uint32_t magicFindBucket, double& mean, double& variance)
+{
+	double meanSquare = 0.0;
+	if (type.has_value())
+	{
+		lootModel.GetValueMoments(type.value(), values, magicFindBucket, mean, meanSquare);
+	}
+	else
+	{
+		// A random kill is a mix of every type's kill, weighted by how likely it spawns.
+		mean = 0.0;
+		for (size_t m = 0; m < s_numMonsterTypes; ++m)
+		{
+			MonsterType monsterType = static_cast<MonsterType>(m);
+			double encounterChance = lootModel.GetEncounterChance(monsterType);
+			double typeMean = 0.0;
+			double typeMeanSquare = 0.0;
+			lootModel.GetValueMoments(monsterType, values, magicFindBucket, typeMean, typeMeanSquare);
+			mean += encounterChance * typeMean;
+			meanSquare += encounterChance * typeMeanSquare;
+		}
+	}
+	variance = std::max(meanSquare - mean * mean, 0.0);
+}
+
+//===============================================================
+
+} // namespace LootSimulator
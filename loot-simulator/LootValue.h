@@ -0,0 +1,58 @@
+//---------------------------------------------------------------
+//
+// LootValue.h
+//
+
+#pragma once
+
+#include "GameTypes.h"
+#include "LatencyHistogram.h"
+#include "LootCounters.h"
+#include "ValueMoments.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+class Game;
+class LootModel;
+
+// What kills and sessions of kills were worth in a value simulation.
+struct LootValueReport
+{
+	int64_t killCount = 0;
+	int64_t sessionKills = 0;
+
+	ValueMoments killValues;
+	ValueMoments sessionValues;
+
+	// Values rounded to whole gold. LatencyHistogram is as happy with gold as nanoseconds.
+	LatencyHistogram killHistogram;
+	LatencyHistogram sessionHistogram;
+};
+
+// Gold value of every treasure type, indexed by type. Treasures without one are worth 0.
+void GetTreasureValueTable(const std::vector<TreasureValue>& treasureValues,
+	double (&values)[s_numTreasureTypes]);
+
+// Slays killCount monsters of type, or random ones if it isn't set, on threadCount threads
+// and records what each kill is worth by the game's treasure values, quantities included,
+// and what each run of sessionKills kills in a row is worth. Recording allocates nothing.
+// Kills are cut into blocks of whole sessions, and block i always draws from substream i
+// of seed. Moments are kept per block and merged in block order, and histograms only add
+// counts, so the thread count doesn't change the result. Nobody is notified.
+void RunLootValueSimulation(const Game& game, std::optional<MonsterType> type, int64_t killCount,
+	int64_t sessionKills, int32_t threadCount, uint64_t seed, LootValueReport& report);
+
+// Exact mean and variance of what one kill is worth, from the compiled tables, to check
+// simulations against. Sessions of n kills have n times both.
+void GetExpectedLootValue(const LootModel& lootModel, std::optional<MonsterType> type,
+	const double (&values)[s_numTreasureTypes], uint32_t magicFindBucket, double& mean, double& variance);
+
+//===============================================================
+
+} // namespace LootSimulator
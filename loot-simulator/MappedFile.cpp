@@ -0,0 +1,155 @@
+//---------------------------------------------------------------
+//
+// MappedFile.cpp
+//
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace LootSimulator {
+
+//===============================================================
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		DWORD lastError = GetLastError();
+		m_isMissing = lastError == ERROR_FILE_NOT_FOUND || lastError == ERROR_PATH_NOT_FOUND;
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	// Windows refuses to map empty files.
+	if (size.QuadPart == 0)
+	{
+		m_file = file;
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (!view)
+	{
+		if (mapping)
+		{
+			CloseHandle(mapping);
+		}
+		CloseHandle(file);
+		return false;
+	}
+
+	m_file = file;
+	m_mapping = mapping;
+	m_data = static_cast<const char*>(view);
+	m_size = static_cast<size_t>(size.QuadPart);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_data)
+	{
+		UnmapViewOfFile(m_data);
+		CloseHandle(m_mapping);
+	}
+	if (m_file)
+	{
+		CloseHandle(m_file);
+	}
+
+	m_data = nullptr;
+	m_size = 0;
+	m_isMissing = false;
+	m_file = nullptr;
+	m_mapping = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+
+	int fileDescriptor = open(path.c_str(), O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		m_isMissing = errno == ENOENT;
+		return false;
+	}
+
+	struct stat status;
+	if (fstat(fileDescriptor, &status) != 0 || !S_ISREG(status.st_mode))
+	{
+		close(fileDescriptor);
+		return false;
+	}
+
+	// mmap refuses zero lengths.
+	size_t size = static_cast<size_t>(status.st_size);
+	void* view = size > 0
+		? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0)
+		: nullptr;
+
+	// The mapping keeps the file alive on its own.
+	close(fileDescriptor);
+	if (view == MAP_FAILED)
+	{
+		return false;
+	}
+
+	if (view)
+	{
+		// Parsed front to back exactly once.
+		madvise(view, size, MADV_SEQUENTIAL);
+	}
+
+	m_data = static_cast<const char*>(view);
+	m_size = size;
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_data)
+	{
+		munmap(const_cast<char*>(m_data), m_size);
+	}
+
+	m_data = nullptr;
+	m_size = 0;
+	m_isMissing = false;
+}
+
+#endif
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,49 @@
+//---------------------------------------------------------------
+//
+// MappedFile.h
+//
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// A whole file mapped read only.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Empty files open fine and have no data.
+	bool Open(const std::string& path);
+	void Close();
+
+	// True if the last Open failed because there was no file at the path, as opposed to
+	// one that couldn't be read.
+	bool IsMissing() const { return m_isMissing; }
+
+	const char* GetData() const { return m_data; }
+	size_t GetSize() const { return m_size; }
+
+private:
+	const char* m_data = nullptr;
+	size_t m_size = 0;
+	bool m_isMissing = false;
+
+#ifdef _WIN32
+	void* m_file = nullptr;
+	void* m_mapping = nullptr;
+#endif
+};
+
+//===============================================================
+
+} // namespace LootSimulator
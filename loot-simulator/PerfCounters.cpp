@@ -0,0 +1,278 @@
+//---------------------------------------------------------------
+//
+// PerfCounters.cpp
+//
+
+#include "PerfCounters.h"
+
+#include "Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace {
+
+//==============================================================================
+
+using PerfCounters::PhaseCounts;
+
+std::atomic<bool> s_isEnabled = false;
+
+struct Phase
+{
+	const char* name;
+	PhaseCounts counts;
+};
+
+std::mutex s_phaseMutex;
+std::vector<Phase> s_phases;
+
+uint64_t GetNanoseconds()
+{
+	auto sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch).count());
+}
+
+#ifdef __linux__
+
+const uint64_t s_eventConfigs[] =
+{
+	PERF_COUNT_HW_CPU_CYCLES,
+	PERF_COUNT_HW_INSTRUCTIONS,
+	PERF_COUNT_HW_CACHE_MISSES,
+	PERF_COUNT_HW_BRANCH_MISSES
+};
+const size_t s_eventCount = sizeof(s_eventConfigs) / sizeof(s_eventConfigs[0]);
+
+// Counters only count the thread that opened them, so each thread gets its own group the
+// first time it enters a phase. The cycle counter leads so all four are scheduled together.
+class CounterGroup
+{
+public:
+	~CounterGroup()
+	{
+		for (int fd : m_fds)
+		{
+			close(fd);
+		}
+	}
+
+	bool Open()
+	{
+		for (uint64_t config : s_eventConfigs)
+		{
+			perf_event_attr attributes;
+			std::memset(&attributes, 0, sizeof(attributes));
+			attributes.size = sizeof(attributes);
+			attributes.type = PERF_TYPE_HARDWARE;
+			attributes.config = config;
+			attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+				| PERF_FORMAT_TOTAL_TIME_RUNNING;
+			attributes.disabled = m_fds.empty() ? 1 : 0;
+			attributes.exclude_kernel = 1;
+			attributes.exclude_hv = 1;
+
+			int groupFd = m_fds.empty() ? -1 : m_fds.front();
+			int fd = static_cast<int>(syscall(__NR_perf_event_open, &attributes, 0, -1, groupFd, 0));
+			if (fd < 0)
+			{
+				return false;
+			}
+			m_fds.push_back(fd);
+		}
+
+		ioctl(m_fds.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(m_fds.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+		return true;
+	}
+
+	bool Read(PhaseCounts& counts) const
+	{
+		struct
+		{
+			uint64_t eventCount;
+			uint64_t timeEnabled;
+			uint64_t timeRunning;
+			uint64_t values[s_eventCount];
+		} data;
+
+		if (m_fds.size() != s_eventCount
+			|| read(m_fds.front(), &data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))
+			|| data.timeRunning == 0)
+		{
+			return false;
+		}
+
+		// Scale up if the group had to share the hardware with someone else.
+		double scale = static_cast<double>(data.timeEnabled) / static_cast<double>(data.timeRunning);
+		counts.cycles = static_cast<uint64_t>(static_cast<double>(data.values[0]) * scale);
+		counts.instructions = static_cast<uint64_t>(static_cast<double>(data.values[1]) * scale);
+		counts.cacheMisses = static_cast<uint64_t>(static_cast<double>(data.values[2]) * scale);
+		counts.branchMisses = static_cast<uint64_t>(static_cast<double>(data.values[3]) * scale);
+		return true;
+	}
+
+private:
+	std::vector<int> m_fds;
+};
+
+// Null if this thread couldn't open its counters.
+CounterGroup* GetThreadCounterGroup()
+{
+	thread_local bool s_isOpened = false;
+	thread_local CounterGroup s_group;
+	thread_local bool s_isValid = false;
+	if (!s_isOpened)
+	{
+		s_isOpened = true;
+		s_isValid = s_group.Open();
+	}
+	return s_isValid ? &s_group : nullptr;
+}
+
+bool ReadThreadCounters(PhaseCounts& counts)
+{
+	CounterGroup* group = GetThreadCounterGroup();
+	return group && group->Read(counts);
+}
+
+#else
+
+bool ReadThreadCounters(PhaseCounts&)
+{
+	return false;
+}
+
+#endif
+
+void AddToPhase(const char* name, int64_t killCount, const PhaseCounts& start, const PhaseCounts& end)
+{
+	std::lock_guard<std::mutex> lock(s_phaseMutex);
+	auto phase = std::find_if(s_phases.begin(), s_phases.end(), [name](const Phase& p)
+	{
+		return p.name == name;
+	});
+	if (phase == s_phases.end())
+	{
+		phase = s_phases.insert(s_phases.end(), Phase{ name, PhaseCounts() });
+	}
+
+	PhaseCounts& counts = phase->counts;
+	counts.runCount++;
+	counts.killCount += static_cast<uint64_t>(std::max<int64_t>(killCount, 0));
+	counts.nanoseconds += end.nanoseconds - start.nanoseconds;
+	counts.cycles += end.cycles - start.cycles;
+	counts.instructions += end.instructions - start.instructions;
+	counts.cacheMisses += end.cacheMisses - start.cacheMisses;
+	counts.branchMisses += end.branchMisses - start.branchMisses;
+}
+
+double PerKill(uint64_t value, uint64_t killCount)
+{
+	return static_cast<double>(value) / static_cast<double>(killCount);
+}
+
+//==============================================================================
+
+} // anonymous namespace
+
+bool PerfCounters::Start()
+{
+	PhaseCounts counts;
+	if (!ReadThreadCounters(counts))
+	{
+		LOG_WARNING("Hardware performance counters are not available.");
+		return false;
+	}
+
+	s_isEnabled.store(true, std::memory_order_relaxed);
+	return true;
+}
+
+bool PerfCounters::IsEnabled()
+{
+	return s_isEnabled.load(std::memory_order_relaxed);
+}
+
+void PerfCounters::WriteReport(std::ostream& stream)
+{
+	std::lock_guard<std::mutex> lock(s_phaseMutex);
+	if (s_phases.empty())
+	{
+		return;
+	}
+
+	char line[256];
+	std::snprintf(line, sizeof(line), "%-16s %6s %12s %12s %14s %14s %6s %12s %12s\n",
+		"phase", "runs", "kills", "time", "cycles", "instructions", "ipc", "cache miss", "branch miss");
+	stream << line;
+
+	for (const Phase& phase : s_phases)
+	{
+		const PhaseCounts& counts = phase.counts;
+		double ipc = counts.cycles > 0
+			? static_cast<double>(counts.instructions) / static_cast<double>(counts.cycles)
+			: 0.0;
+
+		std::snprintf(line, sizeof(line),
+			"%-16s %6llu %12llu %10.2fms %14llu %14llu %6.2f %12llu %12llu\n",
+			phase.name,
+			static_cast<unsigned long long>(counts.runCount),
+			static_cast<unsigned long long>(counts.killCount),
+			static_cast<double>(counts.nanoseconds) / 1e6,
+			static_cast<unsigned long long>(counts.cycles),
+			static_cast<unsigned long long>(counts.instructions),
+			ipc,
+			static_cast<unsigned long long>(counts.cacheMisses),
+			static_cast<unsigned long long>(counts.branchMisses));
+		stream << line;
+
+		if (counts.killCount > 0)
+		{
+			std::snprintf(line, sizeof(line),
+				"%-16s %6s %12s %10.1fns %14.1f %14.1f %6s %12.3f %12.3f\n",
+				"  per kill", "", "",
+				PerKill(counts.nanoseconds, counts.killCount),
+				PerKill(counts.cycles, counts.killCount),
+				PerKill(counts.instructions, counts.killCount),
+				"",
+				PerKill(counts.cacheMisses, counts.killCount),
+				PerKill(counts.branchMisses, counts.killCount));
+			stream << line;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+
+PerfCounters::ScopedPhase::ScopedPhase(const char* name)
+	: m_name(name)
+{
+	if (IsEnabled())
+	{
+		m_isCounting = ReadThreadCounters(m_start);
+		m_start.nanoseconds = GetNanoseconds();
+	}
+}
+
+PerfCounters::ScopedPhase::~ScopedPhase()
+{
+	PhaseCounts end;
+	if (m_isCounting && ReadThreadCounters(end))
+	{
+		end.nanoseconds = GetNanoseconds();
+		AddToPhase(m_name, m_killCount, m_start, end);
+	}
+}
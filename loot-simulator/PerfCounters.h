@@ -0,0 +1,62 @@
+//---------------------------------------------------------------
+//
+// PerfCounters.h
+//
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+namespace PerfCounters {
+
+//==============================================================================
+
+// Counts for one phase, summed over every time it ran.
+struct PhaseCounts
+{
+	uint64_t runCount = 0;
+	uint64_t killCount = 0;
+	uint64_t nanoseconds = 0;
+	uint64_t cycles = 0;
+	uint64_t instructions = 0;
+	uint64_t cacheMisses = 0;
+	uint64_t branchMisses = 0;
+};
+
+// Turns on hardware counting for phases. Uses perf_event_open, so it only does anything
+// on Linux; elsewhere, or if the kernel says no, it returns false and phases are free.
+bool Start();
+
+bool IsEnabled();
+
+// Writes one line per phase, in the order they first ran, with totals and per kill figures.
+void WriteReport(std::ostream& stream);
+
+//------------------------------------------------------------------------------
+
+// Counts the calling thread's events for its lifetime and adds them to the named phase.
+// Work done by other threads or processes, like shards, isn't included.
+class ScopedPhase
+{
+public:
+	// Name must be a string literal; only the pointer is kept.
+	explicit ScopedPhase(const char* name);
+	~ScopedPhase();
+
+	ScopedPhase(const ScopedPhase&) = delete;
+	ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+	// Kills the phase covers, for the per kill columns.
+	void SetKillCount(int64_t killCount) { m_killCount = killCount; }
+
+private:
+	const char* m_name;
+	int64_t m_killCount = 0;
+	bool m_isCounting = false;
+	PhaseCounts m_start;
+};
+
+//==============================================================================
+
+} // namespace PerfCounters
@@ -0,0 +1,138 @@
+//---------------------------------------------------------------
+//
+// PitySimulation.cpp
+//
+
+#include "PitySimulation.h"
+
+#include "Game.h"
+#include "LiveStats.h"
+#include "Trace.h"
+
+#include <algorithm>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Players per block. A block's counters for a handful of rules fit in L1.
+static const size_t s_pityBlockSize = 1024;
+
+//---------------------------------------------------------------
+
+PityPopulation::PityPopulation(const std::vector<PityRule>& rules, size_t blockSize)
+	: m_rules(rules)
+	, m_blockSize(blockSize)
+	, m_dryKills(rules.size() * blockSize, 0)
+	, m_counts(rules.size())
+{
+}
+
+void PityPopulation::ResetPlayers()
+{
+	std::fill(m_dryKills.begin(), m_dryKills.end(), 0);
+}
+
+void PityPopulation::ApplyKills(size_t count, const MonsterType* monsters, const uint8_t* const* dropped)
+{
+	for (size_t r = 0; r < m_rules.size(); ++r)
+	{
+		const PityRule& rule = m_rules[r];
+		const MonsterType monster = rule.monster;
+		const uint32_t afterKills = static_cast<uint32_t>(rule.afterKills);
+		const uint8_t* ruleDropped = dropped[r];
+		uint32_t* dryKills = m_dryKills.data() + r * m_blockSize;
+
+		// Selects rather than branches, so this is one straight pass the compiler can
+		// vectorize. Kills of other monsters leave the count alone.
+		uint32_t kills = 0;
+		uint32_t naturalDrops = 0;
+		uint32_t pityDrops = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			uint32_t isKill = monsters[i] == monster ? 1 : 0;
+			uint32_t isDrop = ruleDropped[i] != 0 ? 1 : 0;
+			uint32_t next = isDrop ? 0 : dryKills[i] + isKill;
+			uint32_t isPity = (isKill & (next >= afterKills ? 1 : 0));
+			dryKills[i] = isPity ? 0 : next;
+
+			kills += isKill;
+			naturalDrops += isDrop;
+			pityDrops += isPity;
+		}
+
+		m_counts[r].kills += kills;
+		m_counts[r].naturalDrops += naturalDrops;
+		m_counts[r].pityDrops += pityDrops;
+	}
+}
+
+//---------------------------------------------------------------
+
+std::vector<PityRuleReport> RunPitySimulation(const Game& game, std::optional<MonsterType> type,
+	int64_t playerCount, int64_t killsPerPlayer, uint64_t seed)
+{
+	TRACE_SCOPE("RunPitySimulation");
+
+	const LootModel& lootModel = game.GetLootModel();
+	PityPopulation population(game.GetPityRules(), s_pityBlockSize);
+	const std::vector<PityRule>& rules = population.GetRules();
+
+	// Kills of one block, rolled first and then handed to the population in one pass.
+	MonsterType monsters[s_pityBlockSize];
+	std::vector<uint8_t> dropped(rules.size() * s_pityBlockSize);
+	std::vector<const uint8_t*> ruleDropped(rules.size());
+	for (size_t r = 0; r < rules.size(); ++r)
+	{
+		ruleDropped[r] = dropped.data() + r * s_pityBlockSize;
+	}
+
+	RngState rng = SeedRng(seed);
+	StatsProgress progress(playerCount * killsPerPlayer);
+	TreasureType drops[s_maxDropsPerKill];
+
+	for (int64_t firstPlayer = 0; firstPlayer < playerCount; firstPlayer += static_cast<int64_t>(s_pityBlockSize))
+	{
+		size_t count = static_cast<size_t>(std::min<int64_t>(s_pityBlockSize, playerCount - firstPlayer));
+		population.ResetPlayers();
+		for (int64_t kill = 0; kill < killsPerPlayer; ++kill)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				MonsterType monsterType = type.has_value() ? type.value() : lootModel.RollMonsterType(rng);
+				size_t dropCount = game.RollDrops(monsterType, rng, drops);
+				monsters[i] = monsterType;
+
+				for (size_t r = 0; r < rules.size(); ++r)
+				{
+					dropped[r * s_pityBlockSize + i] = rules[r].monster == monsterType
+						&& std::find(drops, drops + dropCount, rules[r].treasure) != drops + dropCount;
+				}
+				progress.AddKill(dropCount);
+			}
+
+			population.ApplyKills(count, monsters, ruleDropped.data());
+		}
+	}
+
+	// With the magic find the kills were rolled with, so pity is measured against what they
+	// would have dropped anyway.
+	std::vector<PityRuleReport> reports(rules.size());
+	std::vector<double> chances;
+	for (size_t r = 0; r < rules.size(); ++r)
+	{
+		lootModel.GetDropCountChances(rules[r].monster, rules[r].treasure, game.GetKillMagicFindBucket(), chances);
+
+		reports[r].rule = rules[r];
+		reports[r].counts = population.GetCounts()[r];
+		for (size_t k = 1; k < chances.size(); ++k)
+		{
+			reports[r].baseRate += static_cast<double>(k) * chances[k];
+		}
+	}
+	return reports;
+}
+
+//===============================================================
+
+} // namespace LootSimulator
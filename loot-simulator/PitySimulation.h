@@ -0,0 +1,84 @@
+//---------------------------------------------------------------
+//
+// PitySimulation.h
+//
+
+#pragma once
+
+#include "GameTypes.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+class Game;
+
+// Running totals for one pity rule.
+struct PityRuleCounts
+{
+	// Kills of the rule's monster.
+	int64_t kills = 0;
+
+	// Kills the tables dropped the rule's treasure on by themselves, and kills pity added
+	// it to.
+	int64_t naturalDrops = 0;
+	int64_t pityDrops = 0;
+};
+
+// Pity state of a block of players, stored as one column of dry kill counts per rule
+// rather than one record per player. Applying kills walks each column in order with no
+// branches, so the compiler vectorizes it and a pass touches only the counters it needs.
+// A population is run one block after another through the same state, so memory follows
+// the block size rather than the number of players; the counts add up over every block.
+class PityPopulation
+{
+public:
+	PityPopulation(const std::vector<PityRule>& rules, size_t blockSize);
+
+	// Starts a block of new players, none of them with any kills.
+	void ResetPlayers();
+
+	// Gives one kill each to the first count players of the block. monsters[i] is what
+	// player i slew, and dropped[r][i] is non-zero if that kill dropped rule r's treasure
+	// on its own.
+	void ApplyKills(size_t count, const MonsterType* monsters, const uint8_t* const* dropped);
+
+	size_t GetBlockSize() const { return m_blockSize; }
+	const std::vector<PityRule>& GetRules() const { return m_rules; }
+	const std::vector<PityRuleCounts>& GetCounts() const { return m_counts; }
+
+private:
+	std::vector<PityRule> m_rules;
+	size_t m_blockSize = 0;
+
+	// Kills since each player last got each rule's treasure, rule after rule.
+	std::vector<uint32_t> m_dryKills;
+
+	std::vector<PityRuleCounts> m_counts;
+};
+
+// How one rule changed drop rates over a population.
+struct PityRuleReport
+{
+	PityRule rule;
+	PityRuleCounts counts;
+
+	// Drops of the treasure per kill without pity, worked out from the tables with the
+	// game's magic find. The chance of it dropping, unless more than one table can drop it.
+	double baseRate = 0.0;
+};
+
+// Gives each of playerCount players killsPerPlayer kills under the game's pity rules and
+// reports each rule. Players are run a block at a time, every kill of a block before the
+// next, so their counters stay in cache. Random types are picked per kill. Draws from a
+// stream seeded with seed; nobody is notified.
+std::vector<PityRuleReport> RunPitySimulation(const Game& game, std::optional<MonsterType> type,
+	int64_t playerCount, int64_t killsPerPlayer, uint64_t seed);
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,111 @@
+//---------------------------------------------------------------
+//
+// PopulationSimulation.cpp
+//
+
+#include "PopulationSimulation.h"
+
+#include "Game.h"
+#include "PerfCounters.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Players per block. Big enough that jumping to a block's substream costs nothing next to
+// rolling it, small enough that threads finish together.
+static const int64_t s_populationBlockSize = 4096;
+
+//---------------------------------------------------------------
+
+void RunPopulationSimulation(const Game& game, std::optional<MonsterType> type, int64_t playerCount,
+	int64_t killsPerPlayer, int32_t threadCount, uint64_t seed, PopulationReport& report)
+{
+	TRACE_SCOPE("RunPopulationSimulation");
+
+	report.playerCount = playerCount;
+	report.killsPerPlayer = killsPerPlayer;
+
+	const LootModel& lootModel = game.GetLootModel();
+	int64_t blockCount = (playerCount + s_populationBlockSize - 1) / s_populationBlockSize;
+	std::atomic<int64_t> nextBlock = 0;
+	std::mutex mergeMutex;
+
+	auto runThread = [&]()
+	{
+		TRACE_SCOPE("PopulationThread");
+		PerfCounters::ScopedPhase perfPhase("PopulationSimulation");
+
+		CountHistogram treasureCounts[s_numTreasureTypes];
+		RngState blockRng = SeedRng(seed);
+		int64_t blockRngIndex = 0;
+		int64_t killCount = 0;
+
+		// Blocks are taken in increasing order, so each thread only ever jumps forward.
+		for (int64_t block = nextBlock.fetch_add(1); block < blockCount; block = nextBlock.fetch_add(1))
+		{
+			for (; blockRngIndex < block; ++blockRngIndex)
+			{
+				JumpRng(blockRng);
+			}
+			RngState rng = blockRng;
+
+			int64_t firstPlayer = block * s_populationBlockSize;
+			int64_t lastPlayer = std::min(firstPlayer + s_populationBlockSize, playerCount);
+			for (int64_t player = firstPlayer; player < lastPlayer; ++player)
+			{
+				uint32_t counts[s_numTreasureTypes] = {};
+				TreasureType drops[s_maxDropsPerKill];
+				for (int64_t kill = 0; kill < killsPerPlayer; ++kill)
+				{
+					MonsterType monsterType = type.has_value() ? type.value() : lootModel.RollMonsterType(rng);
+					size_t dropCount = game.RollDrops(monsterType, rng, drops);
+					for (size_t i = 0; i < dropCount; ++i)
+					{
+						size_t treasureIndex = static_cast<size_t>(drops[i]);
+						if (treasureIndex < s_numTreasureTypes)
+						{
+							++counts[treasureIndex];
+						}
+					}
+				}
+
+				for (size_t t = 0; t < s_numTreasureTypes; ++t)
+				{
+					treasureCounts[t].Record(counts[t]);
+				}
+			}
+			killCount += (lastPlayer - firstPlayer) * killsPerPlayer;
+		}
+		perfPhase.SetKillCount(killCount);
+
+		std::lock_guard<std::mutex> lock(mergeMutex);
+		for (size_t t = 0; t < s_numTreasureTypes; ++t)
+		{
+			report.treasureCounts[t].Merge(treasureCounts[t]);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int32_t i = 1; i < threadCount; ++i)
+	{
+		threads.emplace_back(runThread);
+	}
+	runThread();
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+//===============================================================
+
+} // namespace LootSimulator
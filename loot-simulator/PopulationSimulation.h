@@ -0,0 +1,42 @@
+//---------------------------------------------------------------
+//
+// PopulationSimulation.h
+//
+
+#pragma once
+
+#include "CountHistogram.h"
+#include "GameTypes.h"
+#include "LootCounters.h"
+
+#include <cstdint>
+#include <optional>
+
+namespace LootSimulator {
+
+//===============================================================
+
+class Game;
+
+// What every player of a population ended up with.
+struct PopulationReport
+{
+	int64_t playerCount = 0;
+	int64_t killsPerPlayer = 0;
+
+	// How many of each treasure each player has, indexed by treasure type.
+	CountHistogram treasureCounts[s_numTreasureTypes];
+};
+
+// Gives each of playerCount players killsPerPlayer kills and records how many of each
+// treasure every player ended up with, so percentiles are per player rather than over
+// all kills. Players are handed to threadCount threads a block at a time, and block i
+// always draws from substream i of seed, so the thread count doesn't change the result.
+// Only one player's counters exist per thread at once; memory grows with the most any
+// player has, not with the number of players. Nobody is notified.
+void RunPopulationSimulation(const Game& game, std::optional<MonsterType> type, int64_t playerCount,
+	int64_t killsPerPlayer, int32_t threadCount, uint64_t seed, PopulationReport& report);
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,210 @@
+//---------------------------------------------------------------
+//
+// Random.cpp
+//
+
+#include "Random.h"
+
+#include <cmath>
+#include <random>
+
+namespace LootSimulator {
+
+//===============================================================
+
+static uint64_t RotateLeft(uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t SplitMix64(uint64_t& x)
+{
+	uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+// log(k!) minus its Stirling approximation.
+static double StirlingTail(double k)
+{
+	static const double s_tails[] = {
+		0.0810614667953272, 0.0413406959554092, 0.0276779256849983, 0.0207906721037650,
+		0.0166446911898211, 0.0138761288230707, 0.0118967099458917, 0.0104112652619720,
+		0.0092554621827127, 0.0083305634333628 };
+
+	if (k <= 9.0)
+	{
+		return s_tails[static_cast<int>(k)];
+	}
+
+	double next = k + 1.0;
+	double nextSquared = next * next;
+	return (1.0 / 12.0 - (1.0 / 360.0 - 1.0 / 1260.0 / nextSquared) / nextSquared) / next;
+}
+
+// Hormann's BTRS, transformed rejection with squeeze. Needs trials * probability >= 10
+// and probability <= 0.5; takes a little over one pair of draws on average.
+static int64_t NextRandomBinomialRejection(RngState& rng, double trials, double probability)
+{
+	const double stddev = std::sqrt(trials * probability * (1.0 - probability));
+	const double b = 1.15 + 2.53 * stddev;
+	const double a = -0.0873 + 0.0248 * b + 0.01 * probability;
+	const double c = trials * probability + 0.5;
+	const double vr = 0.92 - 4.2 / b;
+	const double r = probability / (1.0 - probability);
+	const double alpha = (2.83 + 5.1 / b) * stddev;
+	const double m = std::floor((trials + 1.0) * probability);
+
+	while (true)
+	{
+		double u = NextRandomDouble(rng) - 0.5;
+		double v = NextRandomDouble(rng);
+		double us = 0.5 - std::abs(u);
+		double k = std::floor((2.0 * a / us + b) * u + c);
+
+		// Inside the box the hat is tight, so there's nothing to check.
+		if (us >= 0.07 && v <= vr)
+		{
+			return static_cast<int64_t>(k);
+		}
+		if (k < 0.0 || k > trials)
+		{
+			continue;
+		}
+
+		v = std::log(v * alpha / (a / (us * us) + b));
+		double bound = (m + 0.5) * std::log((m + 1.0) / (r * (trials - m + 1.0)))
+			+ (trials + 1.0) * std::log((trials - m + 1.0) / (trials - k + 1.0))
+			+ (k + 0.5) * std::log(r * (trials - k + 1.0) / (k + 1.0))
+			+ StirlingTail(m) + StirlingTail(trials - m) - StirlingTail(k) - StirlingTail(trials - k);
+		if (v <= bound)
+		{
+			return static_cast<int64_t>(k);
+		}
+	}
+}
+
+//---------------------------------------------------------------
+
+RngState SeedRng(uint64_t seed)
+{
+	RngState rng;
+	for (uint64_t& word : rng.s)
+	{
+		word = SplitMix64(seed);
+	}
+	return rng;
+}
+
+RngState SeedRngFromDevice()
+{
+	std::random_device rd;
+	uint64_t seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+	return SeedRng(seed);
+}
+
+void JumpRng(RngState& rng)
+{
+	static const uint64_t s_jump[] = {
+		0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c };
+
+	uint64_t s[4] = {};
+	for (uint64_t jump : s_jump)
+	{
+		for (int b = 0; b < 64; ++b)
+		{
+			if (jump & (1ull << b))
+			{
+				for (int i = 0; i < 4; ++i)
+				{
+					s[i] ^= rng.s[i];
+				}
+			}
+			NextRandom(rng);
+		}
+	}
+
+	for (int i = 0; i < 4; ++i)
+	{
+		rng.s[i] = s[i];
+	}
+}
+
+uint64_t NextRandom(RngState& rng)
+{
+	uint64_t* s = rng.s;
+	const uint64_t result = RotateLeft(s[1] * 5, 7) * 9;
+	const uint64_t t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = RotateLeft(s[3], 45);
+
+	return result;
+}
+
+float NextRandomFloat(RngState& rng, float lowerBound, float upperBound)
+{
+	// Top 24 bits fill a float mantissa exactly.
+	float unit = static_cast<float>(NextRandom(rng) >> 40) * (1.0f / 16777216.0f);
+	return lowerBound + unit * (upperBound - lowerBound);
+}
+
+int32_t NextRandomInt(RngState& rng, int32_t lowerBound, int32_t upperBound)
+{
+	uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(upperBound) - lowerBound) + 1;
+	uint64_t scaled = ((NextRandom(rng) >> 32) * range) >> 32;
+	return static_cast<int32_t>(lowerBound + static_cast<int64_t>(scaled));
+}
+
+double NextRandomDouble(RngState& rng)
+{
+	// Top 53 bits fill a double mantissa exactly.
+	return static_cast<double>(NextRandom(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+int64_t NextRandomBinomial(RngState& rng, int64_t trials, double probability)
+{
+	if (trials <= 0 || !(probability > 0.0))
+	{
+		return 0;
+	}
+	if (probability >= 1.0)
+	{
+		return trials;
+	}
+
+	// Both methods want the rarer outcome.
+	if (probability > 0.5)
+	{
+		return trials - NextRandomBinomial(rng, trials, 1.0 - probability);
+	}
+
+	double n = static_cast<double>(trials);
+	if (n * probability >= 10.0)
+	{
+		return NextRandomBinomialRejection(rng, n, probability);
+	}
+
+	// Few successes expected, so walk up the distribution from zero, which takes about
+	// n * probability steps.
+	double ratio = probability / (1.0 - probability);
+	double chance = std::exp(n * std::log1p(-probability));
+	double u = NextRandomDouble(rng);
+	int64_t successes = 0;
+	while (u > chance && successes < trials)
+	{
+		u -= chance;
+		++successes;
+		chance *= ratio * (n + 1.0 - static_cast<double>(successes)) / static_cast<double>(successes);
+	}
+	return successes;
+}
+
+//===============================================================
+
+} // namespace LootSimulator
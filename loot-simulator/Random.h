@@ -0,0 +1,47 @@
+//---------------------------------------------------------------
+//
+// Random.h
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// xoshiro256** state. Small enough to copy around and save, and it can jump ahead by 2^128
+// draws, which gives us non-overlapping substreams for parallel work.
+struct RngState
+{
+	uint64_t s[4] = {};
+};
+
+// Expands a seed into a full state. The same seed always gives the same stream.
+RngState SeedRng(uint64_t seed);
+
+// Seeds from std::random_device for runs that don't need to be repeatable.
+RngState SeedRngFromDevice();
+
+// Advances the stream by 2^128 draws. Jumping a seeded state i times gives substream i.
+void JumpRng(RngState& rng);
+
+uint64_t NextRandom(RngState& rng);
+
+// Uniform in [lowerBound, upperBound).
+float NextRandomFloat(RngState& rng, float lowerBound, float upperBound);
+
+// Uniform in [lowerBound, upperBound].
+int32_t NextRandomInt(RngState& rng, int32_t lowerBound, int32_t upperBound);
+
+// Uniform in [0, 1), with every bit of a double's mantissa.
+double NextRandomDouble(RngState& rng);
+
+// Number of successes in trials independent tries that each succeed with probability.
+// Exact, and takes about the same time however many trials there are.
+int64_t NextRandomBinomial(RngState& rng, int64_t trials, double probability);
+
+//===============================================================
+
+} // namespace LootSimulator
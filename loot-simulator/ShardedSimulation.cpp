@@ -0,0 +1,161 @@
+//---------------------------------------------------------------
+//
+// ShardedSimulation.cpp
+//
+
+#include "ShardedSimulation.h"
+
+#include "Game.h"
+#include "LiveStats.h"
+#include "Log.h"
+#include "LootCounters.h"
+#include "Trace.h"
+
+#include <new>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Give every worker its own cache lines so they never write to the same one.
+static const size_t s_shardSlotAlignment = 64;
+static const size_t s_shardSlotSize = (sizeof(LootCounters) + s_shardSlotAlignment - 1)
+	/ s_shardSlotAlignment * s_shardSlotAlignment;
+
+static int64_t GetShardKillCount(int64_t count, int32_t shardCount, int32_t shardIndex)
+{
+	int64_t remainder = count % shardCount;
+	return count / shardCount + (shardIndex < remainder ? 1 : 0);
+}
+
+static RngState GetShardRng(uint64_t seed, int32_t shardIndex)
+{
+	RngState rng = SeedRng(seed);
+	for (int32_t i = 0; i < shardIndex; ++i)
+	{
+		JumpRng(rng);
+	}
+	return rng;
+}
+
+//---------------------------------------------------------------
+
+void SimulateShard(Game& game, int64_t count, std::optional<MonsterType> type, uint64_t seed,
+	int32_t shardCount, int32_t shardIndex, LootCounters& counters)
+{
+	RngState rng = GetShardRng(seed, shardIndex);
+	game.SimulateBatch(GetShardKillCount(count, shardCount, shardIndex), type, rng, counters);
+}
+
+#ifdef _WIN32
+
+bool SimulateSharded(Game& game, int64_t count, std::optional<MonsterType> type, uint64_t seed,
+	int32_t shardCount, LootSession& lootSession)
+{
+	TRACE_SCOPE("SimulateShards");
+	LootCounters merged;
+	for (int32_t i = 0; i < shardCount; ++i)
+	{
+		LootCounters counters;
+		SimulateShard(game, count, type, seed, shardCount, i, counters);
+		MergeLootCounters(merged, counters);
+	}
+
+	AppendToLootSession(merged, lootSession);
+	return true;
+}
+
+#else
+
+bool SimulateSharded(Game& game, int64_t count, std::optional<MonsterType> type, uint64_t seed,
+	int32_t shardCount, LootSession& lootSession)
+{
+	TRACE_SCOPE("SimulateShards");
+
+	size_t segmentSize = s_shardSlotSize * shardCount;
+	void* segment = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (segment == MAP_FAILED)
+	{
+		LOG_ERROR("Could not map shard counters. size={}", segmentSize);
+		return false;
+	}
+
+	auto getSlot = [segment](int32_t shardIndex)
+	{
+		return reinterpret_cast<LootCounters*>(static_cast<char*>(segment) + s_shardSlotSize * shardIndex);
+	};
+
+	std::vector<pid_t> workers;
+	workers.reserve(shardCount);
+
+	// Only the forking thread carries over into a child, and any lock another thread held
+	// at the time stays held there for good. Our background threads are stopped until
+	// every worker has started.
+	Logger::PauseForFork();
+	LiveStats::PauseForFork();
+
+	bool succeeded = true;
+	for (int32_t i = 0; i < shardCount; ++i)
+	{
+		LootCounters* slot = new (getSlot(i)) LootCounters();
+
+		pid_t pid = fork();
+		if (pid == 0)
+		{
+			SimulateShard(game, count, type, seed, shardCount, i, *slot);
+			Logger::Flush();
+			_exit(0);
+		}
+
+		if (pid < 0)
+		{
+			LOG_ERROR("Could not fork shard worker. shard={}", i);
+			succeeded = false;
+			break;
+		}
+
+		workers.push_back(pid);
+	}
+
+	LiveStats::ResumeAfterFork();
+	Logger::ResumeAfterFork();
+
+	// Always reap whatever we started, even if a later fork failed.
+	for (pid_t pid : workers)
+	{
+		int status = 0;
+		if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		{
+			LOG_ERROR("Shard worker did not finish. pid={}", pid);
+			succeeded = false;
+		}
+	}
+
+	if (succeeded)
+	{
+		TRACE_SCOPE("MergeShards");
+		LootCounters merged;
+		for (int32_t i = 0; i < shardCount; ++i)
+		{
+			MergeLootCounters(merged, *getSlot(i));
+		}
+		AppendToLootSession(merged, lootSession);
+	}
+
+	munmap(segment, segmentSize);
+	return succeeded;
+}
+
+#endif
+
+//===============================================================
+
+} // namespace LootSimulator
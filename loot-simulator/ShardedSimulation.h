@@ -0,0 +1,33 @@
+//---------------------------------------------------------------
+//
+// ShardedSimulation.h
+//
+
+#pragma once
+
+#include "GameTypes.h"
+
+#include <optional>
+
+namespace LootSimulator {
+
+//===============================================================
+
+class Game;
+struct LootCounters;
+
+// Splits count kills across shardCount worker processes. Worker i draws from substream i of
+// seed and writes dense counters into its own slot of a shared memory segment, which are
+// merged in shard order once every worker has exited. The result only depends on the seed
+// and shard count. Where processes can't be forked the shards run one after another here.
+bool SimulateSharded(Game& game, int64_t count, std::optional<MonsterType> type, uint64_t seed,
+	int32_t shardCount, LootSession& lootSession);
+
+// Runs shard shardIndex of a count kill job into counters. Wherever it runs, a shard gives the
+// same counters for the same arguments.
+void SimulateShard(Game& game, int64_t count, std::optional<MonsterType> type, uint64_t seed,
+	int32_t shardCount, int32_t shardIndex, LootCounters& counters);
+
+//===============================================================
+
+} // namespace LootSimulator
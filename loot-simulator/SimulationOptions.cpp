@@ -0,0 +1,197 @@
+//---------------------------------------------------------------
+//
+// SimulationOptions.cpp
+//
+
+#include "SimulationOptions.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace LootSimulator {
+
+//===============================================================
+
+static void PrintUsage()
+{
+	std::cout << "Usage: loot-simulator [options]\n"
+		"\t--seed <n>\tSeed every roll so runs can be repeated.\n"
+		"\t--shards <n>\tSplit batches across n worker processes.\n"
+		"\t--worker <port>\tServe shards to coordinators instead of playing.\n"
+		"\t--workers <host:port,...>\tSend batches to these workers.\n"
+		"\t--local-workers <n>\tStart n localhost workers and send batches to them.\n"
+		"\t--batch <n>\tSlay n monsters without the menu, report and quit.\n"
+		"\t--monster <type>\tMonster type for --batch, e.g. dragon. Random by default.\n"
+		"\t--zone <name>\tZone random monsters spawn from, e.g. crypt. The first by default.\n"
+		"\t--magic-find <percent>\tRoll every kill with this much magic find, e.g. 150.\n"
+		"\t--checkpoint <file>\tSave batch progress to file.\n"
+		"\t--checkpoint-interval <n>\tKills between checkpoints.\n"
+		"\t--resume <file>\tContinue the batch saved in file, report and quit.\n"
+		"\t--log <file>\tWrite log messages to file instead of stderr.\n"
+		"\t--trace <file>\tWrite a Chrome trace of the run to file on exit.\n"
+		"\t--stats <file>\tPublish live progress to file for lootsim-top.\n"
+		"\t--perf\t\tPrint hardware counters per phase on exit (Linux only).\n"
+		"\t--latency-bench <n>\tTime single kills on n threads, --batch kills each, and quit.\n"
+		"\t--latency-slo <ns>\tFail the latency benchmark if p99 is above ns.\n"
+		"\t--pity-players <n>\tGive n players --batch kills each under the pity rules, report and quit.\n"
+		"\t--population <n>\tGive n players --batch kills each, report per player percentiles and quit.\n"
+		"\t--distribution <treasure>\tWork out how many of treasure --batch kills drop, report and quit.\n"
+		"\t--collect <treasure,...>\tWork out how many --monster kills collecting every treasure takes and quit.\n"
+		"\t--combinations\tCount which treasures --batch kills drop together, report and quit.\n"
+		"\t--value <n>\tReport what --batch kills, and sessions of n kills, are worth and quit.\n"
+		"\t--clients <n>\tSplit --batch between n clients of the simulation service, report and quit.\n";
+}
+
+// Parses a whole, non-negative number. Anything else fails.
+static bool ParseNumber(const char* str, uint64_t& value)
+{
+	std::string input(str);
+	if (input.empty() || input.find_first_not_of("0123456789") != std::string::npos)
+	{
+		return false;
+	}
+
+	try
+	{
+		value = std::stoull(input);
+	}
+	catch (const std::out_of_range&)
+	{
+		return false;
+	}
+	return true;
+}
+
+bool ParseSimulationOptions(int argc, char* argv[], SimulationOptions& options)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		uint64_t value = 0;
+
+		if (arg == "--seed" && hasValue && ParseNumber(argv[++i], value))
+		{
+			options.seed = value;
+		}
+		else if (arg == "--shards" && hasValue && ParseNumber(argv[++i], value)
+			&& value >= 1 && value <= 1024)
+		{
+			options.shardCount = static_cast<int32_t>(value);
+		}
+		else if (arg == "--worker" && hasValue && ParseNumber(argv[++i], value)
+			&& value >= 1 && value <= 65535)
+		{
+			options.workerPort = static_cast<uint16_t>(value);
+		}
+		else if (arg == "--workers" && hasValue)
+		{
+			options.workerAddresses = argv[++i];
+		}
+		else if (arg == "--local-workers" && hasValue && ParseNumber(argv[++i], value)
+			&& value >= 1 && value <= 256)
+		{
+			options.localWorkerCount = static_cast<int32_t>(value);
+		}
+		else if (arg == "--batch" && hasValue && ParseNumber(argv[++i], value)
+			&& value >= 1 && value <= static_cast<uint64_t>(INT64_MAX))
+		{
+			options.batchCount = static_cast<int64_t>(value);
+		}
+		else if (arg == "--monster" && hasValue)
+		{
+			options.batchMonster = argv[++i];
+		}
+		else if (arg == "--zone" && hasValue)
+		{
+			options.zone = argv[++i];
+		}
+		else if (arg == "--magic-find" && hasValue && ParseNumber(argv[++i], value)
+			&& value <= 100000)
+		{
+			options.magicFindPercent = static_cast<uint32_t>(value);
+		}
+		else if (arg == "--checkpoint" && hasValue)
+		{
+			options.checkpointPath = argv[++i];
+		}
+		else if (arg == "--checkpoint-interval" && hasValue && ParseNumber(argv[++i], value)
+			&& value >= 1 && value <= static_cast<uint64_t>(INT64_MAX))
+		{
+			options.checkpointInterval = static_cast<int64_t>(value);
+		}
+		else if (arg == "--resume" && hasValue)
+		{
+			options.resumePath = argv[++i];
+		}
+		else if (arg == "--log" && hasValue)
+		{
+			options.logPath = argv[++i];
+		}
+		else if (arg == "--trace" && hasValue)
+		{
+			options.tracePath = argv[++i];
+		}
+		else if (arg == "--stats" && hasValue)
+		{
+			options.statsPath = argv[++i];
+		}
+		else if (arg == "--perf")
+		{
+			options.isCountingPerf = true;
+		}
+		else if (arg == "--latency-bench" && hasValue && ParseNumber(argv[++i], value)
+			&& value >= 1 && value <= 1024)
+		{
+			options.latencyThreadCount = static_cast<int32_t>(value);
+		}
+		else if (arg == "--latency-slo" && hasValue && ParseNumber(argv[++i], value))
+		{
+			options.latencySloNanoseconds = value;
+		}
+		else if (arg == "--pity-players" && hasValue && ParseNumber(argv[++i], value)
+			&& value >= 1 && value <= 1000000000)
+		{
+			options.pityPlayerCount = static_cast<int64_t>(value);
+		}
+		else if (arg == "--population" && hasValue && ParseNumber(argv[++i], value)
+			&& value >= 1 && value <= 1000000000)
+		{
+			options.populationPlayerCount = static_cast<int64_t>(value);
+		}
+		else if (arg == "--distribution" && hasValue)
+		{
+			options.distributionTreasure = argv[++i];
+		}
+		else if (arg == "--collect" && hasValue)
+		{
+			options.collectTreasures = argv[++i];
+		}
+		else if (arg == "--combinations")
+		{
+			options.isCountingCombinations = true;
+		}
+		else if (arg == "--value" && hasValue && ParseNumber(argv[++i], value)
+			&& value >= 1 && value <= 1000000000)
+		{
+			options.valueSessionKills = static_cast<int64_t>(value);
+		}
+		else if (arg == "--clients" && hasValue && ParseNumber(argv[++i], value)
+			&& value >= 1 && value <= 256)
+		{
+			options.clientCount = static_cast<int32_t>(value);
+		}
+		else
+		{
+			PrintUsage();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,107 @@
+//---------------------------------------------------------------
+//
+// SimulationOptions.h
+//
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Everything that can be set from the command line.
+struct SimulationOptions
+{
+	// Seeds every roll. If not set, each run is different.
+	std::optional<uint64_t> seed;
+
+	// Number of worker processes batches are split across.
+	int32_t shardCount = 1;
+
+	// If set, we serve shards to coordinators on this port instead of running the game.
+	std::optional<uint16_t> workerPort;
+
+	// Remote workers batches are sent to, as "host:port,host:port".
+	std::string workerAddresses;
+
+	// Number of localhost workers to start in process and send batches to.
+	int32_t localWorkerCount = 0;
+
+	// Slay this many monsters without the menu, report and quit.
+	int64_t batchCount = 0;
+
+	// Monster type id for batchCount, e.g. "dragon". Empty or "random" for random types.
+	std::string batchMonster;
+
+	// Zone whose encounter table random kills spawn from. Empty for the content's first.
+	std::string zone;
+
+	// Every kill rolls with this much magic find, in percent.
+	uint32_t magicFindPercent = 0;
+
+	// Batches save their progress here so they can be resumed.
+	std::string checkpointPath;
+
+	// Kills between checkpoints.
+	int64_t checkpointInterval = 100000000;
+
+	// Continue the batch saved in this checkpoint, report and quit.
+	std::string resumePath;
+
+	// Log messages go here. Empty for stderr.
+	std::string logPath;
+
+	// If set, a Chrome trace of the whole run is written here on exit.
+	std::string tracePath;
+
+	// If set, live progress is published to a stats segment at this path for lootsim-top.
+	std::string statsPath;
+
+	// Count cycles, instructions, cache and branch misses per phase and print them on exit.
+	bool isCountingPerf = false;
+
+	// If set, time batchCount single kills on each of this many threads, report the
+	// latency percentiles and quit.
+	int32_t latencyThreadCount = 0;
+
+	// The benchmark fails if its p99 latency is above this.
+	std::optional<uint64_t> latencySloNanoseconds;
+
+	// If set, give this many players batchCount kills each under the content's pity rules,
+	// report how pity changed drop rates and quit.
+	int64_t pityPlayerCount = 0;
+
+	// If set, give this many players batchCount kills each, report the percentiles of
+	// what each player ended up with and quit.
+	int64_t populationPlayerCount = 0;
+
+	// If set, work out the exact distribution of how many of this treasure batchCount
+	// kills drop, report it and quit.
+	std::string distributionTreasure;
+
+	// If set, a comma separated set of treasures: work out how many kills it takes to own
+	// all of them, report it and quit.
+	std::string collectTreasures;
+
+	// Count which treasures batchCount kills drop together, report it and quit.
+	bool isCountingCombinations = false;
+
+	// If set, report what batchCount kills, and sessions of this many kills in a row, are
+	// worth by the content's treasure values and quit.
+	int64_t valueSessionKills = 0;
+
+	// If set, split batchCount between this many clients that ask the simulation service
+	// for their share at once, report what each got back and quit.
+	int32_t clientCount = 0;
+};
+
+// Parses the command line into options. Returns false on anything it doesn't recognize.
+bool ParseSimulationOptions(int argc, char* argv[], SimulationOptions& options);
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,168 @@
+//---------------------------------------------------------------
+//
+// SimulationService.cpp
+//
+
+#include "SimulationService.h"
+
+#include "Game.h"
+#include "Log.h"
+#include "Trace.h"
+
+#include <map>
+#include <utility>
+
+namespace LootSimulator {
+
+//===============================================================
+
+SimulationService::SimulationService(Game& game, std::chrono::microseconds coalesceWindow)
+	: m_game(game)
+	, m_coalesceWindow(coalesceWindow)
+{
+}
+
+SimulationService::~SimulationService()
+{
+	Stop();
+}
+
+void SimulationService::Start()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_isRunning)
+	{
+		return;
+	}
+
+	m_isRunning = true;
+	m_worker = std::thread(&SimulationService::ProcessRequests, this);
+}
+
+void SimulationService::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isRunning = false;
+	}
+
+	m_requestAvailable.notify_all();
+	if (m_worker.joinable())
+	{
+		m_worker.join();
+	}
+}
+
+std::future<SimulationResult> SimulationService::Submit(const SimulationRequest& request)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (!m_isRunning || request.count < 0)
+	{
+		LOG_WARNING("Rejecting simulation request. isRunning={} count={}", m_isRunning, request.count);
+		std::promise<SimulationResult> rejected;
+		rejected.set_value({});
+		return rejected.get_future();
+	}
+
+	m_pendingRequests.push_back({ request, {} });
+	std::future<SimulationResult> result = m_pendingRequests.back().promise.get_future();
+
+	m_requestAvailable.notify_one();
+	return result;
+}
+
+void SimulationService::ProcessRequests()
+{
+	while (true)
+	{
+		std::vector<PendingRequest> requests;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_requestAvailable.wait(lock, [this]()
+			{
+				return !m_isRunning || !m_pendingRequests.empty();
+			});
+
+			// Give the rest of the burst a chance to show up so it can share the run.
+			if (m_isRunning && m_coalesceWindow.count() > 0)
+			{
+				m_requestAvailable.wait_for(lock, m_coalesceWindow, [this]()
+				{
+					return !m_isRunning;
+				});
+			}
+
+			// Drain whatever is left even when stopping so no future is left hanging.
+			requests.swap(m_pendingRequests);
+			if (requests.empty() && !m_isRunning)
+			{
+				return;
+			}
+		}
+
+		// Group by monster and content version. NONE stands in for random mode.
+		std::map<std::pair<MonsterType, uint64_t>, std::vector<PendingRequest*>> batches;
+		for (PendingRequest& pending : requests)
+		{
+			const SimulationRequest& request = pending.request;
+			MonsterType type = request.type.value_or(MonsterType::NONE);
+			batches[{ type, request.contentVersion }].push_back(&pending);
+		}
+
+		for (auto& batch : batches)
+		{
+			RunCoalescedBatch(batch.second);
+		}
+	}
+}
+
+void SimulationService::RunCoalescedBatch(std::vector<PendingRequest*>& batch)
+{
+	const SimulationRequest& first = batch.front()->request;
+	if (!m_game.IsDataLoaded())
+	{
+		LOG_WARNING("Rejecting simulation requests, no content is loaded.");
+		for (PendingRequest* pending : batch)
+		{
+			pending->promise.set_value({});
+		}
+		return;
+	}
+
+	if (first.contentVersion != m_game.GetContentHash())
+	{
+		LOG_WARNING("Rejecting simulation requests for stale content. contentVersion={}",
+			first.contentVersion);
+		for (PendingRequest* pending : batch)
+		{
+			pending->promise.set_value({});
+		}
+		return;
+	}
+
+	std::vector<int32_t> counts;
+	counts.reserve(batch.size());
+	for (const PendingRequest* pending : batch)
+	{
+		counts.push_back(pending->request.count);
+	}
+
+	TRACE_SCOPE("RunCoalescedBatch");
+	TRACE_COUNTER("CoalescedRequests", batch.size());
+
+	std::vector<LootSession> sessions;
+	m_game.SimulatePartitionedBatch(first.type, counts, sessions);
+	++m_runCount;
+
+	for (size_t i = 0; i < batch.size(); ++i)
+	{
+		SimulationResult result;
+		result.success = true;
+		result.lootSession = std::move(sessions[i]);
+		batch[i]->promise.set_value(std::move(result));
+	}
+}
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,93 @@
+//---------------------------------------------------------------
+//
+// SimulationService.h
+//
+
+#pragma once
+
+#include "GameTypes.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+struct SimulationRequest
+{
+	// Monster to slay. If not set, every kill picks a random type.
+	std::optional<MonsterType> type;
+
+	// Number of monsters to slay.
+	int32_t count = 0;
+
+	// Content hash the client expects the results to come from. See Game::GetContentHash.
+	uint64_t contentVersion = 0;
+};
+
+struct SimulationResult
+{
+	// False if the request could not be served, e.g. it asked for stale content.
+	bool success = false;
+
+	LootSession lootSession;
+};
+
+class Game;
+
+// Serves simulation requests from many clients on one worker thread. Requests for the same
+// monster and content version that arrive together are coalesced into one bulk run whose
+// kills are then split back between the requesters.
+class SimulationService
+{
+public:
+	// The game must stay loaded and must not be used by anyone else while the service runs.
+	explicit SimulationService(Game& game,
+		std::chrono::microseconds coalesceWindow = std::chrono::microseconds(2000));
+	~SimulationService();
+
+	void Start();
+	void Stop();
+
+	// Queues a request. The future is fulfilled once its batch has been simulated. Requests
+	// for a negative count, or made while the service isn't running, fail straight away.
+	std::future<SimulationResult> Submit(const SimulationRequest& request);
+
+	// Number of runs the service has made. Requests that were coalesced share one.
+	int64_t GetRunCount() const { return m_runCount; }
+
+private:
+	struct PendingRequest
+	{
+		SimulationRequest request;
+		std::promise<SimulationResult> promise;
+	};
+
+	void ProcessRequests();
+	void RunCoalescedBatch(std::vector<PendingRequest*>& batch);
+
+private:
+	Game& m_game;
+
+	// How long to keep collecting requests after the first one of a burst arrives.
+	std::chrono::microseconds m_coalesceWindow;
+
+	std::mutex m_mutex;
+	std::condition_variable m_requestAvailable;
+	std::vector<PendingRequest> m_pendingRequests;
+	std::thread m_worker;
+	bool m_isRunning = false;
+
+	std::atomic<int64_t> m_runCount = 0;
+};
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,292 @@
+//---------------------------------------------------------------
+//
+// Socket.cpp
+//
+
+#include "Socket.h"
+
+#include "Log.h"
+
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace LootSimulator {
+
+//===============================================================
+
+#ifdef _WIN32
+const SocketHandle Socket::s_invalidHandle = INVALID_SOCKET;
+
+static bool InitializeSockets()
+{
+	static const bool s_isInitialized = []()
+	{
+		WSADATA data;
+		return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+	}();
+	return s_isInitialized;
+}
+
+static void CloseSocketHandle(SocketHandle handle)
+{
+	closesocket(handle);
+}
+#else
+const SocketHandle Socket::s_invalidHandle = -1;
+
+static bool InitializeSockets()
+{
+	return true;
+}
+
+static void CloseSocketHandle(SocketHandle handle)
+{
+	close(handle);
+}
+#endif
+
+// Resolves host:port and hands each candidate address to tryAddress until one works.
+template <typename Function>
+static bool ForEachAddress(const std::string& host, uint16_t port, bool isPassive, Function tryAddress)
+{
+	addrinfo hints = {};
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = isPassive ? AI_PASSIVE : 0;
+
+	addrinfo* addresses = nullptr;
+	std::string service = std::to_string(port);
+	if (getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &addresses) != 0)
+	{
+		LOG_ERROR("Could not resolve address. host={}", host);
+		return false;
+	}
+
+	bool succeeded = false;
+	for (addrinfo* address = addresses; address && !succeeded; address = address->ai_next)
+	{
+		succeeded = tryAddress(*address);
+	}
+
+	freeaddrinfo(addresses);
+	return succeeded;
+}
+
+//---------------------------------------------------------------
+
+Socket::Socket(SocketHandle handle)
+	: m_handle(handle)
+{
+}
+
+Socket::~Socket()
+{
+	Close();
+}
+
+Socket::Socket(Socket&& other)
+	: m_handle(std::exchange(other.m_handle, s_invalidHandle))
+	, m_timeout(other.m_timeout)
+{
+}
+
+Socket& Socket::operator=(Socket&& other)
+{
+	if (this != &other)
+	{
+		Close();
+		m_handle = std::exchange(other.m_handle, s_invalidHandle);
+		m_timeout = other.m_timeout;
+	}
+	return *this;
+}
+
+bool Socket::Connect(const std::string& host, uint16_t port)
+{
+	Close();
+	if (!InitializeSockets())
+	{
+		return false;
+	}
+
+	return ForEachAddress(host, port, false, [this](const addrinfo& address)
+	{
+		SocketHandle handle = socket(address.ai_family, address.ai_socktype, address.ai_protocol);
+		if (handle == s_invalidHandle)
+		{
+			return false;
+		}
+
+		ApplyTimeout(handle);
+		if (connect(handle, address.ai_addr, static_cast<int>(address.ai_addrlen)) != 0)
+		{
+			CloseSocketHandle(handle);
+			return false;
+		}
+
+		// Messages are written whole, there's nothing to gain from batching them up.
+		int noDelay = 1;
+		setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay),
+			sizeof(noDelay));
+
+		m_handle = handle;
+		return true;
+	});
+}
+
+void Socket::SetTimeout(std::chrono::milliseconds timeout)
+{
+	m_timeout = timeout;
+	if (IsValid())
+	{
+		ApplyTimeout(m_handle);
+	}
+}
+
+void Socket::ApplyTimeout(SocketHandle handle) const
+{
+#ifdef _WIN32
+	DWORD timeout = static_cast<DWORD>(m_timeout.count());
+#else
+	timeval timeout = {};
+	timeout.tv_sec = static_cast<time_t>(m_timeout.count() / 1000);
+	timeout.tv_usec = static_cast<suseconds_t>(m_timeout.count() % 1000 * 1000);
+#endif
+	setsockopt(handle, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+	setsockopt(handle, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+}
+
+bool Socket::Listen(const std::string& host, uint16_t port)
+{
+	Close();
+	if (!InitializeSockets())
+	{
+		return false;
+	}
+
+	return ForEachAddress(host, port, true, [this](const addrinfo& address)
+	{
+		SocketHandle handle = socket(address.ai_family, address.ai_socktype, address.ai_protocol);
+		if (handle == s_invalidHandle)
+		{
+			return false;
+		}
+
+		int reuse = 1;
+		setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse),
+			sizeof(reuse));
+
+		if (bind(handle, address.ai_addr, static_cast<int>(address.ai_addrlen)) != 0
+			|| listen(handle, SOMAXCONN) != 0)
+		{
+			CloseSocketHandle(handle);
+			return false;
+		}
+
+		m_handle = handle;
+		return true;
+	});
+}
+
+Socket Socket::Accept()
+{
+	SocketHandle handle = accept(m_handle, nullptr, nullptr);
+	return Socket(handle);
+}
+
+bool Socket::SendAll(const void* data, size_t size)
+{
+	const char* bytes = static_cast<const char*>(data);
+	while (size > 0)
+	{
+#ifdef _WIN32
+		int sent = send(m_handle, bytes, static_cast<int>(size), 0);
+#else
+		ssize_t sent = send(m_handle, bytes, size, MSG_NOSIGNAL);
+#endif
+		if (sent <= 0)
+		{
+			return false;
+		}
+
+		bytes += sent;
+		size -= static_cast<size_t>(sent);
+	}
+	return true;
+}
+
+bool Socket::ReceiveAll(void* data, size_t size)
+{
+	char* bytes = static_cast<char*>(data);
+	while (size > 0)
+	{
+#ifdef _WIN32
+		int received = recv(m_handle, bytes, static_cast<int>(size), 0);
+#else
+		ssize_t received = recv(m_handle, bytes, size, 0);
+#endif
+		if (received <= 0)
+		{
+			return false;
+		}
+
+		bytes += received;
+		size -= static_cast<size_t>(received);
+	}
+	return true;
+}
+
+void Socket::Shutdown()
+{
+	if (IsValid())
+	{
+#ifdef _WIN32
+		shutdown(m_handle, SD_BOTH);
+#else
+		shutdown(m_handle, SHUT_RDWR);
+#endif
+	}
+}
+
+void Socket::Close()
+{
+	if (IsValid())
+	{
+		CloseSocketHandle(m_handle);
+		m_handle = s_invalidHandle;
+	}
+}
+
+bool Socket::IsValid() const
+{
+	return m_handle != s_invalidHandle;
+}
+
+uint16_t Socket::GetLocalPort() const
+{
+	sockaddr_in address = {};
+	socklen_t length = sizeof(address);
+	if (getsockname(m_handle, reinterpret_cast<sockaddr*>(&address), &length) != 0)
+	{
+		return 0;
+	}
+	return ntohs(address.sin_port);
+}
+
+//===============================================================
+
+} // namespace LootSimulator
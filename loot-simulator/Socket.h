@@ -0,0 +1,68 @@
+//---------------------------------------------------------------
+//
+// Socket.h
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace LootSimulator {
+
+//===============================================================
+
+#ifdef _WIN32
+using SocketHandle = uintptr_t;
+#else
+using SocketHandle = int;
+#endif
+
+// Minimal blocking TCP socket. Owns its handle and closes it on destruction.
+class Socket
+{
+public:
+	Socket() = default;
+	~Socket();
+
+	Socket(Socket&& other);
+	Socket& operator=(Socket&& other);
+	Socket(const Socket&) = delete;
+	Socket& operator=(const Socket&) = delete;
+
+	bool Connect(const std::string& host, uint16_t port);
+
+	// Connecting, sending and receiving give up after this long, so a peer that hangs
+	// fails like one that went away. Zero waits forever, the default.
+	void SetTimeout(std::chrono::milliseconds timeout);
+
+	// Port 0 picks any free port. See GetLocalPort.
+	bool Listen(const std::string& host, uint16_t port);
+	Socket Accept();
+
+	// Sends or receives exactly size bytes. False if the peer went away first.
+	bool SendAll(const void* data, size_t size);
+	bool ReceiveAll(void* data, size_t size);
+
+	// Unblocks anyone waiting on this socket.
+	void Shutdown();
+	void Close();
+
+	bool IsValid() const;
+	uint16_t GetLocalPort() const;
+
+private:
+	explicit Socket(SocketHandle handle);
+	void ApplyTimeout(SocketHandle handle) const;
+
+private:
+	SocketHandle m_handle = s_invalidHandle;
+	std::chrono::milliseconds m_timeout = std::chrono::milliseconds(0);
+
+	static const SocketHandle s_invalidHandle;
+};
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,164 @@
+//---------------------------------------------------------------
+//
+// StatsSegment.cpp
+//
+
+#include "StatsSegment.h"
+
+#include <new>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace LootSimulator {
+
+//===============================================================
+
+static uint32_t GetCurrentProcessIdentifier()
+{
+#ifdef _WIN32
+	return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+	return static_cast<uint32_t>(getpid());
+#endif
+}
+
+//---------------------------------------------------------------
+
+StatsSegment::~StatsSegment()
+{
+	Close();
+}
+
+bool StatsSegment::Create(const std::string& path)
+{
+	if (!Map(path, true))
+	{
+		return false;
+	}
+
+	StatsSegmentLayout* layout = new (m_layout) StatsSegmentLayout();
+	layout->version = s_statsSegmentVersion;
+	layout->ownerProcessId = GetCurrentProcessIdentifier();
+	layout->etaSeconds.store(UINT64_MAX, std::memory_order_relaxed);
+
+	// Written last so readers never see a half built segment as valid.
+	std::atomic_thread_fence(std::memory_order_release);
+	layout->magic = s_statsSegmentMagic;
+	return true;
+}
+
+bool StatsSegment::Open(const std::string& path)
+{
+	if (!Map(path, false))
+	{
+		return false;
+	}
+
+	if (m_layout->magic != s_statsSegmentMagic || m_layout->version != s_statsSegmentVersion)
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+#ifdef _WIN32
+
+bool StatsSegment::Map(const std::string& path, bool isCreating)
+{
+	Close();
+
+	DWORD access = GENERIC_READ | GENERIC_WRITE;
+	DWORD share = FILE_SHARE_READ | FILE_SHARE_WRITE;
+	HANDLE file = CreateFileA(path.c_str(), access, share, nullptr,
+		isCreating ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0,
+		static_cast<DWORD>(sizeof(StatsSegmentLayout)), nullptr);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(StatsSegmentLayout));
+	if (!view)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	m_file = file;
+	m_mapping = mapping;
+	m_layout = static_cast<StatsSegmentLayout*>(view);
+	return true;
+}
+
+void StatsSegment::Close()
+{
+	if (m_layout)
+	{
+		UnmapViewOfFile(m_layout);
+		CloseHandle(m_mapping);
+		CloseHandle(m_file);
+		m_layout = nullptr;
+	}
+}
+
+#else
+
+bool StatsSegment::Map(const std::string& path, bool isCreating)
+{
+	Close();
+
+	int fileDescriptor = open(path.c_str(), isCreating ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR, 0644);
+	if (fileDescriptor < 0)
+	{
+		return false;
+	}
+
+	bool hasSize = isCreating
+		? ftruncate(fileDescriptor, sizeof(StatsSegmentLayout)) == 0
+		: lseek(fileDescriptor, 0, SEEK_END) >= static_cast<off_t>(sizeof(StatsSegmentLayout));
+
+	void* view = hasSize
+		? mmap(nullptr, sizeof(StatsSegmentLayout), PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0)
+		: MAP_FAILED;
+
+	// The mapping keeps the file alive on its own.
+	close(fileDescriptor);
+	if (view == MAP_FAILED)
+	{
+		return false;
+	}
+
+	m_layout = static_cast<StatsSegmentLayout*>(view);
+	return true;
+}
+
+void StatsSegment::Close()
+{
+	if (m_layout)
+	{
+		munmap(m_layout, sizeof(StatsSegmentLayout));
+		m_layout = nullptr;
+	}
+}
+
+#endif
+
+//===============================================================
+
+} // namespace LootSimulator
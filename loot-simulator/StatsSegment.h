@@ -0,0 +1,100 @@
+//---------------------------------------------------------------
+//
+// StatsSegment.h
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Shared with lootsim-top, so nothing in here may depend on the rest of the simulator.
+
+static const uint32_t s_statsSegmentMagic = 0x4c535354; // "LSST"
+static const uint32_t s_statsSegmentVersion = 1;
+static const uint32_t s_maxStatsSlots = 64;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+	"Stats are shared between processes and need address free atomics.");
+
+// Progress of one simulating thread or shard process. Each gets its own cache line so
+// publishing never contends with anyone.
+struct alignas(64) StatsSlot
+{
+	std::atomic<uint32_t> isActive;
+	std::atomic<uint32_t> processId;
+	std::atomic<uint64_t> kills;
+	std::atomic<uint64_t> rolls;
+	std::atomic<uint64_t> targetKills;
+};
+
+// Everything is written with relaxed stores; readers only need a recent value of each field.
+struct StatsSegmentLayout
+{
+	uint32_t magic;
+	uint32_t version;
+
+	// Process that owns the segment and publishes the summary below.
+	uint32_t ownerProcessId;
+
+	// Summary, refreshed by the owner a few times a second.
+	std::atomic<uint64_t> publishCount;
+	std::atomic<uint64_t> uptimeMilliseconds;
+	std::atomic<uint64_t> totalKills;
+	std::atomic<uint64_t> totalRolls;
+	std::atomic<uint64_t> targetKills;
+	std::atomic<uint64_t> killsPerSecond;
+	std::atomic<uint64_t> rollsPerSecond;
+	std::atomic<uint64_t> residentBytes;
+
+	// UINT64_MAX while there's nothing to estimate.
+	std::atomic<uint64_t> etaSeconds;
+
+	// Totals of slots that have been released, so reusing a slot doesn't lose its work.
+	std::atomic<uint64_t> releasedKills;
+	std::atomic<uint64_t> releasedRolls;
+	std::atomic<uint64_t> releasedTargetKills;
+
+	StatsSlot slots[s_maxStatsSlots];
+};
+
+// A memory mapped file holding a StatsSegmentLayout.
+class StatsSegment
+{
+public:
+	StatsSegment() = default;
+	~StatsSegment();
+
+	StatsSegment(const StatsSegment&) = delete;
+	StatsSegment& operator=(const StatsSegment&) = delete;
+
+	// Creates or truncates the file and lays out an empty segment owned by us.
+	bool Create(const std::string& path);
+
+	// Maps an existing segment, e.g. from lootsim-top. Fails if it isn't one.
+	bool Open(const std::string& path);
+
+	void Close();
+
+	StatsSegmentLayout* GetLayout() const { return m_layout; }
+
+private:
+	bool Map(const std::string& path, bool isCreating);
+
+private:
+	StatsSegmentLayout* m_layout = nullptr;
+
+#ifdef _WIN32
+	void* m_file = nullptr;
+	void* m_mapping = nullptr;
+#endif
+};
+
+//===============================================================
+
+} // namespace LootSimulator
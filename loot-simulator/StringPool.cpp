@@ -0,0 +1,24 @@
+//---------------------------------------------------------------
+//
+// StringPool.cpp
+//
+
+#include "StringPool.h"
+
+namespace LootSimulator {
+
+//===============================================================
+
+StringId StringPool::Intern(std::string_view str)
+{
+	auto [it, isNew] = m_ids.try_emplace(std::string(str), static_cast<StringId>(m_strings.size()));
+	if (isNew)
+	{
+		m_strings.push_back(it->first);
+	}
+	return it->second;
+}
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,55 @@
+//---------------------------------------------------------------
+//
+// StringPool.h
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Index of a string in a StringPool.
+using StringId = uint32_t;
+
+static const StringId s_invalidStringId = UINT32_MAX;
+
+// Keeps one copy of each distinct string so content can refer to text by a small id.
+// Filled once while loading; looking an id up is a single index.
+class StringPool
+{
+public:
+	StringPool() = default;
+
+	// Views point into the pool, so copies would dangle. Moves keep them valid.
+	StringPool(const StringPool&) = delete;
+	StringPool& operator=(const StringPool&) = delete;
+	StringPool(StringPool&&) = default;
+	StringPool& operator=(StringPool&&) = default;
+
+	// Returns the id of str, adding it the first time it's seen.
+	StringId Intern(std::string_view str);
+
+	// Empty for ids the pool never handed out. Non-empty views are null terminated.
+	std::string_view Get(StringId id) const
+	{
+		return id < m_strings.size() ? m_strings[id] : std::string_view();
+	}
+
+	size_t GetCount() const { return m_strings.size(); }
+
+private:
+	// Node based, so the keys never move and m_strings can point straight at them.
+	std::unordered_map<std::string, StringId> m_ids;
+	std::vector<std::string_view> m_strings;
+};
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,147 @@
+//---------------------------------------------------------------
+//
+// Trace.cpp
+//
+
+#include "Trace.h"
+
+#include "Log.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+//==============================================================================
+
+// Past this many events a thread stops recording rather than grow without bound.
+const size_t s_maxEventsPerThread = 1 << 20;
+
+enum class EventType : uint8_t
+{
+	ZONE,
+	COUNTER
+};
+
+struct TraceEvent
+{
+	const char* name;
+	uint64_t start;
+
+	// End time for zones, value for counters.
+	int64_t value;
+	EventType type;
+};
+
+struct ThreadBuffer
+{
+	// Only ever contended while a trace is being written out.
+	std::mutex mutex;
+
+	uint32_t threadId = 0;
+	std::vector<TraceEvent> events;
+};
+
+std::mutex s_buffersMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> s_buffers;
+uint64_t s_startTimestamp = 0;
+
+ThreadBuffer& GetThreadBuffer()
+{
+	thread_local std::shared_ptr<ThreadBuffer> t_buffer;
+	if (!t_buffer)
+	{
+		t_buffer = std::make_shared<ThreadBuffer>();
+		t_buffer->events.reserve(4096);
+
+		std::lock_guard<std::mutex> lock(s_buffersMutex);
+		t_buffer->threadId = static_cast<uint32_t>(s_buffers.size() + 1);
+		s_buffers.push_back(t_buffer);
+	}
+	return *t_buffer;
+}
+
+void AddEvent(const TraceEvent& event)
+{
+	ThreadBuffer& buffer = GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(buffer.mutex);
+	if (buffer.events.size() < s_maxEventsPerThread)
+	{
+		buffer.events.push_back(event);
+	}
+}
+
+//==============================================================================
+
+} // anonymous namespace
+
+std::atomic<bool> Tracing::Detail::s_isRecording = false;
+
+void Tracing::Start()
+{
+	s_startTimestamp = Detail::GetTimestamp();
+	Detail::s_isRecording.store(true, std::memory_order_relaxed);
+}
+
+bool Tracing::WriteChromeTrace(const std::string& path)
+{
+	Detail::s_isRecording.store(false, std::memory_order_relaxed);
+
+	FILE* file = std::fopen(path.c_str(), "w");
+	if (!file)
+	{
+		LOG_ERROR("Could not open trace file. file={}", path);
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(s_buffersMutex);
+
+	std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	bool isFirst = true;
+	for (const std::shared_ptr<ThreadBuffer>& buffer : s_buffers)
+	{
+		std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+		for (const TraceEvent& event : buffer->events)
+		{
+			double start = static_cast<double>(event.start - s_startTimestamp) / 1000.0;
+			if (event.type == EventType::ZONE)
+			{
+				double duration = static_cast<double>(event.value - static_cast<int64_t>(event.start)) / 1000.0;
+				std::fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+					isFirst ? "" : ",\n", event.name, buffer->threadId, start, duration);
+			}
+			else
+			{
+				std::fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%lld}}",
+					isFirst ? "" : ",\n", event.name, buffer->threadId, start,
+					static_cast<long long>(event.value));
+			}
+			isFirst = false;
+		}
+		buffer->events.clear();
+	}
+	std::fprintf(file, "\n]}\n");
+
+	bool succeeded = std::ferror(file) == 0;
+	std::fclose(file);
+	return succeeded;
+}
+
+uint64_t Tracing::Detail::GetTimestamp()
+{
+	auto sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch).count());
+}
+
+void Tracing::Detail::RecordZone(const char* name, uint64_t start, uint64_t end)
+{
+	AddEvent({ name, start, static_cast<int64_t>(end), EventType::ZONE });
+}
+
+void Tracing::Detail::RecordCounter(const char* name, int64_t value)
+{
+	AddEvent({ name, GetTimestamp(), value, EventType::COUNTER });
+}
@@ -0,0 +1,93 @@
+//---------------------------------------------------------------
+//
+// Trace.h
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace Tracing {
+
+//==============================================================================
+
+// Set to 0 to compile every trace site away.
+#ifndef TRACING_ENABLED
+#define TRACING_ENABLED 1
+#endif
+
+// Starts recording zones and counters on every thread.
+void Start();
+
+// Stops recording and writes everything recorded so far as a Chrome trace, which
+// chrome://tracing and ui.perfetto.dev both open.
+bool WriteChromeTrace(const std::string& path);
+
+//------------------------------------------------------------------------------
+// Implementation details for the macros below.
+
+namespace Detail {
+
+extern std::atomic<bool> s_isRecording;
+
+inline bool IsRecording()
+{
+	return s_isRecording.load(std::memory_order_relaxed);
+}
+
+uint64_t GetTimestamp();
+
+// Names must be string literals; only the pointer is kept.
+void RecordZone(const char* name, uint64_t start, uint64_t end);
+void RecordCounter(const char* name, int64_t value);
+
+// Times its own lifetime. Costs one relaxed load when not recording.
+class ScopedZone
+{
+public:
+	explicit ScopedZone(const char* name)
+		: m_name(name)
+		, m_start(IsRecording() ? GetTimestamp() : 0)
+	{
+	}
+
+	~ScopedZone()
+	{
+		if (m_start != 0 && IsRecording())
+		{
+			RecordZone(m_name, m_start, GetTimestamp());
+		}
+	}
+
+	ScopedZone(const ScopedZone&) = delete;
+	ScopedZone& operator=(const ScopedZone&) = delete;
+
+private:
+	const char* m_name;
+	uint64_t m_start;
+};
+
+} // namespace Detail
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+#if TRACING_ENABLED
+#define TRACE_SCOPE(name) Tracing::Detail::ScopedZone TRACE_CONCAT(traceZone, __LINE__)(name)
+#define TRACE_COUNTER(name, value)                                      \
+{                                                                       \
+	if (Tracing::Detail::IsRecording())                                 \
+	{                                                                   \
+		Tracing::Detail::RecordCounter(name, static_cast<int64_t>(value)); \
+	}                                                                   \
+}
+#else
+#define TRACE_SCOPE(name)
+#define TRACE_COUNTER(name, value) {}
+#endif
+
+//==============================================================================
+
+} // namespace Tracing
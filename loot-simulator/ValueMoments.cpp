@@ -0,0 +1,84 @@
+//---------------------------------------------------------------
+//
+// ValueMoments.cpp
+//
+
+#include "ValueMoments.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace LootSimulator {
+
+//===============================================================
+
+void ValueMoments::Merge(const ValueMoments& other)
+{
+	if (other.m_count == 0)
+	{
+		return;
+	}
+
+	if (m_count == 0)
+	{
+		*this = other;
+		return;
+	}
+
+	double countA = static_cast<double>(m_count);
+	double countB = static_cast<double>(other.m_count);
+	double count = countA + countB;
+
+	double delta = other.m_mean - m_mean;
+	double deltaSquared = delta * delta;
+	double product = countA * countB;
+
+	double m2 = m_m2 + other.m_m2 + deltaSquared * product / count;
+	double m3 = m_m3 + other.m_m3
+		+ deltaSquared * delta * product * (countA - countB) / (count * count)
+		+ 3.0 * delta * (countA * other.m_m2 - countB * m_m2) / count;
+	double m4 = m_m4 + other.m_m4
+		+ deltaSquared * deltaSquared * product * (countA * countA - product + countB * countB) / (count * count * count)
+		+ 6.0 * deltaSquared * (countA * countA * other.m_m2 + countB * countB * m_m2) / (count * count)
+		+ 4.0 * delta * (countA * other.m_m3 - countB * m_m3) / count;
+
+	m_count += other.m_count;
+	m_mean += delta * countB / count;
+	m_m2 = m2;
+	m_m3 = m3;
+	m_m4 = m4;
+	m_min = std::min(m_min, other.m_min);
+	m_max = std::max(m_max, other.m_max);
+}
+
+double ValueMoments::GetVariance() const
+{
+	return m_count > 1 ? m_m2 / static_cast<double>(m_count - 1) : 0.0;
+}
+
+double ValueMoments::GetStandardDeviation() const
+{
+	return std::sqrt(GetVariance());
+}
+
+double ValueMoments::GetSkewness() const
+{
+	if (m_m2 <= 0.0)
+	{
+		return 0.0;
+	}
+	return std::sqrt(static_cast<double>(m_count)) * m_m3 / std::pow(m_m2, 1.5);
+}
+
+double ValueMoments::GetExcessKurtosis() const
+{
+	if (m_m2 <= 0.0)
+	{
+		return 0.0;
+	}
+	return static_cast<double>(m_count) * m_m4 / (m_m2 * m_m2) - 3.0;
+}
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,73 @@
+//---------------------------------------------------------------
+//
+// ValueMoments.h
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace LootSimulator {
+
+//===============================================================
+
+// Streaming count, mean and central moments up to the fourth, updated a value at a time
+// with Welford's method as extended by Terriberry, so nothing is stored per value and long
+// runs don't lose precision to cancellation. Two can be merged with Pébay's pairwise
+// formulas, which give the same moments as recording everything into one, up to rounding.
+// Not thread safe; give each thread its own and merge them.
+class ValueMoments
+{
+public:
+	void Record(double value)
+	{
+		double previousCount = static_cast<double>(m_count);
+		++m_count;
+		double count = static_cast<double>(m_count);
+
+		double delta = value - m_mean;
+		double deltaOverCount = delta / count;
+		double deltaOverCountSquared = deltaOverCount * deltaOverCount;
+		double term = delta * deltaOverCount * previousCount;
+
+		m_mean += deltaOverCount;
+		m_m4 += term * deltaOverCountSquared * (count * count - 3.0 * count + 3.0)
+			+ 6.0 * deltaOverCountSquared * m_m2 - 4.0 * deltaOverCount * m_m3;
+		m_m3 += term * deltaOverCount * (count - 2.0) - 3.0 * deltaOverCount * m_m2;
+		m_m2 += term;
+
+		m_min = m_count == 1 || value < m_min ? value : m_min;
+		m_max = m_count == 1 || value > m_max ? value : m_max;
+	}
+
+	void Merge(const ValueMoments& other);
+
+	uint64_t GetCount() const { return m_count; }
+	double GetMean() const { return m_mean; }
+	double GetMin() const { return m_min; }
+	double GetMax() const { return m_max; }
+
+	// Sample variance. 0 with fewer than two values.
+	double GetVariance() const;
+	double GetStandardDeviation() const;
+
+	// 0 when every value was the same.
+	double GetSkewness() const;
+	double GetExcessKurtosis() const;
+
+private:
+	uint64_t m_count = 0;
+	double m_mean = 0.0;
+
+	// Sums of the second, third and fourth powers of the distance from the mean.
+	double m_m2 = 0.0;
+	double m_m3 = 0.0;
+	double m_m4 = 0.0;
+
+	double m_min = 0.0;
+	double m_max = 0.0;
+};
+
+//===============================================================
+
+} // namespace LootSimulator
@@ -0,0 +1,176 @@
+//-------------------------------------------------------------------------------
+//
+// BakedContent.h
+//
+
+#pragma once
+
+// This is a generated file! Any changes here will be lost!!!
+
+#include "../BakedLoot.h"
+
+namespace LootSimulator {
+
+//===============================================================================
+
+inline constexpr const char* s_bakedTreasureNames[] =
+{
+    "Regeneration Ring",
+    "Cursed Ring",
+    "Nothing",
+    "Heater Shield",
+    "Kite Shield",
+    "Gold Pile",
+    "Rusty Sword",
+    "Godly Sword",
+    "Small Shield",
+    "Sharp Sword",
+    "Magic Staff",
+    "Apple",
+    "Amulet of Destruction"
+};
+
+inline constexpr BakedTable<3> s_bakedGoblinTable0 =
+{
+    "resources/loot-tables/variety-tier-1.json",
+    1.0f,
+    1.0f,
+    {{ TreasureType::GOLD_PILE, TreasureType::RUSTY_SWORD, TreasureType::CURSED_RING }},
+    {{ 0.200000003f, 0.5f, 0.300000012f }},
+    {{ 0.200000003f, 0.699999988f, 1.0f }},
+    {{ 0.600000024f, 1.0f, 0.900000036f }},
+    {{ 1, 1, 1 }},
+    {{ 1, 1, 1 }},
+    {{ 1, 1, 1 }}
+};
+
+inline constexpr BakedTable<2> s_bakedSkeletonTable0 =
+{
+    "resources/loot-tables/shields-tier-1.json",
+    1.0f,
+    1.0f,
+    {{ TreasureType::HEATER_SHIELD, TreasureType::KITE_SHIELD }},
+    {{ 0.100000001f, 0.899999976f }},
+    {{ 0.100000001f, 1.0f }},
+    {{ 0.200000003f, 1.0f }},
+    {{ 1, 1 }},
+    {{ 1, 1 }},
+    {{ 1, 1 }}
+};
+
+inline constexpr BakedTable<3> s_bakedSkeletonTable1 =
+{
+    "resources/loot-tables/rings-tier-1.json",
+    1.0f,
+    1.0f,
+    {{ TreasureType::REGENERATION_RING, TreasureType::CURSED_RING, TreasureType::NOTHING }},
+    {{ 0.0500000007f, 0.100000001f, 0.850000024f }},
+    {{ 0.0500000007f, 0.150000006f, 1.0f }},
+    {{ 0.149999991f, 0.299999982f, 1.0f }},
+    {{ 2, 2, 2 }},
+    {{ 1, 1, 1 }},
+    {{ 1, 1, 1 }}
+};
+
+inline constexpr BakedTable<1> s_bakedDragonTable0 =
+{
+    "resources/loot-tables/weapons-top-tier.json",
+    0.5f,
+    1.0f,
+    {{ TreasureType::GODLY_SWORD }},
+    {{ 1.0f }},
+    {{ 1.0f }},
+    {{ 1.0f }},
+    {{ 0 }},
+    {{ 1 }},
+    {{ 1 }}
+};
+
+inline constexpr BakedTable<2> s_bakedDragonTable1 =
+{
+    "resources/loot-tables/shields-tier-1.json",
+    1.0f,
+    1.0f,
+    {{ TreasureType::HEATER_SHIELD, TreasureType::KITE_SHIELD }},
+    {{ 0.100000001f, 0.899999976f }},
+    {{ 0.100000001f, 1.0f }},
+    {{ 0.200000003f, 1.0f }},
+    {{ 1, 1 }},
+    {{ 1, 1 }},
+    {{ 1, 1 }}
+};
+
+inline constexpr BakedTable<3> s_bakedDragonTable2 =
+{
+    "resources/loot-tables/rings-tier-1.json",
+    1.0f,
+    1.0f,
+    {{ TreasureType::REGENERATION_RING, TreasureType::CURSED_RING, TreasureType::NOTHING }},
+    {{ 0.0500000007f, 0.100000001f, 0.850000024f }},
+    {{ 0.0500000007f, 0.150000006f, 1.0f }},
+    {{ 0.149999991f, 0.299999982f, 1.0f }},
+    {{ 2, 2, 2 }},
+    {{ 1, 1, 1 }},
+    {{ 1, 1, 1 }}
+};
+
+inline constexpr BakedTable<5> s_bakedZombieTable0 =
+{
+    "resources/loot-tables/zombie-loot.json",
+    1.0f,
+    1.0f,
+    {{ TreasureType::SMALL_SHIELD, TreasureType::SHARP_SWORD, TreasureType::MAGIC_STAFF, TreasureType::APPLE, TreasureType::AMULET_OF_DESTRUCTION }},
+    {{ 0.280000001f, 0.200000003f, 0.400000006f, 0.100000001f, 0.0199999996f }},
+    {{ 0.280000001f, 0.480000019f, 0.879999995f, 0.980000019f, 1.0f }},
+    {{ 1.0f, 0.600000024f, 0.600000024f, 0.5f, 0.099999994f }},
+    {{ 0, 0, 1, 2, 2 }},
+    {{ 1, 1, 1, 1, 1 }},
+    {{ 1, 1, 1, 1, 1 }}
+};
+
+inline constexpr auto s_bakedMonsters = std::make_tuple(
+    MakeBakedMonster<0>(MonsterType::GOBLIN, "Goblin", s_bakedGoblinTable0),
+    MakeBakedMonster<0>(MonsterType::SKELETON, "Skeleton", s_bakedSkeletonTable0, s_bakedSkeletonTable1),
+    MakeBakedMonster<1>(MonsterType::DRAGON, "Dragon", s_bakedDragonTable0, s_bakedDragonTable1, s_bakedDragonTable2),
+    MakeBakedMonster<0>(MonsterType::ZOMBIE, "Zombie", s_bakedZombieTable0));
+
+inline constexpr std::array<BakedEncounter, 9> s_bakedEncounters =
+{{
+    { "wilds", MonsterType::GOBLIN, 1.0f },
+    { "wilds", MonsterType::SKELETON, 1.0f },
+    { "wilds", MonsterType::DRAGON, 1.0f },
+    { "wilds", MonsterType::ZOMBIE, 1.0f },
+    { "crypt", MonsterType::SKELETON, 6.0f },
+    { "crypt", MonsterType::ZOMBIE, 3.5f },
+    { "crypt", MonsterType::DRAGON, 0.5f },
+    { "lair", MonsterType::GOBLIN, 8.0f },
+    { "lair", MonsterType::DRAGON, 2.0f }
+}};
+
+inline constexpr std::array<PityRule, 4> s_bakedPityRules =
+{{
+    { MonsterType::GOBLIN, TreasureType::GOLD_PILE, 10 },
+    { MonsterType::SKELETON, TreasureType::REGENERATION_RING, 30 },
+    { MonsterType::DRAGON, TreasureType::GODLY_SWORD, 3 },
+    { MonsterType::ZOMBIE, TreasureType::AMULET_OF_DESTRUCTION, 150 }
+}};
+
+inline constexpr std::array<TreasureValue, 12> s_bakedTreasureValues =
+{{
+    { TreasureType::REGENERATION_RING, 250 },
+    { TreasureType::CURSED_RING, 15 },
+    { TreasureType::HEATER_SHIELD, 40 },
+    { TreasureType::KITE_SHIELD, 25 },
+    { TreasureType::GOLD_PILE, 50 },
+    { TreasureType::RUSTY_SWORD, 5 },
+    { TreasureType::GODLY_SWORD, 1000 },
+    { TreasureType::SMALL_SHIELD, 10 },
+    { TreasureType::SHARP_SWORD, 60 },
+    { TreasureType::MAGIC_STAFF, 120 },
+    { TreasureType::APPLE, 0.5 },
+    { TreasureType::AMULET_OF_DESTRUCTION, 5000 }
+}};
+
+//===============================================================================
+
+} // namespace LootSimulator
@@ -7,6 +7,9 @@
 
 // This is a generated file! Any changes here will be lost!!!
 
+#include <iterator>
+#include <string_view>
+
 #include <nlohmann/json/json.hpp>
 
 namespace LootSimulator {
@@ -42,32 +45,138 @@ enum struct TreasureType : int32_t
     NUM_TYPES
 };
 
-NLOHMANN_JSON_SERIALIZE_ENUM(MonsterType,
-    {
-        { MonsterType::NONE, "none" },
-        { MonsterType::GOBLIN, "goblin" },
-        { MonsterType::SKELETON, "skeleton" },
-        { MonsterType::DRAGON, "dragon" },
-        { MonsterType::ZOMBIE, "zombie" },
-    });
-
-NLOHMANN_JSON_SERIALIZE_ENUM(TreasureType,
+template <typename Enum>
+struct EnumId
+{
+    std::string_view id;
+    Enum value;
+};
+
+// Binary searches ids sorted by id. Unknown ids give the fallback.
+template <typename Enum, size_t Count>
+constexpr Enum FindEnumById(const EnumId<Enum> (&ids)[Count], std::string_view id, Enum fallback)
+{
+    size_t first = 0;
+    size_t count = Count;
+    while (count > 0)
     {
-        { TreasureType::NONE, "none" },
-        { TreasureType::REGENERATION_RING, "regenerationRing" },
-        { TreasureType::CURSED_RING, "cursedRing" },
-        { TreasureType::NOTHING, "nothing" },
-        { TreasureType::HEATER_SHIELD, "heaterShield" },
-        { TreasureType::KITE_SHIELD, "kiteShield" },
-        { TreasureType::GOLD_PILE, "goldPile" },
-        { TreasureType::RUSTY_SWORD, "rustySword" },
-        { TreasureType::GODLY_SWORD, "godlySword" },
-        { TreasureType::SMALL_SHIELD, "smallShield" },
-        { TreasureType::SHARP_SWORD, "sharpSword" },
-        { TreasureType::MAGIC_STAFF, "magicStaff" },
-        { TreasureType::APPLE, "apple" },
-        { TreasureType::AMULET_OF_DESTRUCTION, "amuletOfDestruction" },
-    });
+        size_t half = count / 2;
+        if (ids[first + half].id < id)
+        {
+            first += half + 1;
+            count -= half + 1;
+        }
+        else
+        {
+            count = half;
+        }
+    }
+    return first < Count && ids[first].id == id ? ids[first].value : fallback;
+}
+
+inline constexpr EnumId<MonsterType> s_sortedMonsterTypeIds[] =
+{
+    { "dragon", MonsterType::DRAGON },
+    { "goblin", MonsterType::GOBLIN },
+    { "none", MonsterType::NONE },
+    { "skeleton", MonsterType::SKELETON },
+    { "zombie", MonsterType::ZOMBIE }
+};
+
+inline constexpr std::string_view s_monsterTypeIds[] =
+{
+    "none",
+    "goblin",
+    "skeleton",
+    "dragon",
+    "zombie"
+};
+
+static_assert(std::size(s_monsterTypeIds) == size_t(MonsterType::NUM_TYPES) + 1);
+
+constexpr MonsterType GetMonsterTypeFromId(std::string_view id)
+{
+    return FindEnumById(s_sortedMonsterTypeIds, id, MonsterType::NONE);
+}
+
+constexpr std::string_view GetMonsterTypeId(MonsterType type)
+{
+    size_t index = size_t(int32_t(type) + 1);
+    return index < std::size(s_monsterTypeIds) ? s_monsterTypeIds[index] : s_monsterTypeIds[0];
+}
+
+inline void to_json(nlohmann::json& j, MonsterType type)
+{
+    j = std::string(GetMonsterTypeId(type));
+}
+
+// Anything that is not a known id reads as NONE.
+inline void from_json(const nlohmann::json& j, MonsterType& type)
+{
+    const std::string* id = j.get_ptr<const std::string*>();
+    type = id ? GetMonsterTypeFromId(*id) : MonsterType::NONE;
+}
+
+inline constexpr EnumId<TreasureType> s_sortedTreasureTypeIds[] =
+{
+    { "amuletOfDestruction", TreasureType::AMULET_OF_DESTRUCTION },
+    { "apple", TreasureType::APPLE },
+    { "cursedRing", TreasureType::CURSED_RING },
+    { "godlySword", TreasureType::GODLY_SWORD },
+    { "goldPile", TreasureType::GOLD_PILE },
+    { "heaterShield", TreasureType::HEATER_SHIELD },
+    { "kiteShield", TreasureType::KITE_SHIELD },
+    { "magicStaff", TreasureType::MAGIC_STAFF },
+    { "none", TreasureType::NONE },
+    { "nothing", TreasureType::NOTHING },
+    { "regenerationRing", TreasureType::REGENERATION_RING },
+    { "rustySword", TreasureType::RUSTY_SWORD },
+    { "sharpSword", TreasureType::SHARP_SWORD },
+    { "smallShield", TreasureType::SMALL_SHIELD }
+};
+
+inline constexpr std::string_view s_treasureTypeIds[] =
+{
+    "none",
+    "regenerationRing",
+    "cursedRing",
+    "nothing",
+    "heaterShield",
+    "kiteShield",
+    "goldPile",
+    "rustySword",
+    "godlySword",
+    "smallShield",
+    "sharpSword",
+    "magicStaff",
+    "apple",
+    "amuletOfDestruction"
+};
+
+static_assert(std::size(s_treasureTypeIds) == size_t(TreasureType::NUM_TYPES) + 1);
+
+constexpr TreasureType GetTreasureTypeFromId(std::string_view id)
+{
+    return FindEnumById(s_sortedTreasureTypeIds, id, TreasureType::NONE);
+}
+
+constexpr std::string_view GetTreasureTypeId(TreasureType type)
+{
+    size_t index = size_t(int32_t(type) + 1);
+    return index < std::size(s_treasureTypeIds) ? s_treasureTypeIds[index] : s_treasureTypeIds[0];
+}
+
+inline void to_json(nlohmann::json& j, TreasureType type)
+{
+    j = std::string(GetTreasureTypeId(type));
+}
+
+// Anything that is not a known id reads as NONE.
+inline void from_json(const nlohmann::json& j, TreasureType& type)
+{
+    const std::string* id = j.get_ptr<const std::string*>();
+    type = id ? GetTreasureTypeFromId(*id) : TreasureType::NONE;
+}
 
 //===============================================================================
 
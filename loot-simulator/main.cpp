@@ -4,11 +4,57 @@
 //
 
 #include "GameController.h"
+#include "LiveStats.h"
+#include "Log.h"
+#include "PerfCounters.h"
+#include "SimulationOptions.h"
 
-int main()
+#include <iostream>
+#include "Trace.h"
+
+int main(int argc, char* argv[])
 {
-	LootSimulator::GameController gc;
-	gc.Run();
+	LootSimulator::SimulationOptions options;
+	if (!LootSimulator::ParseSimulationOptions(argc, argv, options))
+	{
+		return 1;
+	}
+
+	Logger::Initialize(options.logPath);
+	if (!options.tracePath.empty())
+	{
+		Tracing::Start();
+	}
+
+	if (!options.statsPath.empty())
+	{
+		LootSimulator::LiveStats::Start(options.statsPath);
+	}
+
+	if (options.isCountingPerf)
+	{
+		PerfCounters::Start();
+	}
+
+	bool isSuccess = false;
+	{
+		LootSimulator::GameController gc(options);
+		isSuccess = gc.Run();
+	}
+
+	LootSimulator::LiveStats::Stop();
+
+	if (PerfCounters::IsEnabled())
+	{
+		std::cout << "\n";
+		PerfCounters::WriteReport(std::cout);
+	}
+
+	if (!options.tracePath.empty())
+	{
+		Tracing::WriteChromeTrace(options.tracePath);
+	}
+	Logger::Shutdown();
 
-	return 0;
+	return isSuccess ? 0 : 1;
 }
@@ -0,0 +1,135 @@
+//---------------------------------------------------------------
+//
+// main.cpp
+//
+// lootsim-top: shows the live stats a running loot-simulator publishes with --stats.
+//
+
+#include "loot-simulator/StatsSegment.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+using namespace LootSimulator;
+
+namespace {
+
+//===============================================================
+
+const std::chrono::seconds s_refreshInterval(1);
+
+void PrintUsage()
+{
+	std::printf(
+		"Usage: lootsim-top [--once] <stats file>\n"
+		"\t--once\tPrint a single snapshot and exit.\n");
+}
+
+void PrintSnapshot(const StatsSegmentLayout& layout)
+{
+	uint64_t totalKills = layout.totalKills.load(std::memory_order_relaxed);
+	uint64_t targetKills = layout.targetKills.load(std::memory_order_relaxed);
+	uint64_t etaSeconds = layout.etaSeconds.load(std::memory_order_relaxed);
+
+	std::printf("loot-simulator pid %u, up %.1fs\n", layout.ownerProcessId,
+		static_cast<double>(layout.uptimeMilliseconds.load(std::memory_order_relaxed)) / 1000.0);
+
+	std::printf("kills  %" PRIu64 " / %" PRIu64, totalKills, targetKills);
+	if (targetKills > 0)
+	{
+		std::printf(" (%.1f%%)", 100.0 * static_cast<double>(totalKills) / static_cast<double>(targetKills));
+	}
+	std::printf("\n");
+
+	std::printf("rolls  %" PRIu64 "\n", layout.totalRolls.load(std::memory_order_relaxed));
+	std::printf("rate   %" PRIu64 " kills/s, %" PRIu64 " rolls/s\n",
+		layout.killsPerSecond.load(std::memory_order_relaxed),
+		layout.rollsPerSecond.load(std::memory_order_relaxed));
+
+	if (etaSeconds == UINT64_MAX)
+	{
+		std::printf("eta    -\n");
+	}
+	else
+	{
+		std::printf("eta    %" PRIu64 "s\n", etaSeconds);
+	}
+
+	std::printf("rss    %.1f MiB\n",
+		static_cast<double>(layout.residentBytes.load(std::memory_order_relaxed)) / (1024.0 * 1024.0));
+
+	std::printf("%-6s %-8s %14s %14s %14s\n", "slot", "pid", "kills", "target", "rolls");
+	for (uint32_t i = 0; i < s_maxStatsSlots; ++i)
+	{
+		const StatsSlot& slot = layout.slots[i];
+		if (slot.isActive.load(std::memory_order_acquire) == 0)
+		{
+			continue;
+		}
+
+		std::printf("%-6u %-8u %14" PRIu64 " %14" PRIu64 " %14" PRIu64 "\n", i,
+			slot.processId.load(std::memory_order_relaxed),
+			slot.kills.load(std::memory_order_relaxed),
+			slot.targetKills.load(std::memory_order_relaxed),
+			slot.rolls.load(std::memory_order_relaxed));
+	}
+	std::fflush(stdout);
+}
+
+//===============================================================
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+	bool isOnce = false;
+	std::string path;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--once") == 0)
+		{
+			isOnce = true;
+		}
+		else if (path.empty() && argv[i][0] != '-')
+		{
+			path = argv[i];
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	if (path.empty())
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	StatsSegment segment;
+	if (!segment.Open(path))
+	{
+		std::fprintf(stderr, "Could not open stats file %s\n", path.c_str());
+		return 1;
+	}
+
+	const StatsSegmentLayout& layout = *segment.GetLayout();
+	while (true)
+	{
+		PrintSnapshot(layout);
+		if (isOnce)
+		{
+			break;
+		}
+
+		std::this_thread::sleep_for(s_refreshInterval);
+		std::printf("\n");
+	}
+
+	return 0;
+}
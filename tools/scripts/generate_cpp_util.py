@@ -221,6 +221,26 @@ def get_include_system_string(include_name) -> string:
     return '#include <' + include_name + '>\n'
 
 
+def get_include_local_string(include_name) -> string:
+    """ Used to generate an include string for a file in this project.
+
+    A new line is appended to the end as there is no scenario where this
+    wouldn't be added manually.
+
+    Example:
+        `#include "Foo.h"`
+
+    Args:
+        include_name(string): Required. Specifies the path of the include
+        that will be written in the include statement.
+
+    Returns:
+        An include statement with quotes.
+
+    """
+    return '#include "' + include_name + '"\n'
+
+
 def get_namespace_opener(namespace_name) -> string:
     """ Convenience function used to generate a namespace opening statement.
 
@@ -7,18 +7,30 @@ import os
 import re
 import sys
 import string
+import struct
 
 HEADER_FILE_NAME = 'EnumDataBindings.h'
+BAKED_HEADER_FILE_NAME = 'BakedContent.h'
 
 GENERATED_DIR_NAME = os.path.join(os.path.dirname(os.path.abspath(__file__)),
                                   '../../loot-simulator/generated')
 ENUM_DATA_BINDINGS_FILE_PATH = os.path.join(GENERATED_DIR_NAME,
                                             'EnumDataBindings.h')
+BAKED_CONTENT_FILE_PATH = os.path.join(GENERATED_DIR_NAME,
+                                       BAKED_HEADER_FILE_NAME)
+REPOSITORY_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                               '../..')
 RESOURCES_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)),
                               '../../resources')
 MONSTER_DATA_PATH = os.path.join(RESOURCES_PATH, 'monsters.json')
+ENCOUNTER_DATA_PATH = os.path.join(RESOURCES_PATH, 'encounters.json')
+PITY_DATA_PATH = os.path.join(RESOURCES_PATH, 'pity-rules.json')
+VALUE_DATA_PATH = os.path.join(RESOURCES_PATH, 'treasure-values.json')
 TABLE_DATA_PATH = os.path.join(RESOURCES_PATH, 'loot-tables')
 
+# Pass this to also bake all of the content into BakedContent.h.
+BAKED_ARGUMENT = '--baked'
+
 MONSTER_TYPE_NAME = 'MonsterType'
 ITEM_TYPE_NAME = 'TreasureType'
 
@@ -50,11 +62,14 @@ def init_monster_enums():
 
 def init_item_enums():
     validPaths = TABLE_DATA_PATH + '/*.json'
-    for filepath in glob.iglob(validPaths):
+    for filepath in sorted(glob.glob(validPaths)):
         with open(filepath) as json_file:
             data = json.load(json_file)
 
+            # Items naming another table have no type of their own.
             for m in data['items']:
+                if 'type' not in m:
+                    continue
                 type_id = m['type']
                 ITEM_IDS_TO_ENUM[type_id] = ""
 
@@ -62,13 +77,12 @@ def init_item_enums():
                 ITEM_IDS_TO_ENUM[id] = id_to_enum(id)
 
 
-def write_code_to_header(code_string):
+def write_code_to_header(code_string, path=ENUM_DATA_BINDINGS_FILE_PATH):
     try:
-        with open(ENUM_DATA_BINDINGS_FILE_PATH,
-                  'w+', encoding='utf-8') as enum_bindings_header:
-            enum_bindings_header.write(code_string)
+        with open(path, 'w+', encoding='utf-8') as header:
+            header.write(code_string)
     except OSError as e:
-        logging.error('Failed to create html dump. ' +
+        logging.error('Failed to write header. ' +
                       ' error=' + e.strerror +
                       ' file_name=' + path)
 
@@ -121,31 +135,94 @@ def get_monster_enum_string():
             cpp_util.get_adt_scope_close())
 
 
-def get_enum_bindings(ids, typeName):
-    binding_string = ''
-    for i, (k, v) in enumerate(ids.items()):
-        binding_string += (
-            cpp_util.get_indentation_spaces(2) + 
-            '{ ' + typeName + '::' + v + ', ' + "\"" + k + "\" },\n")
+# Binary searched by every from_json, so it needs no hashing or allocation.
+ENUM_ID_LOOKUP_STRING = '''template <typename Enum>
+struct EnumId
+{
+    std::string_view id;
+    Enum value;
+};
+
+// Binary searches ids sorted by id. Unknown ids give the fallback.
+template <typename Enum, size_t Count>
+constexpr Enum FindEnumById(const EnumId<Enum> (&ids)[Count], std::string_view id, Enum fallback)
+{
+    size_t first = 0;
+    size_t count = Count;
+    while (count > 0)
+    {
+        size_t half = count / 2;
+        if (ids[first + half].id < id)
+        {
+            first += half + 1;
+            count -= half + 1;
+        }
+        else
+        {
+            count = half;
+        }
+    }
+    return first < Count && ids[first].id == id ? ids[first].value : fallback;
+}
+'''
 
-    return binding_string
 
+def get_enum_bindings(ids, typeName):
+    indent = cpp_util.get_indentation_spaces(1)
+    variable_name = typeName[0].lower() + typeName[1:] + 'Ids'
 
-def get_binding_macro(ids, typeName):
-    return ('NLOHMANN_JSON_SERIALIZE_ENUM(' +
-            typeName +
-            ',\n' +
-            cpp_util.get_indentation_spaces(1) + 
+    # Python sorts str by code point, which matches std::string_view for ascii ids.
+    sorted_ids = [indent + '{ "' + k + '", ' + typeName + '::' + v + ' }'
+                  for k, v in sorted(ids.items())]
+    # Indexed by value + 1 so NONE comes first.
+    ordered_ids = [indent + '"' + k + '"' for k in ids]
+
+    return ('inline constexpr EnumId<' + typeName + '> s_sorted' +
+            typeName + 'Ids[] =\n' +
+            '{\n' +
+            ',\n'.join(sorted_ids) + '\n' +
+            '};\n\n' +
+            'inline constexpr std::string_view s_' + variable_name + '[] =\n' +
+            '{\n' +
+            ',\n'.join(ordered_ids) + '\n' +
+            '};\n\n' +
+            'static_assert(std::size(s_' + variable_name + ') == size_t(' +
+            typeName + '::NUM_TYPES) + 1);\n\n' +
+            'constexpr ' + typeName + ' Get' + typeName +
+            'FromId(std::string_view id)\n' +
             '{\n' +
-            get_enum_bindings(ids, typeName) +
-            cpp_util.get_indentation_spaces(1) + 
-            '});\n')
+            indent + 'return FindEnumById(s_sorted' + typeName + 'Ids, id, ' +
+            typeName + '::NONE);\n' +
+            '}\n\n' +
+            'constexpr std::string_view Get' + typeName + 'Id(' + typeName +
+            ' type)\n' +
+            '{\n' +
+            indent + 'size_t index = size_t(int32_t(type) + 1);\n' +
+            indent + 'return index < std::size(s_' + variable_name +
+            ') ? s_' + variable_name + '[index] : s_' + variable_name +
+            '[0];\n' +
+            '}\n\n' +
+            'inline void to_json(nlohmann::json& j, ' + typeName + ' type)\n' +
+            '{\n' +
+            indent + 'j = std::string(Get' + typeName + 'Id(type));\n' +
+            '}\n\n' +
+            '// Anything that is not a known id reads as NONE.\n' +
+            'inline void from_json(const nlohmann::json& j, ' + typeName +
+            '& type)\n' +
+            '{\n' +
+            indent + 'const std::string* id = j.get_ptr<const std::string*>();\n' +
+            indent + 'type = id ? Get' + typeName + 'FromId(*id) : ' +
+            typeName + '::NONE;\n' +
+            '}\n')
 
 
 def build_code_string():
     return (cpp_util.get_file_info_comment(HEADER_FILE_NAME) +
             cpp_util.get_include_guard() +
             cpp_util.get_generated_file_warning() +
+            cpp_util.get_include_system_string('iterator') +
+            cpp_util.get_include_system_string('string_view') +
+            cpp_util.get_new_line() +
             cpp_util.get_include_system_string('nlohmann/json/json.hpp') +
             cpp_util.get_new_line() +
             cpp_util.get_namespace_opener('LootSimulator') +
@@ -153,10 +230,282 @@ def build_code_string():
             cpp_util.get_new_line() +
             get_enum_string(ITEM_IDS_TO_ENUM, ITEM_TYPE_NAME) +
             cpp_util.get_new_line() +
+            ENUM_ID_LOOKUP_STRING +
+            cpp_util.get_new_line() +
+            get_enum_bindings(MONSTER_IDS_TO_ENUM, MONSTER_TYPE_NAME) +
+            cpp_util.get_new_line() +
+            get_enum_bindings(ITEM_IDS_TO_ENUM, ITEM_TYPE_NAME) +
+            cpp_util.get_new_line() +
+            cpp_util.get_namespace_closer('LootSimulator'))
+
+
+#------------------------------------------------------------------------------
+# Baked content.
+
+
+def to_float32(value):
+    return struct.unpack('f', struct.pack('f', value))[0]
+
+
+def get_float_literal(value):
+    # Nine significant digits always round trip a float.
+    literal = '%.9g' % to_float32(value)
+    if '.' not in literal and 'e' not in literal:
+        literal += '.0'
+    return literal + 'f'
+
+
+def get_alias_table(weights):
+    """ Builds a Vose alias table for the weights.
+
+    Returns:
+        Two lists, the chance each column keeps its own entry and the entry it
+        gives otherwise.
+
+    """
+    count = len(weights)
+    total = sum(weights)
+    scaled = [w * count / total if total > 0 else 1.0 for w in weights]
+    probabilities = [1.0] * count
+    aliases = list(range(count))
+
+    small = [i for i, p in enumerate(scaled) if p < 1.0]
+    large = [i for i, p in enumerate(scaled) if p >= 1.0]
+    while small and large:
+        less = small.pop()
+        more = large.pop()
+        probabilities[less] = scaled[less]
+        aliases[less] = more
+        scaled[more] = (scaled[more] + scaled[less]) - 1.0
+        if scaled[more] < 1.0:
+            small.append(more)
+        else:
+            large.append(more)
 
-            get_binding_macro(MONSTER_IDS_TO_ENUM, MONSTER_TYPE_NAME) +
+    # Whatever is left over is full up to rounding.
+    for i in small + large:
+        probabilities[i] = 1.0
+    return probabilities, aliases
+
+
+def get_quantity_range(item):
+    """ Returns (min, max) of an item's quantity, which is one when not given. """
+    quantity = item.get('quantity', 1)
+    if isinstance(quantity, dict):
+        return quantity['min'], quantity['max']
+    return quantity, quantity
+
+
+def load_table_items(table_path):
+    """ Loads a table's items with nested tables expanded, as the content loader does.
+
+    Weights are float32 and use the loader's arithmetic, so baked tables match
+    loaded ones bit for bit. Expanded items fold into an earlier item of the same
+    type and quantity.
+
+    """
+    with open(os.path.join(REPOSITORY_PATH, table_path)) as json_file:
+        items = json.load(json_file)['items']
+
+    if all('table' not in item for item in items):
+        return items
+
+    expanded = []
+    for item in items:
+        if 'table' not in item:
+            expanded.append(item)
+            continue
+
+        nested_items = load_table_items(item['table'])
+        nested_weight_total = 0.0
+        for nested_item in nested_items:
+            nested_weight_total = to_float32(
+                nested_weight_total + to_float32(nested_item['dropRate']))
+
+        weight = to_float32(item['dropRate'])
+        for nested_item in nested_items:
+            drop_rate = to_float32(weight * to_float32(nested_item['dropRate']) /
+                                   nested_weight_total)
+            existing = [e for e in expanded
+                        if e['type'] == nested_item['type'] and
+                        get_quantity_range(e) == get_quantity_range(nested_item)]
+            if existing:
+                existing[0]['dropRate'] = to_float32(
+                    to_float32(existing[0]['dropRate']) + drop_rate)
+            else:
+                expanded.append(dict(nested_item, dropRate=drop_rate))
+
+    return expanded
+
+
+def get_array_string(values):
+    return '{{ ' + ', '.join(values) + ' }}'
+
+
+def get_baked_table_string(variable_name, table_path, drop_rate):
+    items = load_table_items(table_path)
+    weights = [to_float32(item['dropRate']) for item in items]
+
+    # Sum as floats in data order so the total matches the one computed at runtime.
+    weight_total = 0.0
+    cumulative_weights = []
+    for w in weights:
+        weight_total = to_float32(weight_total + w)
+        cumulative_weights.append(weight_total)
+
+    probabilities, aliases = get_alias_table(weights)
+
+    indent = cpp_util.get_indentation_spaces(1)
+    types = [ITEM_TYPE_NAME + '::' + ITEM_IDS_TO_ENUM[item['type']]
+             for item in items]
+    return ('inline constexpr BakedTable<' + str(len(items)) + '> ' +
+            variable_name + ' =\n' +
+            '{\n' +
+            indent + '"' + table_path + '",\n' +
+            indent + get_float_literal(drop_rate) + ',\n' +
+            indent + get_float_literal(weight_total) + ',\n' +
+            indent + get_array_string(types) + ',\n' +
+            indent + get_array_string(
+                [get_float_literal(w) for w in weights]) + ',\n' +
+            indent + get_array_string(
+                [get_float_literal(w) for w in cumulative_weights]) + ',\n' +
+            indent + get_array_string(
+                [get_float_literal(p) for p in probabilities]) + ',\n' +
+            indent + get_array_string([str(a) for a in aliases]) + ',\n' +
+            indent + get_array_string(
+                [str(get_quantity_range(item)[0]) for item in items]) + ',\n' +
+            indent + get_array_string(
+                [str(get_quantity_range(item)[1]) for item in items]) + '\n' +
+            '};\n\n')
+
+
+def get_baked_monsters_string():
+    with open(MONSTER_DATA_PATH) as json_file:
+        data = json.load(json_file)
+
+    tables_string = ''
+    monster_strings = []
+    for monster in data['monsters']:
+        enum_id = MONSTER_IDS_TO_ENUM[monster['type']]
+        tables = monster['tables']
+
+        # Exclusive tables first, keeping data order otherwise, as LootModel does.
+        exclusive = [t for t in tables if t.get('dropRate', 1.0) != 1.0]
+        guaranteed = [t for t in tables if t.get('dropRate', 1.0) == 1.0]
+
+        table_names = []
+        for i, table in enumerate(exclusive + guaranteed):
+            variable_name = ('s_baked' + enum_id.title().replace('_', '') +
+                             'Table' + str(i))
+            table_names.append(variable_name)
+            tables_string += get_baked_table_string(
+                variable_name, table['path'], table.get('dropRate', 1.0))
+
+        monster_strings.append(
+            cpp_util.get_indentation_spaces(1) +
+            'MakeBakedMonster<' + str(len(exclusive)) + '>(' +
+            MONSTER_TYPE_NAME + '::' + enum_id + ', "' + monster['name'] +
+            '", ' + ', '.join(table_names) + ')')
+
+    return (tables_string +
+            'inline constexpr auto s_bakedMonsters = std::make_tuple(\n' +
+            ',\n'.join(monster_strings) + ');\n')
+
+
+def get_baked_treasure_names_string():
+    names = {}
+    for filepath in sorted(glob.glob(TABLE_DATA_PATH + '/*.json')):
+        with open(filepath) as json_file:
+            for item in json.load(json_file)['items']:
+                if 'type' in item:
+                    names[item['type']] = item['name']
+
+    # Indexed by TreasureType, which skips NONE.
+    name_strings = [cpp_util.get_indentation_spaces(1) + '"' + names[id] + '"'
+                    for id in list(ITEM_IDS_TO_ENUM)[1:]]
+    return ('inline constexpr const char* s_bakedTreasureNames[] =\n' +
+            '{\n' +
+            ',\n'.join(name_strings) + '\n' +
+            '};\n')
+
+
+def get_baked_encounters_string():
+    zones = []
+    if os.path.exists(ENCOUNTER_DATA_PATH):
+        with open(ENCOUNTER_DATA_PATH) as json_file:
+            zones = json.load(json_file)['zones']
+
+    encounter_strings = []
+    for zone in zones:
+        for monster in zone['monsters']:
+            encounter_strings.append(
+                cpp_util.get_indentation_spaces(1) + '{ "' + zone['name'] +
+                '", ' + MONSTER_TYPE_NAME + '::' +
+                MONSTER_IDS_TO_ENUM[monster['type']] + ', ' +
+                get_float_literal(monster['weight']) + ' }')
+
+    return ('inline constexpr std::array<BakedEncounter, ' +
+            str(len(encounter_strings)) + '> s_bakedEncounters =\n' +
+            '{{\n' +
+            ',\n'.join(encounter_strings) + '\n' +
+            '}};\n')
+
+
+def get_baked_pity_rules_string():
+    rules = []
+    if os.path.exists(PITY_DATA_PATH):
+        with open(PITY_DATA_PATH) as json_file:
+            rules = json.load(json_file)['rules']
+
+    rule_strings = [cpp_util.get_indentation_spaces(1) + '{ ' +
+                    MONSTER_TYPE_NAME + '::' +
+                    MONSTER_IDS_TO_ENUM[rule['monster']] + ', ' +
+                    ITEM_TYPE_NAME + '::' + ITEM_IDS_TO_ENUM[rule['treasure']] +
+                    ', ' + str(rule['afterKills']) + ' }'
+                    for rule in rules]
+
+    return ('inline constexpr std::array<PityRule, ' + str(len(rule_strings)) +
+            '> s_bakedPityRules =\n' +
+            '{{\n' +
+            ',\n'.join(rule_strings) + '\n' +
+            '}};\n')
+
+
+def get_baked_treasure_values_string():
+    values = []
+    if os.path.exists(VALUE_DATA_PATH):
+        with open(VALUE_DATA_PATH) as json_file:
+            values = json.load(json_file)['values']
+
+    # Seventeen significant digits always round trip a double.
+    value_strings = [cpp_util.get_indentation_spaces(1) + '{ ' +
+                     ITEM_TYPE_NAME + '::' + ITEM_IDS_TO_ENUM[value['treasure']] +
+                     ', ' + ('%.17g' % float(value['value'])) + ' }'
+                     for value in values]
+
+    return ('inline constexpr std::array<TreasureValue, ' +
+            str(len(value_strings)) + '> s_bakedTreasureValues =\n' +
+            '{{\n' +
+            ',\n'.join(value_strings) + '\n' +
+            '}};\n')
+
+
+def build_baked_code_string():
+    return (cpp_util.get_file_info_comment(BAKED_HEADER_FILE_NAME) +
+            cpp_util.get_include_guard() +
+            cpp_util.get_generated_file_warning() +
+            cpp_util.get_include_local_string('../BakedLoot.h') +
+            cpp_util.get_new_line() +
+            cpp_util.get_namespace_opener('LootSimulator') +
+            get_baked_treasure_names_string() +
+            cpp_util.get_new_line() +
+            get_baked_monsters_string() +
+            cpp_util.get_new_line() +
+            get_baked_encounters_string() +
+            cpp_util.get_new_line() +
+            get_baked_pity_rules_string() +
             cpp_util.get_new_line() +
-            get_binding_macro(ITEM_IDS_TO_ENUM, ITEM_TYPE_NAME) +
+            get_baked_treasure_values_string() +
             cpp_util.get_new_line() +
             cpp_util.get_namespace_closer('LootSimulator'))
 
@@ -172,6 +521,9 @@ def main():
     code_string = build_code_string()
     write_code_to_header(code_string)
 
+    if BAKED_ARGUMENT in sys.argv[1:]:
+        write_code_to_header(build_baked_code_string(),
+                             BAKED_CONTENT_FILE_PATH)
 
 if __name__ == '__main__':
     main()